@@ -0,0 +1,25 @@
+###
+ # THIS FILE IS AUTOMATICALLY GENERATED
+ # Do not edit this file. It will be overwritten when the configure script is run.
+###
+
+######
+# Build ID: 278446c09079c33a
+# Executable: ./bin/champsim
+# Module Names: ('btbDbasic_btb', 'branchDbimodal', 'branchDbullseye', 'branchDgshare', 'branchDhashed_perceptron', 'branchDmpp', 'branchDperceptron', 'branchDspec_tagescl', 'prefetcherDbarca', 'prefetcherDberti', 'prefetcherDentangling', 'prefetcherDgaze', 'prefetcherDip_stride', 'prefetcherDnext_line', 'prefetcherDno', 'prefetcherDspp_dev', 'prefetcherDva_ampm_lite', 'replacementDPACIPV', 'replacementDdrrip', 'replacementDlru', 'replacementDmockingjay', 'replacementDrandom', 'replacementDship', 'replacementDsrrip')
+######
+
+BIN_ROOT := bin
+compile_commands $(BIN_ROOT)/champsim: build_id := \
+  278446c09079c33a
+nonbase_module_objs += $(filter-out $(base_module_objs),$(call get_module_list, btb/basic_btb \
+  branch/bimodal branch/bullseye branch/gshare \
+  branch/hashed_perceptron branch/mpp branch/perceptron \
+  branch/spec_tagescl prefetcher/barca prefetcher/berti \
+  prefetcher/entangling prefetcher/gaze prefetcher/ip_stride \
+  prefetcher/next_line prefetcher/no prefetcher/spp_dev \
+  prefetcher/va_ampm_lite replacement/PACIPV replacement/drrip \
+  replacement/lru replacement/mockingjay replacement/random \
+  replacement/ship replacement/srrip ))
+build_ids += 278446c09079c33a
+executable_name += $(BIN_ROOT)/champsim
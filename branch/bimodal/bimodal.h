@@ -23,6 +23,12 @@ public:
   // void initialize_branch_predictor();
   bool predict_branch(champsim::address ip);
   void last_branch_result(champsim::address ip, champsim::address branch_target, bool taken, uint8_t branch_type);
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(bimodal_table);
+  }
 };
 
 #endif
@@ -20,6 +20,12 @@ struct gshare : champsim::modules::branch_predictor {
   static std::size_t gs_table_hash(champsim::address ip, std::bitset<GLOBAL_HISTORY_LENGTH> bh_vector);
   bool predict_branch(champsim::address ip);
   void last_branch_result(champsim::address ip, champsim::address branch_target, bool taken, uint8_t branch_type);
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(branch_history_vector, gs_history_table);
+  }
 };
 
 #endif
@@ -39,6 +39,12 @@ public:
    *  Insert this value into the shift register
    **/
   void push_back(bool ins);
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(last_value_mask, words);
+  }
 };
 
 template <champsim::data::bits WORD_LEN>
@@ -51,6 +51,12 @@ public:
   bool predict_branch(champsim::address pc);
   void last_branch_result(champsim::address pc, champsim::address branch_target, bool taken, uint8_t branch_type);
   void adjust_threshold(bool correct);
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(tables, ghist_words, theta, tc, last_result);
+  }
 };
 
 #endif
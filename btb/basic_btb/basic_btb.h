@@ -20,6 +20,12 @@ public:
   // void initialize_btb();
   std::pair<champsim::address, bool> btb_prediction(champsim::address ip);
   void update_btb(champsim::address ip, champsim::address branch_target, bool taken, uint8_t branch_type);
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(ras, indirect, direct);
+  }
 };
 
 #endif
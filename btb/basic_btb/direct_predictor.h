@@ -39,6 +39,12 @@ struct direct_predictor {
   champsim::msl::lru_table<btb_entry_t> BTB{sets, ways};
   std::optional<btb_entry_t> check_hit(champsim::address ip);
   void update(champsim::address ip, champsim::address branch_target, uint8_t branch_type);
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(BTB);
+  }
 };
 
 #endif
@@ -26,6 +26,12 @@ struct return_stack {
   std::pair<champsim::address, bool> prediction();
   void push(champsim::address ip);
   void calibrate_call_size(champsim::address branch_target);
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(stack, call_size_trackers);
+  }
 };
 
 #endif
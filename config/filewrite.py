@@ -23,6 +23,8 @@ import pathlib
 from .makefile import get_makefile_lines
 from .instantiation_file import get_instantiation_lines
 from .instantiation_file import get_instantiation_header
+from .instantiation_file import get_module_registry_header
+from .instantiation_file import get_module_registry_lines
 from . import util
 
 warning_text = (
@@ -148,6 +150,8 @@ class Fragment:
         executable_basename, elements, modules_to_compile, module_info, config_file = parsed_config
 
         joined_module_info = util.subdict(util.chain(*module_info.values()), modules_to_compile) # remove module type tag
+        pref_module_info = util.subdict(module_info['pref'], modules_to_compile)
+        repl_module_info = util.subdict(module_info['repl'], modules_to_compile)
         executable = os.path.join(bindir_name, executable_basename)
         if verbose:
             print('For Executable', executable)
@@ -167,6 +171,10 @@ class Fragment:
             (os.path.join(objdir_name, 'core_inst.inc'), cxx_file(get_instantiation_header(len(elements['cores']), config_file, build_id=build_id))),
             (os.path.join(objdir_name, 'core_inst.cc.inc'), cxx_file(get_instantiation_lines(build_id=build_id, **elements))),
 
+            # Runtime module selection
+            (os.path.join(objdir_name, 'module_registry.inc'), cxx_file(get_module_registry_header(pref_module_info, repl_module_info))),
+            (os.path.join(objdir_name, 'module_registry.cc.inc'), cxx_file(get_module_registry_lines(pref_module_info, repl_module_info))),
+
             # Makefile generation
             (os.path.join(makedir_name, '_configuration.mk'), (
                 *make_generated_warning(),
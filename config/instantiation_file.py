@@ -445,3 +445,20 @@ def get_instantiation_header(num_cpus, env, build_id):
     )
     struct_name = f'champsim::configured::generated_environment<0x{build_id}> final'
     yield from cxx.struct(struct_name, struct_body, superclass='champsim::environment')
+
+def get_module_registry_header(pref_modules, repl_modules):
+    '''
+    Generate the include lines needed to register the given prefetchers and replacement policies by name.
+    '''
+    datas = itertools.filterfalse(operator.methodcaller('get', 'legacy', False), itertools.chain(pref_modules.values(), repl_modules.values()))
+    yield from module_include_files(datas)
+
+def get_module_registry_lines(pref_modules, repl_modules):
+    '''
+    Generate the statements that register the given prefetchers and replacement policies with a champsim::modules::registry named ``reg``.
+    Each module is registered under the name of its directory, which is the name used to select it in a configuration file.
+    '''
+    for module in sorted(pref_modules.values(), key=operator.itemgetter('name')):
+        yield f'reg.add_prefetcher<class {module["class"]}>("{os.path.basename(os.path.normpath(module["path"]))}");'
+    for module in sorted(repl_modules.values(), key=operator.itemgetter('name')):
+        yield f'reg.add_replacement<class {module["class"]}>("{os.path.basename(os.path.normpath(module["path"]))}");'
@@ -0,0 +1,246 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BACKGROUND_READER_H
+#define BACKGROUND_READER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "instruction.h"
+
+namespace champsim
+{
+/**
+ * Runs a trace reader on a dedicated thread, which decompresses and inflates instructions ahead of the simulation.
+ *
+ * The instructions are passed to the simulation in batches, through a single-producer, single-consumer ring of a fixed number of batches.
+ * The wrapped reader is called in the same order, with the same eof() checks, as it would be without this wrapper, so the instructions and
+ * their branch targets are unchanged. Instruction IDs are assigned by the champsim::tracereader that holds this reader, on the simulation thread.
+ *
+ * The thread is started on first use, and belongs to the process that started it. If the process forks, the child must replace this reader,
+ * as champsim::tracereader::reopen() does, rather than use it.
+ */
+template <typename R>
+class background_reader
+{
+  struct state_type {
+    R reader;
+    std::vector<std::vector<ooo_model_instr>> ring;
+    std::size_t batch_size;
+
+    std::atomic<uint64_t> head{0}; // the next batch to be consumed, written only by the consumer
+    std::atomic<uint64_t> tail{0}; // the next batch to be produced, written only by the producer
+    std::atomic<bool> stop{false};
+    std::atomic<bool> finished{false};
+    std::exception_ptr error{};
+
+    std::unique_ptr<std::thread> producer{};
+    pid_t owner = 0;
+    std::size_t consumed = 0; // the number of instructions taken from the batch at head
+
+    state_type(R&& reader_, std::size_t depth, std::size_t batch_size_) : reader(std::move(reader_)), ring(depth), batch_size(batch_size_) {}
+
+    void produce();
+    void start();
+    void halt();
+    bool wait_for_batch();
+    void pop_batch();
+  };
+
+  std::unique_ptr<state_type> state;
+
+public:
+  constexpr static std::size_t default_batch_size = 1024;
+
+  /**
+   * :param reader: The reader to run in the background
+   * :param depth: The number of batches that may be read ahead of the simulation
+   * :param batch_size: The number of instructions in each batch
+   */
+  background_reader(R&& reader, std::size_t depth, std::size_t batch_size = default_batch_size)
+      : state(std::make_unique<state_type>(std::move(reader), depth, batch_size))
+  {
+    if (depth == 0 || batch_size == 0) {
+      throw std::invalid_argument{"A background reader needs room for at least one instruction"};
+    }
+  }
+
+  background_reader(background_reader&&) noexcept = default;
+  background_reader& operator=(background_reader&&) = delete;
+  background_reader(const background_reader&) = delete;
+  background_reader& operator=(const background_reader&) = delete;
+
+  ~background_reader()
+  {
+    if (state) {
+      state->halt();
+    }
+  }
+
+  ooo_model_instr operator()();
+
+  /**
+   * Skip the next count instructions. Instructions that have already been read ahead are dropped, and the rest are skipped by the wrapped
+   * reader, while the thread is stopped.
+   */
+  uint64_t skip(uint64_t count);
+
+  [[nodiscard]] bool eof() const { return !state->wait_for_batch(); }
+};
+
+template <typename R>
+void background_reader<R>::state_type::produce()
+{
+  try {
+    while (!stop.load(std::memory_order_acquire)) {
+      const auto next = tail.load(std::memory_order_relaxed);
+
+      // The ring is full, so the simulation is far behind
+      if (next - head.load(std::memory_order_acquire) == std::size(ring)) {
+        std::this_thread::sleep_for(std::chrono::microseconds{50});
+        continue;
+      }
+
+      auto& batch = ring[next % std::size(ring)];
+      batch.clear();
+      while (std::size(batch) < batch_size && !reader.eof()) {
+        batch.push_back(reader());
+      }
+
+      if (!std::empty(batch)) {
+        tail.store(next + 1, std::memory_order_release);
+      }
+      if (reader.eof()) {
+        finished.store(true, std::memory_order_release);
+        return;
+      }
+    }
+  } catch (...) {
+    error = std::current_exception();
+    finished.store(true, std::memory_order_release);
+  }
+}
+
+template <typename R>
+void background_reader<R>::state_type::start()
+{
+  if (!producer && !finished.load(std::memory_order_acquire)) {
+    stop.store(false, std::memory_order_relaxed);
+    owner = ::getpid();
+    producer = std::make_unique<std::thread>([this] { this->produce(); });
+  }
+}
+
+template <typename R>
+void background_reader<R>::state_type::halt()
+{
+  if (producer) {
+    if (owner == ::getpid()) {
+      stop.store(true, std::memory_order_release);
+      producer->join();
+      producer.reset();
+    } else {
+      // The thread was not copied into this forked process, so there is nothing to join
+      static_cast<void>(producer.release());
+    }
+  }
+}
+
+template <typename R>
+bool background_reader<R>::state_type::wait_for_batch()
+{
+  start();
+  while (head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire)) {
+    if (finished.load(std::memory_order_acquire)) {
+      // The producer may have published a last batch before finishing
+      if (head.load(std::memory_order_relaxed) != tail.load(std::memory_order_acquire)) {
+        break;
+      }
+      if (error) {
+        std::rethrow_exception(error);
+      }
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+template <typename R>
+void background_reader<R>::state_type::pop_batch()
+{
+  consumed = 0;
+  head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template <typename R>
+ooo_model_instr background_reader<R>::operator()()
+{
+  if (!state->wait_for_batch()) {
+    throw std::runtime_error{"Read past the end of a trace"};
+  }
+
+  auto& batch = state->ring[state->head.load(std::memory_order_relaxed) % std::size(state->ring)];
+  auto retval = batch[state->consumed++];
+  if (state->consumed == std::size(batch)) {
+    state->pop_batch();
+  }
+  return retval;
+}
+
+template <typename R>
+uint64_t background_reader<R>::skip(uint64_t count)
+{
+  uint64_t skipped = 0;
+  auto drop_published = [this, &skipped, count] {
+    while (skipped < count && state->head.load(std::memory_order_relaxed) != state->tail.load(std::memory_order_acquire)) {
+      const auto& batch = state->ring[state->head.load(std::memory_order_relaxed) % std::size(state->ring)];
+      const auto step = std::min<uint64_t>(count - skipped, std::size(batch) - state->consumed);
+      skipped += step;
+      state->consumed += step;
+      if (state->consumed == std::size(batch)) {
+        state->pop_batch();
+      }
+    }
+  };
+
+  drop_published();
+  if (skipped == count) {
+    return skipped;
+  }
+
+  // Batches are only published whole, so once the thread is stopped, everything it has read is in the ring
+  state->halt();
+  drop_published();
+  if (skipped < count && !state->finished.load(std::memory_order_acquire)) {
+    skipped += state->reader.skip(count - skipped);
+  }
+
+  return skipped;
+}
+} // namespace champsim
+
+#endif
@@ -37,13 +37,16 @@
 #include "address.h"
 #include "bandwidth.h"
 #include "block.h"
+#include "cache_tag_store.h"
 #include "cache_builder.h"
 #include "cache_stats.h"
 #include "champsim.h"
 #include "channel.h"
 #include "chrono.h"
 #include "modules.h"
+#include "mshr_file.h"
 #include "operable.h"
+#include "serialization.h"
 #include "util/to_underlying.h" // for to_underlying
 #include "waitable.h"
 
@@ -78,8 +81,8 @@ class CACHE : public champsim::operable
 
     champsim::chrono::clock::time_point event_cycle = champsim::chrono::clock::time_point::max();
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::channel::dependents_type instr_depend_on_me{};
+    champsim::channel::return_list_type to_return{};
 
     explicit tag_lookup_type(request_type req) : tag_lookup_type(req, false, false) {}
     tag_lookup_type(const request_type& req, bool local_pref, bool skip);
@@ -106,8 +109,8 @@ public:
 
     champsim::chrono::clock::time_point time_enqueued;
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::channel::dependents_type instr_depend_on_me{};
+    champsim::channel::return_list_type to_return{};
 
     mshr_type(const tag_lookup_type& req, champsim::chrono::clock::time_point _time_enqueued);
     static mshr_type merge(mshr_type predecessor, mshr_type successor);
@@ -124,6 +127,11 @@ private:
   void issue_translation(tag_lookup_type& q_entry) const;
   void dump_all_addrs() const;
 
+  void clear_inflight_for_checkpoint();
+  void replay_checkpoint_fill(long set, long way, const champsim::cache_block& blk);
+
+  void access_replacement_shadows(const tag_lookup_type& handle_pkt);
+
 public:
   using BLOCK = champsim::cache_block;
 
@@ -163,7 +171,22 @@ public:
   champsim::chrono::clock::duration HIT_LATENCY;
   champsim::chrono::clock::duration FILL_LATENCY;
   champsim::data::bits OFFSET_BITS;
+
+  /**
+   * The blocks of the cache, in set-major order. Their tags and valid bits are also held in a packed tag store, which is what lookups search.
+   * Code outside of CACHE that changes the address or valid bit of a block must call rebuild_tag_store() before the cache operates again.
+   */
   set_type block{static_cast<typename set_type::size_type>(NUM_SET * NUM_WAY)};
+
+private:
+  champsim::cache_tag_store tag_store{NUM_SET, NUM_WAY};
+
+  [[nodiscard]] uint64_t block_tag(champsim::address address) const;
+
+  std::vector<long> replacement_shadow_slot{}; // for each set, its place among the sampled sets, or -1 if it is not sampled
+  std::size_t replacement_shadow_sets = 64;
+
+public:
   champsim::bandwidth::maximum_type MAX_TAG, MAX_FILL;
   bool prefetch_as_load;
   bool match_offset_bits;
@@ -174,7 +197,7 @@ public:
 
   stats_type sim_stats, roi_stats;
 
-  std::deque<mshr_type> MSHR;
+  champsim::mshr_file<mshr_type> MSHR;
   std::deque<mshr_type> inflight_writes;
 
   long operate() final;
@@ -182,6 +205,16 @@ public:
   void begin_phase() final;
   void end_phase(unsigned cpu) final;
 
+  /**
+   * The earliest fill or tag check that will become ready. The next cycle if any queue holds new requests, a request is waiting to be retried,
+   * or a prefetcher has work to do in prefetcher_cycle_operate().
+   */
+  [[nodiscard]] champsim::chrono::clock::time_point next_event_time() const final;
+  void idle_cycles(long cycles) final;
+
+  [[nodiscard]] std::vector<const champsim::channel*> upper_channels() const final;
+  [[nodiscard]] std::vector<const champsim::channel*> lower_channels() const final;
+
   [[deprecated]] std::size_t get_occupancy(uint8_t queue_type, champsim::address address) const;
   [[deprecated]] std::size_t get_size(uint8_t queue_type, champsim::address address) const;
 
@@ -225,11 +258,44 @@ public:
     BLOCK block{};
   };
 
+  /**
+   * Bring the tag store in line with the blocks, after they were changed directly.
+   */
+  void rebuild_tag_store();
+
   [[nodiscard]] std::vector<checkpoint_entry> checkpoint_contents() const;
   void restore_checkpoint(const std::vector<checkpoint_entry>& entries);
 
+  /**
+   * Replace the whole tag store with the given blocks, which must be in set-major order and hold exactly NUM_SET * NUM_WAY entries.
+   */
+  void restore_checkpoint(std::vector<BLOCK>&& contents);
+
+  /**
+   * The state of every prefetcher and replacement policy that provides a ``serialize()`` member function, for a cache checkpoint.
+   * The state of each kind of module is tagged with the types of the modules.
+   */
+  [[nodiscard]] std::string checkpoint_module_state() const;
+
+  /**
+   * Restore module state written by checkpoint_module_state(). The state of each kind of module is restored only if the modules are of
+   * the same types as those that wrote it, and is otherwise ignored.
+   */
+  void restore_checkpoint_module_state(const std::string& state);
+
   void print_deadlock() final;
 
+  /**
+   * Write the tag store and the state of every prefetcher and replacement policy that provides a ``serialize()`` member function.
+   * Requests in flight are not saved.
+   */
+  void save_state(champsim::serialization::output_archive& ar) final;
+
+  /**
+   * Restore state written by save_state(). Requests in flight are discarded, and the blocks are placed without replaying their fills.
+   */
+  void load_state(champsim::serialization::input_archive& ar) final;
+
 #include "module_decl.inc"
 
   struct prefetcher_module_concept {
@@ -243,9 +309,13 @@ public:
     virtual uint32_t impl_prefetcher_cache_fill(champsim::address addr, long set, long way, bool prefetch, champsim::address evicted_addr,
                                                 uint32_t metadata_in) = 0;
     virtual void impl_prefetcher_cycle_operate() = 0;
+    virtual bool impl_prefetcher_cycle_idle() = 0;
     virtual void impl_prefetcher_final_stats() = 0;
     virtual void impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target) = 0;
     virtual void impl_prefetcher_squash(champsim::address ip, uint64_t instr_id) = 0;
+
+    virtual void impl_save_state(champsim::serialization::output_archive& ar) = 0;
+    virtual void impl_load_state(champsim::serialization::input_archive& ar) = 0;
   };
 
   struct replacement_module_concept {
@@ -261,6 +331,9 @@ public:
     virtual void impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                              champsim::address victim_addr, access_type type) = 0;
     virtual void impl_replacement_final_stats() = 0;
+
+    virtual void impl_save_state(champsim::serialization::output_archive& ar) = 0;
+    virtual void impl_load_state(champsim::serialization::input_archive& ar) = 0;
   };
 
   template <typename... Ps>
@@ -278,9 +351,13 @@ public:
     [[nodiscard]] uint32_t impl_prefetcher_cache_fill(champsim::address addr, long set, long way, bool prefetch, champsim::address evicted_addr,
                                                       uint32_t metadata_in) final;
     void impl_prefetcher_cycle_operate() final;
+    [[nodiscard]] bool impl_prefetcher_cycle_idle() final;
     void impl_prefetcher_final_stats() final;
     void impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target) final;
     void impl_prefetcher_squash(champsim::address ip, uint64_t instr_id) final;
+
+    void impl_save_state(champsim::serialization::output_archive& ar) final;
+    void impl_load_state(champsim::serialization::input_archive& ar) final;
   };
 
   template <typename... Rs>
@@ -303,11 +380,40 @@ public:
     void impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                      champsim::address victim_addr, access_type type) final;
     void impl_replacement_final_stats() final;
+
+    void impl_save_state(champsim::serialization::output_archive& ar) final;
+    void impl_load_state(champsim::serialization::input_archive& ar) final;
   };
 
   std::unique_ptr<prefetcher_module_concept> pref_module_pimpl;
   std::unique_ptr<replacement_module_concept> repl_module_pimpl;
 
+  /**
+   * A replacement policy that is evaluated alongside the cache's own, on shadow tags for a sample of the sets.
+   */
+  struct replacement_shadow {
+    std::string name;
+    std::unique_ptr<replacement_module_concept> module;
+    std::vector<BLOCK> block; // the ways of each sampled set, one set after another
+  };
+  std::vector<replacement_shadow> replacement_shadows;
+
+  /**
+   * Evaluate another replacement policy alongside the cache's own. The policy keeps shadow tags for a sample of the sets and sees every access
+   * that the cache counts as a hit or a miss in those sets, but does not affect the cache. Its hits and misses are reported with the cache's
+   * statistics. This must be done before the cache is initialized.
+   *
+   * :param name: The name under which the policy is reported.
+   * :param module: The policy, bound to this cache.
+   */
+  void add_replacement_shadow(std::string name, std::unique_ptr<replacement_module_concept>&& module);
+
+  /**
+   * Sample the given number of sets, evenly spaced, for the replacement shadows. By default, 64 sets are sampled, or every set of a smaller cache.
+   * This must be done before the cache is initialized.
+   */
+  void set_replacement_shadow_sets(std::size_t count);
+
   // NOLINTBEGIN(readability-make-member-function-const): legacy modules use non-const hooks
   void impl_prefetcher_initialize() const;
   [[nodiscard]] uint32_t impl_prefetcher_cache_operate(champsim::address addr, champsim::address ip, bool cache_hit, bool useful_prefetch, access_type type,
@@ -317,6 +423,7 @@ public:
   [[nodiscard]] uint32_t impl_prefetcher_cache_fill(champsim::address addr, long set, long way, bool prefetch, champsim::address evicted_addr,
                                                     uint32_t metadata_in) const;
   void impl_prefetcher_cycle_operate() const;
+  [[nodiscard]] bool impl_prefetcher_cycle_idle() const;
   void impl_prefetcher_final_stats() const;
   void impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target) const;
   void impl_prefetcher_squash(champsim::address ip, uint64_t instr_id) const;
@@ -432,6 +539,20 @@ void CACHE::prefetcher_module_model<Ps...>::impl_prefetcher_cycle_operate()
   std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
 }
 
+template <typename... Ps>
+bool CACHE::prefetcher_module_model<Ps...>::impl_prefetcher_cycle_idle()
+{
+  [[maybe_unused]] auto process_one = [&](auto& p) {
+    using namespace champsim::modules;
+    if constexpr (prefetcher::has_cycle_idle<decltype(p)>)
+      return bool{p.prefetcher_cycle_idle()};
+    // A prefetcher that works every cycle, but cannot say when it has nothing to do, is never idle
+    return !prefetcher::has_cycle_operate<decltype(p)>;
+  };
+
+  return std::apply([&](auto&... p) { return (true && ... && process_one(p)); }, intern_);
+}
+
 template <typename... Ps>
 void CACHE::prefetcher_module_model<Ps...>::impl_prefetcher_final_stats()
 {
@@ -600,6 +721,50 @@ void CACHE::replacement_module_model<Rs...>::impl_replacement_final_stats()
   std::apply([&](auto&... r) { (..., process_one(r)); }, intern_);
 }
 
+template <typename... Ps>
+void CACHE::prefetcher_module_model<Ps...>::impl_save_state(champsim::serialization::output_archive& ar)
+{
+  [[maybe_unused]] auto process_one = [&](auto& p) {
+    if constexpr (champsim::serialization::has_serialize_v<decltype(p), champsim::serialization::output_archive>)
+      ar(p);
+  };
+
+  std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
+}
+
+template <typename... Ps>
+void CACHE::prefetcher_module_model<Ps...>::impl_load_state(champsim::serialization::input_archive& ar)
+{
+  [[maybe_unused]] auto process_one = [&](auto& p) {
+    if constexpr (champsim::serialization::has_serialize_v<decltype(p), champsim::serialization::input_archive>)
+      ar(p);
+  };
+
+  std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
+}
+
+template <typename... Rs>
+void CACHE::replacement_module_model<Rs...>::impl_save_state(champsim::serialization::output_archive& ar)
+{
+  [[maybe_unused]] auto process_one = [&](auto& r) {
+    if constexpr (champsim::serialization::has_serialize_v<decltype(r), champsim::serialization::output_archive>)
+      ar(r);
+  };
+
+  std::apply([&](auto&... r) { (..., process_one(r)); }, intern_);
+}
+
+template <typename... Rs>
+void CACHE::replacement_module_model<Rs...>::impl_load_state(champsim::serialization::input_archive& ar)
+{
+  [[maybe_unused]] auto process_one = [&](auto& r) {
+    if constexpr (champsim::serialization::has_serialize_v<decltype(r), champsim::serialization::input_archive>)
+      ar(r);
+  };
+
+  std::apply([&](auto&... r) { (..., process_one(r)); }, intern_);
+}
+
 #ifdef SET_ASIDE_CHAMPSIM_MODULE
 #undef SET_ASIDE_CHAMPSIM_MODULE
 #define CHAMPSIM_MODULE
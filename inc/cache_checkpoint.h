@@ -1,14 +1,77 @@
 #ifndef CACHE_CHECKPOINT_H
 #define CACHE_CHECKPOINT_H
 
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <vector>
+
+class CACHE;
 
 namespace champsim
 {
 class environment;
 
-void save_cache_checkpoint(environment& env, const std::filesystem::path& file_path);
+/**
+ * The on-disk encoding of a cache checkpoint.
+ *
+ * The binary format is the default. It is a versioned header, followed by one section table entry per cache, followed by the packed block
+ * records of every set and way, in set-major order. It is read back through mmap and restored without any parsing. The section of each cache
+ * also locates the state of its prefetchers and replacement policy, as written by CACHE::checkpoint_module_state(), which follows the blocks.
+ *
+ * The text format writes one line per valid block and only preserves the block address. It is kept for export and debugging.
+ */
+enum class checkpoint_format { binary, text };
+
+namespace checkpoint
+{
+inline constexpr char magic[8] = {'C', 'S', 'C', 'K', 'P', 'T', '\0', '\0'};
+inline constexpr uint32_t version = 2;
+inline constexpr std::size_t max_name_length = 64;
+
+struct file_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t section_count;
+};
+
+struct section_header {
+  char name[max_name_length];
+  uint64_t num_set;
+  uint64_t num_way;
+  uint64_t record_offset; // in bytes, from the beginning of the file
+  uint64_t record_count;
+  uint64_t module_state_offset; // in bytes, from the beginning of the file
+  uint64_t module_state_size;
+};
+
+struct block_record {
+  uint64_t address;
+  uint64_t v_address;
+  uint64_t data;
+  uint32_t pf_metadata;
+  uint8_t valid;
+  uint8_t prefetch;
+  uint8_t dirty;
+  uint8_t reserved;
+};
+
+static_assert(sizeof(file_header) == 16);
+static_assert(sizeof(section_header) == 112);
+static_assert(sizeof(block_record) == 32);
+} // namespace checkpoint
+
+void save_cache_checkpoint(environment& env, const std::filesystem::path& file_path, checkpoint_format format = checkpoint_format::binary);
+void save_cache_checkpoint(const std::vector<std::reference_wrapper<CACHE>>& caches, const std::filesystem::path& file_path,
+                           checkpoint_format format = checkpoint_format::binary);
+
+/**
+ * Restore the contents of every cache from a checkpoint. The format is detected from the file contents.
+ * Caches that do not appear in the checkpoint are emptied. The state of the modules is restored from a binary checkpoint where the modules
+ * match those that wrote it.
+ */
 void load_cache_checkpoint(environment& env, const std::filesystem::path& file_path);
+void load_cache_checkpoint(const std::vector<std::reference_wrapper<CACHE>>& caches, const std::filesystem::path& file_path);
 
 } // namespace champsim
 
@@ -1,10 +1,12 @@
 #ifndef CACHE_STATS_H
 #define CACHE_STATS_H
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "channel.h"
 #include "event_counter.h"
@@ -24,6 +26,16 @@ struct cache_stats {
   champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> mshr_return = {};
 
   long total_miss_latency_cycles{};
+
+  // replacement policies evaluated on the shadow tags of a sample of the sets
+  struct replacement_shadow_stats {
+    std::string name;
+    champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> hits = {};
+    champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> misses = {};
+  };
+  std::vector<replacement_shadow_stats> replacement_shadows = {};
+  std::size_t replacement_shadow_sets = 0;
+  std::size_t total_sets = 0;
 };
 
 cache_stats operator-(cache_stats lhs, cache_stats rhs);
@@ -0,0 +1,153 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CACHE_TAG_STORE_H
+#define CACHE_TAG_STORE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace champsim
+{
+/**
+ * The tags of a set-associative array, held apart from its blocks so that a set can be searched without touching the blocks.
+ *
+ * Each way holds a block number (the address without its offset bits) in a packed array, and each set holds a bitmask of its valid ways.
+ * A search compares a whole set against the tag at once, and picks the first matching way from the resulting bitmask. The comparison uses
+ * AVX2 or SSE4.1 when the build enables them, and otherwise a loop that the compiler is free to vectorize.
+ *
+ * Sets of more than 64 ways are searched 64 ways at a time.
+ */
+class cache_tag_store
+{
+public:
+  using mask_type = uint64_t;
+  constexpr static std::size_t ways_per_mask = 64;
+
+private:
+  std::size_t num_way;
+  std::size_t masks_per_set;
+  std::vector<uint64_t> tags;
+  std::vector<mask_type> valid;
+
+  static mask_type match_mask(const uint64_t* first, std::size_t count, uint64_t tag);
+  static std::size_t first_way(mask_type mask) { return static_cast<std::size_t>(__builtin_ctzll(mask)); }
+
+  [[nodiscard]] mask_type chunk_valid(std::size_t set, std::size_t chunk) const { return valid[set * masks_per_set + chunk]; }
+
+  template <bool only_valid>
+  [[nodiscard]] std::size_t find(std::size_t set, uint64_t tag) const;
+
+public:
+  cache_tag_store(std::size_t sets, std::size_t ways)
+      : num_way(ways), masks_per_set((ways + ways_per_mask - 1) / ways_per_mask), tags(sets * ways), valid(sets * masks_per_set)
+  {
+  }
+
+  /**
+   * Record the tag and valid bit of a way.
+   */
+  void assign(std::size_t set, std::size_t way, uint64_t tag, bool is_valid)
+  {
+    tags[set * num_way + way] = tag;
+    set_valid(set, way, is_valid);
+  }
+
+  void set_valid(std::size_t set, std::size_t way, bool is_valid)
+  {
+    auto& mask = valid[set * masks_per_set + way / ways_per_mask];
+    const auto bit = mask_type{1} << (way % ways_per_mask);
+    mask = is_valid ? (mask | bit) : (mask & ~bit);
+  }
+
+  /**
+   * The first valid way of the set that holds the tag, or the number of ways if there is none.
+   */
+  [[nodiscard]] std::size_t find_valid(std::size_t set, uint64_t tag) const { return find<true>(set, tag); }
+
+  /**
+   * The first way of the set that holds the tag, whether or not it is valid, or the number of ways if there is none.
+   */
+  [[nodiscard]] std::size_t find_any(std::size_t set, uint64_t tag) const { return find<false>(set, tag); }
+
+  /**
+   * The first way of the set that is not valid, or the number of ways if every way is valid.
+   */
+  [[nodiscard]] std::size_t first_invalid(std::size_t set) const;
+};
+
+inline auto cache_tag_store::match_mask(const uint64_t* first, std::size_t count, uint64_t tag) -> mask_type
+{
+  mask_type mask = 0;
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  const auto needle = _mm256_set1_epi64x(static_cast<long long>(tag));
+  for (; i + 4 <= count; i += 4) {
+    const auto eq = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i)), needle);
+    mask |= static_cast<mask_type>(_mm256_movemask_pd(_mm256_castsi256_pd(eq))) << i;
+  }
+#elif defined(__SSE4_1__)
+  const auto needle = _mm_set1_epi64x(static_cast<long long>(tag));
+  for (; i + 2 <= count; i += 2) {
+    const auto eq = _mm_cmpeq_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i)), needle);
+    mask |= static_cast<mask_type>(_mm_movemask_pd(_mm_castsi128_pd(eq))) << i;
+  }
+#endif
+  for (; i < count; ++i) {
+    mask |= static_cast<mask_type>(first[i] == tag) << i;
+  }
+  return mask;
+}
+
+template <bool only_valid>
+std::size_t cache_tag_store::find(std::size_t set, uint64_t tag) const
+{
+  const auto* set_tags = std::data(tags) + set * num_way;
+  for (std::size_t chunk = 0; chunk < masks_per_set; ++chunk) {
+    const auto base = chunk * ways_per_mask;
+    auto hits = match_mask(set_tags + base, std::min(ways_per_mask, num_way - base), tag);
+    if constexpr (only_valid) {
+      hits &= chunk_valid(set, chunk);
+    }
+    if (hits != 0) {
+      return base + first_way(hits);
+    }
+  }
+  return num_way;
+}
+
+inline std::size_t cache_tag_store::first_invalid(std::size_t set) const
+{
+  for (std::size_t chunk = 0; chunk < masks_per_set; ++chunk) {
+    const auto base = chunk * ways_per_mask;
+    const auto ways_in_chunk = std::min(ways_per_mask, num_way - base);
+    const auto all_ways = (ways_in_chunk == ways_per_mask) ? ~mask_type{0} : ((mask_type{1} << ways_in_chunk) - 1);
+    const auto invalid = ~chunk_valid(set, chunk) & all_ways;
+    if (invalid != 0) {
+      return base + first_way(invalid);
+    }
+  }
+  return num_way;
+}
+} // namespace champsim
+
+#endif
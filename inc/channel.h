@@ -22,11 +22,14 @@
 #include <deque>
 #include <limits>
 #include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "access_type.h"
 #include "address.h"
 #include "champsim.h"
+#include "util/small_vector.h"
 
 namespace champsim
 {
@@ -49,6 +52,14 @@ struct cache_queue_stats {
 
 class channel
 {
+public:
+  /**
+   * The instructions that wait on a packet. Most packets are for one instruction, and a fetch is for the few in one block,
+   * so these are held inline and only allocate when many packets are merged.
+   */
+  using dependents_type = champsim::small_vector<uint64_t, 8>;
+
+private:
   struct request {
     bool forward_checked = false;
     bool is_translated = true;
@@ -67,7 +78,7 @@ class channel
     uint64_t instr_id = 0;
     champsim::address ip{};
 
-    std::vector<uint64_t> instr_depend_on_me{};
+    dependents_type instr_depend_on_me{};
   };
 
   struct response {
@@ -75,15 +86,36 @@ class channel
     champsim::address v_address{};
     champsim::address data{};
     uint32_t pf_metadata = 0;
-    std::vector<uint64_t> instr_depend_on_me{};
+    dependents_type instr_depend_on_me{};
 
-    response(champsim::address addr, champsim::address v_addr, champsim::address data_, uint32_t pf_meta, std::vector<uint64_t> deps)
-        : address(addr), v_address(v_addr), data(data_), pf_metadata(pf_meta), instr_depend_on_me(deps)
+    response(champsim::address addr, champsim::address v_addr, champsim::address data_, uint32_t pf_meta, dependents_type deps)
+        : address(addr), v_address(v_addr), data(data_), pf_metadata(pf_meta), instr_depend_on_me(std::move(deps))
     {
     }
     explicit response(request req) : response(req.address, req.v_address, req.data, req.pf_metadata, req.instr_depend_on_me) {}
   };
 
+  /**
+   * Locates the oldest packet in a queue that has been checked for collisions, by its block address.
+   *
+   * The checked packets form a prefix of the queue, and they leave the queue only from the front.
+   * Each is numbered in the order in which it was checked, so its position is its number less the number of the packet at the front.
+   */
+  class collision_index
+  {
+    std::unordered_map<uint64_t, std::vector<uint64_t>> positions{};
+    uint64_t num_indexed = 0;
+    uint64_t front = 0;
+
+  public:
+    void sync(const std::deque<request>& queue, std::size_t num_checked, champsim::data::bits shamt);
+    std::deque<request>::iterator find(std::deque<request>& queue, champsim::address addr, champsim::data::bits shamt);
+    void insert(champsim::address addr, champsim::data::bits shamt);
+  };
+
+  template <typename F>
+  void check_unchecked(std::deque<request>& queue, collision_index& index, champsim::data::bits shamt, F&& collides);
+
   template <typename R>
   bool do_add_queue(R& queue, std::size_t queue_size, const typename R::value_type& packet);
 
@@ -93,9 +125,16 @@ class channel
   champsim::data::bits OFFSET_BITS{};
   bool match_offset_bits = false;
 
+  collision_index rq_index{}, pq_index{}, wq_index{};
+
 public:
   using response_type = response;
   using request_type = request;
+
+  /**
+   * The queues that a packet returns to. A packet returns to one queue, unless it was merged with a packet from another.
+   */
+  using return_list_type = champsim::small_vector<std::deque<response_type>*, 4>;
   using stats_type = cache_queue_stats;
 
   std::deque<request_type> RQ{}, PQ{}, WQ{};
@@ -119,6 +158,11 @@ public:
   [[nodiscard]] std::size_t pq_size() const;
 
   void check_collision();
+
+  /**
+   * Discard every packet in the queues, and every response that has not been taken.
+   */
+  void clear();
 };
 } // namespace champsim
 
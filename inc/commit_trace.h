@@ -0,0 +1,112 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMIT_TRACE_H
+#define COMMIT_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace champsim
+{
+enum class commit_trace_format { csv, bin, npy };
+enum class commit_trace_compression { none, xz };
+
+/**
+ * One committed instruction, as written to a commit trace. The members are in the order of the columns of the trace.
+ */
+struct commit_record {
+  uint64_t pc = 0;
+  uint64_t memory_address = 0;
+  uint64_t opcode = 0;
+  uint64_t source_register1 = 0;
+  uint64_t source_register2 = 0;
+  uint64_t destination_register1 = 0;
+  uint64_t commit_cycle = 0;
+  uint64_t delta_cycles = 0;
+};
+
+constexpr std::size_t commit_record_columns = 8;
+static_assert(sizeof(commit_record) == commit_record_columns * sizeof(uint64_t), "Commit records are written as rows of packed 64-bit columns");
+
+constexpr std::string_view commit_trace_header = "pc,memory_address,opcode,source_register1,source_register2,destination_register1,commit_cycle,delta_cycles";
+
+/**
+ * The file extension for a format and compression, for example ".npy" or ".bin.xz".
+ */
+std::string commit_trace_extension(commit_trace_format format, commit_trace_compression compression);
+
+/**
+ * Writes commit records to a file, formatting and compressing them on a dedicated thread.
+ *
+ * Records are collected into batches on the calling thread, and each full batch is handed to the writer thread, which encodes it and
+ * writes it out. If the writer thread falls more than a fixed number of batches behind, the caller waits for it.
+ *
+ * The formats are:
+ * - csv: a header line, then one line of decimal integers per record, as ooo_model_instr::dump_neuroscalar_csv() writes them.
+ * - bin: no header, then one row of eight 64-bit unsigned integers per record, in the byte order of the host.
+ * - npy: a NumPy .npy (version 1.0) array of shape (N, 8) and type 'u8' in the byte order of the host, whose rows are as in bin. The shape
+ *   is written when the trace is closed. This format cannot be compressed, so that the array can be mapped into memory directly.
+ *
+ * The trace, and the thread that writes it, belong to the process that opened it. In a forked child, close() abandons the trace without
+ * writing to it, and push() throws.
+ */
+class commit_trace_writer
+{
+  struct state_type;
+  std::unique_ptr<state_type> state;
+
+public:
+  constexpr static std::size_t default_batch_size = 1 << 14;
+  constexpr static std::size_t default_depth = 4;
+
+  /**
+   * :param filename: The file to write, which is truncated
+   * :param format: The encoding of the records
+   * :param compression: The compression applied to the encoded records
+   * :param batch_size: The number of records handed to the writer thread at once
+   * :param depth: The number of batches that may wait for the writer thread
+   */
+  commit_trace_writer(std::string filename, commit_trace_format format, commit_trace_compression compression = commit_trace_compression::none,
+                      std::size_t batch_size = default_batch_size, std::size_t depth = default_depth);
+
+  commit_trace_writer(commit_trace_writer&&) noexcept;
+  commit_trace_writer& operator=(commit_trace_writer&&) = delete;
+  commit_trace_writer(const commit_trace_writer&) = delete;
+  commit_trace_writer& operator=(const commit_trace_writer&) = delete;
+  ~commit_trace_writer();
+
+  /**
+   * :throws std::logic_error: If the trace is closed, or was opened by another process.
+   */
+  void push(const commit_record& record);
+
+  /**
+   * Write any records that are still held, finish the file, and stop the writer thread. Records may not be pushed afterward.
+   */
+  void close();
+
+  /**
+   * The number of records pushed so far.
+   */
+  [[nodiscard]] uint64_t size() const;
+};
+} // namespace champsim
+
+#endif
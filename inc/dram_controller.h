@@ -25,7 +25,11 @@
 #include <iterator> // for end
 #include <limits>
 #include <optional>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "address.h"
 #include "channel.h"
@@ -82,6 +86,11 @@ struct DRAM_ADDRESS_MAPPING {
 
   bool is_collision(champsim::address a, champsim::address b) const;
 
+  /**
+   * Two addresses collide exactly when their keys are equal.
+   */
+  uint64_t collision_key(champsim::address address) const;
+
   std::size_t rows() const;
   std::size_t columns() const;
   std::size_t ranks() const;
@@ -108,8 +117,8 @@ struct DRAM_CHANNEL final : public champsim::operable {
     champsim::address data{};
     champsim::chrono::clock::time_point ready_time = champsim::chrono::clock::time_point::max();
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::channel::dependents_type instr_depend_on_me{};
+    champsim::channel::return_list_type to_return{};
 
     explicit request_type(const typename champsim::channel::request_type& req);
   };
@@ -139,6 +148,31 @@ struct DRAM_CHANNEL final : public champsim::operable {
   request_array_type bank_request;
   request_array_type::iterator active_request;
 
+  /*
+   * Indices over a queue. A request is indexed once it has been checked for collisions.
+   */
+  struct queue_index {
+    // The slots of the checked requests to each block, in slot order
+    std::unordered_map<uint64_t, std::vector<std::size_t>> slots_by_block{};
+
+    // The requests that wait to be scheduled to each bank, earliest ready first, and then latest slot first
+    using candidate_type = std::pair<champsim::chrono::clock::time_point, std::size_t>;
+    struct candidate_order {
+      bool operator()(const candidate_type& lhs, const candidate_type& rhs) const
+      {
+        return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second > rhs.second);
+      }
+    };
+    std::vector<std::set<candidate_type, candidate_order>> candidates_by_bank{};
+
+    void clear();
+  };
+  queue_index wq_index, rq_index;
+
+  void index_request(queue_index& index, std::size_t slot, const request_type& req);
+  void unindex_request(queue_index& index, std::size_t slot, const request_type& req);
+  std::pair<queue_index&, std::size_t> locate(queue_type::const_iterator pkt);
+
   // track bankgroup accesses
   std::vector<champsim::chrono::clock::time_point> bankgroup_readytime{address_mapping.ranks() * address_mapping.bankgroups(),
                                                                        champsim::chrono::clock::time_point{}};
@@ -170,6 +204,7 @@ struct DRAM_CHANNEL final : public champsim::operable {
   void check_read_collision();
   long finish_dbus_request();
   long schedule_refresh();
+  [[nodiscard]] bool write_mode_swap_due() const;
   void swap_write_mode();
   long populate_dbus();
   DRAM_CHANNEL::queue_type::iterator schedule_packet();
@@ -181,6 +216,18 @@ struct DRAM_CHANNEL final : public champsim::operable {
   void end_phase(unsigned cpu) final;
   void print_deadlock() final;
 
+  /**
+   * The earliest of the next refresh, the next bank or data bus to become ready, and the next queued request to become ready.
+   * The next cycle if requests are waiting for the data bus, since every cycle of that wait is counted.
+   */
+  [[nodiscard]] champsim::chrono::clock::time_point next_event_time() const final;
+
+  /**
+   * Write the open row of each bank, and the refresh and bus direction state. Requests in flight are not saved.
+   */
+  void save_state(champsim::serialization::output_archive& ar) final;
+  void load_state(champsim::serialization::input_archive& ar) final;
+
   std::size_t bank_request_capacity() const;
   std::size_t bankgroup_request_capacity() const;
   [[nodiscard]] champsim::data::bytes density() const;
@@ -218,6 +265,14 @@ public:
   void end_phase(unsigned cpu) final;
   void print_deadlock() final;
 
+  [[nodiscard]] champsim::chrono::clock::time_point next_event_time() const final;
+  void idle_cycles(long cycles) final;
+
+  [[nodiscard]] std::vector<const champsim::channel*> upper_channels() const final;
+
+  void save_state(champsim::serialization::output_archive& ar) final;
+  void load_state(champsim::serialization::input_archive& ar) final;
+
   [[nodiscard]] champsim::data::bytes size() const;
   void set_verbose(bool enable) { verbose = enable; }
   [[nodiscard]] bool is_verbose() const { return verbose; }
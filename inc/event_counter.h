@@ -2,11 +2,17 @@
 #define EVENT_COUNTER_H
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <numeric>
+#include <optional>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "access_type.h"
+
 namespace champsim::stats
 {
 template <typename Key>
@@ -110,6 +116,163 @@ public:
     return lhs;
   }
 };
+
+/**
+ * An event counter for statistics that are kept per access type and per cpu, which are counted on every cache access.
+ *
+ * The counters for the cpus seen so far are held in one array, indexed by the cpu and the type, so that counting an event is one increment.
+ * Keys whose cpu is too large to hold this way, such as those of packets that carry no cpu, are kept sorted, as in the general counter.
+ */
+template <typename CPU>
+class event_counter<std::pair<access_type, CPU>>
+{
+public:
+  using key_type = std::pair<access_type, CPU>;
+  using value_type = long;
+
+private:
+  constexpr static std::size_t num_types = static_cast<std::size_t>(access_type::NUM_TYPES);
+  constexpr static std::size_t max_dense_cpus = 256;
+
+  // A counter that has not been allocated is empty
+  std::vector<std::optional<value_type>> dense{};
+  event_counter<std::pair<std::underlying_type_t<access_type>, CPU>> sparse{};
+
+  static bool is_dense(key_type key) { return static_cast<std::size_t>(key.first) < num_types && static_cast<std::size_t>(key.second) < max_dense_cpus; }
+  static std::size_t dense_index(key_type key) { return static_cast<std::size_t>(key.second) * num_types + static_cast<std::size_t>(key.first); }
+  static auto sparse_key(key_type key) { return std::pair{static_cast<std::underlying_type_t<access_type>>(key.first), key.second}; }
+
+  [[nodiscard]] const std::optional<value_type>* find_dense(key_type key) const
+  {
+    auto idx = dense_index(key);
+    return idx < std::size(dense) ? &dense[idx] : nullptr;
+  }
+
+  std::optional<value_type>& grow_dense(key_type key)
+  {
+    auto idx = dense_index(key);
+    if (idx >= std::size(dense)) {
+      dense.resize((static_cast<std::size_t>(key.second) + 1) * num_types);
+    }
+    return dense[idx];
+  }
+
+public:
+  void allocate(key_type key)
+  {
+    if (is_dense(key)) {
+      auto& slot = grow_dense(key);
+      if (!slot.has_value()) {
+        slot = value_type{};
+      }
+    } else {
+      sparse.allocate(sparse_key(key));
+    }
+  }
+
+  void deallocate(key_type key)
+  {
+    if (is_dense(key)) {
+      grow_dense(key).reset();
+    } else {
+      sparse.deallocate(sparse_key(key));
+    }
+  }
+
+  void increment(key_type key)
+  {
+    if (is_dense(key)) {
+      auto& slot = grow_dense(key);
+      slot = slot.value_or(value_type{}) + 1;
+    } else {
+      sparse.increment(sparse_key(key));
+    }
+  }
+
+  void set(key_type key, value_type val)
+  {
+    if (is_dense(key)) {
+      grow_dense(key) = val;
+    } else {
+      sparse.set(sparse_key(key), val);
+    }
+  }
+
+  auto at(key_type key) const
+  {
+    if (is_dense(key)) {
+      const auto* slot = find_dense(key);
+      if (slot == nullptr || !slot->has_value()) {
+        throw std::out_of_range{"The event counter has no count for this key"};
+      }
+      return slot->value();
+    }
+    return sparse.at(sparse_key(key));
+  }
+
+  auto value_or(key_type key, value_type val) const
+  {
+    if (is_dense(key)) {
+      const auto* slot = find_dense(key);
+      return slot == nullptr ? val : slot->value_or(val);
+    }
+    return sparse.value_or(sparse_key(key), val);
+  }
+
+  auto total() const
+  {
+    return std::accumulate(std::begin(dense), std::end(dense), sparse.total(), [](auto acc, const auto& slot) { return acc + slot.value_or(value_type{}); });
+  }
+
+  std::vector<key_type> get_keys() const
+  {
+    std::vector<key_type> retval{};
+    for (std::size_t idx = 0; idx < std::size(dense); ++idx) {
+      if (dense[idx].has_value()) {
+        retval.emplace_back(static_cast<access_type>(idx % num_types), static_cast<CPU>(idx / num_types));
+      }
+    }
+    for (auto [type, cpu] : sparse.get_keys()) {
+      retval.emplace_back(static_cast<access_type>(type), cpu);
+    }
+    std::sort(std::begin(retval), std::end(retval));
+    return retval;
+  }
+
+  event_counter<key_type>& operator+=(const event_counter<key_type>& rhs)
+  {
+    for (std::size_t idx = 0; idx < std::size(dense); ++idx) {
+      if (dense[idx].has_value()) {
+        *dense[idx] += (idx < std::size(rhs.dense)) ? rhs.dense[idx].value_or(value_type{}) : value_type{};
+      }
+    }
+    sparse += rhs.sparse;
+    return *this;
+  }
+
+  friend auto operator+(event_counter<key_type> lhs, const event_counter<key_type>& rhs)
+  {
+    lhs += rhs;
+    return lhs;
+  }
+
+  event_counter<key_type>& operator-=(const event_counter<key_type>& rhs)
+  {
+    for (std::size_t idx = 0; idx < std::size(dense); ++idx) {
+      if (dense[idx].has_value()) {
+        *dense[idx] -= (idx < std::size(rhs.dense)) ? rhs.dense[idx].value_or(value_type{}) : value_type{};
+      }
+    }
+    sparse -= rhs.sparse;
+    return *this;
+  }
+
+  friend auto operator-(event_counter<key_type> lhs, const event_counter<key_type>& rhs)
+  {
+    lhs -= rhs;
+    return lhs;
+  }
+};
 } // namespace champsim::stats
 
 #endif
@@ -17,9 +17,12 @@
 #ifndef INF_STREAM_H
 #define INF_STREAM_H
 
+#include <array>
 #include <bzlib.h>
 #include <cassert>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <lzma.h>
 #include <memory>
 #include <zlib.h>
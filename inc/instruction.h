@@ -20,16 +20,16 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
-#include <functional>
 #include <limits>
 #include <ostream>
 #include <string_view>
-#include <vector>
 
 #include "address.h"
 #include "champsim.h"
 #include "chrono.h"
+#include "commit_trace.h"
 #include "trace_instruction.h"
+#include "util/inline_vector.h"
 
 // branch types
 enum branch_type {
@@ -128,19 +128,20 @@ struct ooo_model_instr : champsim::program_ordered<ooo_model_instr> {
   unsigned completed_mem_ops = 0;
   int num_reg_dependent = 0;
 
+  // The operands are held inline, with room for as many as either trace format can hold
+  constexpr static std::size_t max_destinations = std::max(NUM_INSTR_DESTINATIONS, NUM_INSTR_DESTINATIONS_SPARC);
+  constexpr static std::size_t max_sources = NUM_INSTR_SOURCES;
+
   // Preserve architectural registers as observed in the trace.
   // (source_registers/destination_registers are renamed to physical IDs later.)
-  std::vector<uint8_t> arch_destination_registers = {};
-  std::vector<uint8_t> arch_source_registers = {};
-
-  std::vector<PHYSICAL_REGISTER_ID> destination_registers = {}; // output registers
-  std::vector<PHYSICAL_REGISTER_ID> source_registers = {};      // input registers
+  champsim::inline_vector<uint8_t, max_destinations> arch_destination_registers = {};
+  champsim::inline_vector<uint8_t, max_sources> arch_source_registers = {};
 
-  std::vector<champsim::address> destination_memory = {};
-  std::vector<champsim::address> source_memory = {};
+  champsim::inline_vector<PHYSICAL_REGISTER_ID, max_destinations> destination_registers = {}; // output registers
+  champsim::inline_vector<PHYSICAL_REGISTER_ID, max_sources> source_registers = {};           // input registers
 
-  // these are indices of instructions in the ROB that depend on me
-  std::vector<std::reference_wrapper<ooo_model_instr>> registers_instrs_depend_on_me;
+  champsim::inline_vector<champsim::address, max_destinations> destination_memory = {};
+  champsim::inline_vector<champsim::address, max_sources> source_memory = {};
 
 private:
   static uint8_t compute_opcode_class(bool is_branch, branch_type bt, bool has_load, bool has_store)
@@ -228,10 +229,8 @@ private:
     }
 
     // Snapshot architectural registers before any later transform (stack folding, renaming).
-    arch_destination_registers.reserve(destination_registers.size());
     std::transform(std::begin(destination_registers), std::end(destination_registers), std::back_inserter(arch_destination_registers),
                    [](PHYSICAL_REGISTER_ID r) { return static_cast<uint8_t>(r); });
-    arch_source_registers.reserve(source_registers.size());
     std::transform(std::begin(source_registers), std::end(source_registers), std::back_inserter(arch_source_registers),
                    [](PHYSICAL_REGISTER_ID r) { return static_cast<uint8_t>(r); });
 
@@ -254,16 +253,22 @@ public:
     return 0;
   }
 
-  void dump_neuroscalar_csv(std::ostream& os, uint64_t commit_cycle, uint64_t delta_cycles) const
+  [[nodiscard]] champsim::commit_record commit_trace_record(uint64_t commit_cycle, uint64_t delta_cycles) const
   {
     const uint8_t src1 = !std::empty(arch_source_registers) ? arch_source_registers[0] : 0;
     const uint8_t src2 = (arch_source_registers.size() > 1) ? arch_source_registers[1] : 0;
     const uint8_t dst1 = !std::empty(arch_destination_registers) ? arch_destination_registers[0] : 0;
+    return {ip.to<uint64_t>(), primary_memory_address(), opcode, src1, src2, dst1, commit_cycle, delta_cycles};
+  }
+
+  void dump_neuroscalar_csv(std::ostream& os, uint64_t commit_cycle, uint64_t delta_cycles) const
+  {
+    const auto rec = commit_trace_record(commit_cycle, delta_cycles);
 
     // Columns:
     // pc, memory_address, opcode, src1, src2, dst1, commit_cycle, delta_cycles_since_last_commit
-    os << ip.to<uint64_t>() << ',' << primary_memory_address() << ',' << static_cast<unsigned>(opcode) << ',' << static_cast<unsigned>(src1) << ','
-       << static_cast<unsigned>(src2) << ',' << static_cast<unsigned>(dst1) << ',' << commit_cycle << ',' << delta_cycles << '\n';
+    os << rec.pc << ',' << rec.memory_address << ',' << rec.opcode << ',' << rec.source_register1 << ',' << rec.source_register2 << ','
+       << rec.destination_register1 << ',' << rec.commit_cycle << ',' << rec.delta_cycles << '\n';
   }
 };
 
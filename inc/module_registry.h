@@ -0,0 +1,111 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MODULE_REGISTRY_H
+#define MODULE_REGISTRY_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cache.h"
+
+namespace champsim::modules
+{
+/**
+ * A table of prefetchers and replacement policies that can be attached to a cache by name at runtime.
+ *
+ * The configuration binds each cache to its modules at compile time, and that binding is still the default.
+ * The registry allows a single binary to swap those modules before the simulation starts, so that a sweep over policies does not need one build per point.
+ */
+class registry
+{
+public:
+  using prefetcher_factory = std::function<std::unique_ptr<CACHE::prefetcher_module_concept>(CACHE*)>;
+  using replacement_factory = std::function<std::unique_ptr<CACHE::replacement_module_concept>(CACHE*)>;
+
+private:
+  std::map<std::string, prefetcher_factory, std::less<>> prefetchers;
+  std::map<std::string, replacement_factory, std::less<>> replacements;
+
+public:
+  /**
+   * Make a prefetcher available under the given name. If the name is already taken, the existing entry is kept.
+   */
+  template <typename P>
+  void add_prefetcher(std::string name)
+  {
+    prefetchers.try_emplace(std::move(name), [](CACHE* cache) { return std::make_unique<CACHE::prefetcher_module_model<P>>(cache); });
+  }
+
+  /**
+   * Make a replacement policy available under the given name. If the name is already taken, the existing entry is kept.
+   */
+  template <typename R>
+  void add_replacement(std::string name)
+  {
+    replacements.try_emplace(std::move(name), [](CACHE* cache) { return std::make_unique<CACHE::replacement_module_model<R>>(cache); });
+  }
+
+  [[nodiscard]] std::vector<std::string> prefetcher_names() const;
+  [[nodiscard]] std::vector<std::string> replacement_names() const;
+
+  /**
+   * Construct the named prefetchers, bound to the given cache.
+   * If more than one name is given, the prefetchers are combined in the same way as multiple prefetchers in the configuration file.
+   *
+   * :param names: The registered names of the prefetchers. This must not be empty.
+   * :param cache: The cache that will own the prefetchers.
+   * :returns: A module that can replace ``CACHE::pref_module_pimpl``.
+   */
+  [[nodiscard]] std::unique_ptr<CACHE::prefetcher_module_concept> make_prefetcher(const std::vector<std::string>& names, CACHE* cache) const;
+
+  /**
+   * Construct the named replacement policies, bound to the given cache.
+   * If more than one name is given, the policies are combined in the same way as multiple policies in the configuration file.
+   *
+   * :param names: The registered names of the replacement policies. This must not be empty.
+   * :param cache: The cache that will own the policies.
+   * :returns: A module that can replace ``CACHE::repl_module_pimpl``.
+   */
+  [[nodiscard]] std::unique_ptr<CACHE::replacement_module_concept> make_replacement(const std::vector<std::string>& names, CACHE* cache) const;
+
+  /**
+   * Replace the prefetchers of a cache. This must be done before the cache is initialized.
+   */
+  void select_prefetcher(CACHE& cache, const std::vector<std::string>& names) const;
+
+  /**
+   * Replace the replacement policies of a cache. This must be done before the cache is initialized.
+   */
+  void select_replacement(CACHE& cache, const std::vector<std::string>& names) const;
+
+  /**
+   * Evaluate each of the named replacement policies on shadow tags alongside the replacement policy of a cache, as CACHE::add_replacement_shadow().
+   * This must be done before the cache is initialized.
+   */
+  void add_replacement_shadows(CACHE& cache, const std::vector<std::string>& names) const;
+
+  /**
+   * The registry of every prefetcher and replacement policy compiled into this binary.
+   */
+  static const registry& compiled();
+};
+} // namespace champsim::modules
+
+#endif
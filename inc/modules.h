@@ -124,6 +124,11 @@ struct prefetcher : public bound_to<CACHE> {
   template <typename, typename...>
   static auto cycle_operate_member_impl(long) -> std::false_type;
 
+  template <typename T, typename... Args>
+  static auto cycle_idle_member_impl(int) -> decltype(std::declval<T>().prefetcher_cycle_idle(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto cycle_idle_member_impl(long) -> std::false_type;
+
   template <typename T, typename... Args>
   static auto final_stats_member_impl(int) -> decltype(std::declval<T>().prefetcher_final_stats(std::declval<Args>()...), std::true_type{});
   template <typename, typename...>
@@ -151,6 +156,9 @@ struct prefetcher : public bound_to<CACHE> {
   template <typename T, typename... Args>
   constexpr static bool has_cycle_operate = decltype(cycle_operate_member_impl<T, Args...>(0))::value;
 
+  template <typename T, typename... Args>
+  constexpr static bool has_cycle_idle = decltype(cycle_idle_member_impl<T, Args...>(0))::value;
+
   template <typename T, typename... Args>
   constexpr static bool has_final_stats = decltype(final_stats_member_impl<T, Args...>(0))::value;
 
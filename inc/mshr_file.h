@@ -0,0 +1,214 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MSHR_FILE_H
+#define MSHR_FILE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * The miss status holding registers of a cache, indexed by block number.
+ *
+ * Each entry lives in a slot whose ID is stable for as long as the entry is held. The entries are also kept in an order in which the
+ * entries whose data has returned come first, in the order that they returned. The entries whose data has not returned follow, in the order
+ * they were allocated, except that marking an entry returned swaps it with the first entry that has not returned. Fills are taken from the
+ * front of this order.
+ *
+ * Finding, merging into, and returning an entry take constant time. At most one entry is held for each block.
+ */
+template <typename T>
+class mshr_file
+{
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using slot_id = std::size_t;
+
+private:
+  struct slot_type {
+    std::optional<T> entry{};
+    uint64_t block = 0;
+    uint64_t position = 0; // counts from the first entry ever pushed, so that removing from the front does not move the others
+    bool returned = false;
+  };
+
+  std::vector<slot_type> slots{};
+  std::vector<slot_id> free_slots{};
+  std::unordered_map<uint64_t, slot_id> slot_by_block{};
+  std::deque<slot_id> order{};
+  uint64_t front_position = 0;
+  uint64_t returned_bound = 0; // every entry before this position has returned
+
+  [[nodiscard]] std::size_t offset_of(uint64_t position) const { return static_cast<std::size_t>(position - front_position); }
+
+  template <bool Const>
+  class iterator_type
+  {
+    using file_type = std::conditional_t<Const, const mshr_file, mshr_file>;
+    file_type* file = nullptr;
+    std::size_t offset = 0;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    iterator_type() = default;
+    iterator_type(file_type* file_, std::size_t offset_) : file(file_), offset(offset_) {}
+
+    reference operator*() const { return *file->slots[file->order[offset]].entry; }
+    pointer operator->() const { return &**this; }
+
+    iterator_type& operator++()
+    {
+      ++offset;
+      return *this;
+    }
+
+    iterator_type operator++(int)
+    {
+      auto retval = *this;
+      ++(*this);
+      return retval;
+    }
+
+    friend bool operator==(const iterator_type& lhs, const iterator_type& rhs) { return lhs.file == rhs.file && lhs.offset == rhs.offset; }
+    friend bool operator!=(const iterator_type& lhs, const iterator_type& rhs) { return !(lhs == rhs); }
+  };
+
+public:
+  using iterator = iterator_type<false>;
+  using const_iterator = iterator_type<true>;
+
+  iterator begin() { return iterator{this, 0}; }
+  iterator end() { return iterator{this, std::size(order)}; }
+  const_iterator begin() const { return const_iterator{this, 0}; }
+  const_iterator end() const { return const_iterator{this, std::size(order)}; }
+
+  [[nodiscard]] size_type size() const { return std::size(order); }
+  [[nodiscard]] bool empty() const { return std::empty(order); }
+
+  T& front() { return *slots[order.front()].entry; }
+  const T& front() const { return *slots[order.front()].entry; }
+
+  T& operator[](slot_id slot) { return *slots[slot].entry; }
+  const T& operator[](slot_id slot) const { return *slots[slot].entry; }
+
+  /**
+   * The slot of the entry for the block, if there is one.
+   */
+  [[nodiscard]] std::optional<slot_id> find(uint64_t block) const
+  {
+    if (auto found = slot_by_block.find(block); found != std::end(slot_by_block)) {
+      return found->second;
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * Add an entry for a block that has none, after every other entry. Its data has not returned.
+   */
+  slot_id push_back(uint64_t block, T entry)
+  {
+    slot_id slot;
+    if (!std::empty(free_slots)) {
+      slot = free_slots.back();
+      free_slots.pop_back();
+    } else {
+      slot = std::size(slots);
+      slots.emplace_back();
+    }
+
+    auto [it, inserted] = slot_by_block.try_emplace(block, slot);
+    assert(inserted);
+    static_cast<void>(it);
+    static_cast<void>(inserted);
+
+    slots[slot] = slot_type{std::move(entry), block, front_position + std::size(order), false};
+    order.push_back(slot);
+    return slot;
+  }
+
+  /**
+   * Note that the data of an entry has returned, and move the entry behind the others that have returned.
+   */
+  void mark_returned(slot_id slot)
+  {
+    auto& returning = slots[slot];
+
+    // Every entry before the bound has returned, so the first that has not is found by advancing it
+    const auto back_position = front_position + std::size(order);
+    while (returned_bound < back_position && slots[order[offset_of(returned_bound)]].returned) {
+      ++returned_bound;
+    }
+
+    const auto was_returned = std::exchange(returning.returned, true);
+    if (returned_bound == back_position) {
+      return;
+    }
+
+    const auto from = returning.position;
+    const auto to = returned_bound;
+    auto& displaced = slots[order[offset_of(to)]];
+    std::swap(order[offset_of(from)], order[offset_of(to)]);
+    displaced.position = from;
+    returning.position = to;
+
+    // An entry that had returned already leaves the one it displaces ahead of the bound
+    returned_bound = (was_returned && from < to) ? from : to + 1;
+  }
+
+  /**
+   * Remove the first entry.
+   */
+  void pop_front()
+  {
+    const auto slot = order.front();
+    slot_by_block.erase(slots[slot].block);
+    slots[slot].entry.reset();
+    free_slots.push_back(slot);
+    order.pop_front();
+    ++front_position;
+    returned_bound = std::max(returned_bound, front_position);
+  }
+
+  void clear()
+  {
+    slots.clear();
+    free_slots.clear();
+    slot_by_block.clear();
+    order.clear();
+    front_position = 0;
+    returned_bound = 0;
+  }
+};
+} // namespace champsim
+
+#endif
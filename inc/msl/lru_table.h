@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -76,6 +77,12 @@ private:
   struct block_t {
     uint64_t last_used = 0;
     value_type data;
+
+    template <typename Archive>
+    void serialize(Archive& ar)
+    {
+      ar(last_used, data);
+    }
   };
   using block_vec_type = std::vector<block_t>;
   using diff_type = typename block_vec_type::difference_type;
@@ -165,6 +172,23 @@ public:
     return std::exchange(*hit, {}).data;
   }
 
+  /**
+   * Save or restore the contents of the table, including the recency of each entry.
+   * The table being restored must have the same geometry as the one that was saved.
+   */
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    auto sets = NUM_SET;
+    auto ways = NUM_WAY;
+    ar(sets, ways);
+    if (sets != NUM_SET || ways != NUM_WAY) {
+      throw std::runtime_error{"Saved table has " + std::to_string(sets) + " sets and " + std::to_string(ways) + " ways, expected " + std::to_string(NUM_SET)
+                               + " sets and " + std::to_string(NUM_WAY) + " ways"};
+    }
+    ar(access_count, block);
+  }
+
   lru_table(std::size_t sets, std::size_t ways, SetProj set_proj, TagProj tag_proj)
       : set_projection(set_proj), tag_projection(tag_proj), NUM_SET(static_cast<diff_type>(sets)), NUM_WAY(static_cast<diff_type>(ways)), block(sets * ways)
   {
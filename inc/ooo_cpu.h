@@ -25,25 +25,30 @@
 #include <array>
 #include <bitset>
 #include <deque>
-#include <fstream>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <optional>
 #include <queue>
+#include <set>
 #include <string>
 #include <stdexcept>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "bandwidth.h"
 #include "champsim.h"
 #include "channel.h"
+#include "commit_trace.h"
 #include "core_builder.h"
 #include "core_stats.h"
 #include "instruction.h"
 #include "modules.h"
 #include "operable.h"
+#include "serialization.h"
 #include "register_allocator.h"
+#include "util/circular_buffer.h"
 #include "util/lru_table.h"
 #include "util/to_underlying.h"
 
@@ -78,7 +83,7 @@ struct LSQ_ENTRY : champsim::program_ordered<LSQ_ENTRY> {
 
   LSQ_ENTRY(champsim::address addr, champsim::program_ordered<LSQ_ENTRY>::id_type id, champsim::address ip, std::array<uint8_t, 2> asid);
   void finish(ooo_model_instr& rob_entry) const;
-  void finish(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end) const;
+  void finish(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end) const;
 };
 
 // cpu
@@ -105,8 +110,10 @@ public:
   stats_type roi_stats{}, sim_stats{};
 
   // Optional commit-trace dump (for learning-data generation).
-  // When enabled, `retire_rob()` appends a CSV row per committed instruction.
-  void open_commit_trace(std::string filename, bool dump_warmup = false);
+  // When enabled, `retire_rob()` appends a record per committed instruction, which is encoded and written on a background thread.
+  void open_commit_trace(std::string filename, bool dump_warmup = false, champsim::commit_trace_format format = champsim::commit_trace_format::csv,
+                         champsim::commit_trace_compression compression = champsim::commit_trace_compression::none);
+  void close_commit_trace();
 
   // instruction buffer
   struct dib_shift {
@@ -117,15 +124,22 @@ public:
   dib_type DIB;
 
   // reorder buffer, load/store queue, register file
-  std::deque<ooo_model_instr> IFETCH_BUFFER;
-  std::deque<ooo_model_instr> DISPATCH_BUFFER;
-  std::deque<ooo_model_instr> DECODE_BUFFER;
-  std::deque<ooo_model_instr> ROB;
-  std::deque<ooo_model_instr> DIB_HIT_BUFFER;
+  champsim::circular_buffer<ooo_model_instr> IFETCH_BUFFER;
+  champsim::circular_buffer<ooo_model_instr> DISPATCH_BUFFER;
+  champsim::circular_buffer<ooo_model_instr> DECODE_BUFFER;
+  champsim::circular_buffer<ooo_model_instr> ROB;
+  champsim::circular_buffer<ooo_model_instr> DIB_HIT_BUFFER;
 
   std::vector<std::optional<LSQ_ENTRY>> LQ;
   std::deque<LSQ_ENTRY> SQ;
 
+  // indices over the LQ and SQ, kept up to date as entries are allocated and released
+  std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<>> lq_free_slots;
+  std::unordered_multimap<champsim::program_ordered<LSQ_ENTRY>::id_type, std::size_t> lq_slots_by_instr;
+  std::set<std::size_t> lq_unissued_slots; // loads that do not wait on a store and have not been issued
+  std::unordered_multimap<uint64_t, std::size_t> lq_issued_slots_by_block;
+  std::unordered_map<uint64_t, std::deque<LSQ_ENTRY*>> sq_entries_by_address; // in program order
+
   // Constants
   const std::size_t IFETCH_BUFFER_SIZE, DISPATCH_BUFFER_SIZE, DECODE_BUFFER_SIZE, REGISTER_FILE_SIZE, ROB_SIZE, SQ_SIZE, DIB_HIT_BUFFER_SIZE;
   champsim::bandwidth::maximum_type FETCH_WIDTH, DECODE_WIDTH, DISPATCH_WIDTH, SCHEDULER_SIZE, EXEC_WIDTH, DIB_INORDER_WIDTH;
@@ -142,18 +156,37 @@ public:
 
   RegisterAllocator reg_allocator{REGISTER_FILE_SIZE};
 
+  // scheduled instructions whose source registers are all valid, oldest first
+  std::priority_queue<champsim::program_ordered<ooo_model_instr>::id_type, std::vector<champsim::program_ordered<ooo_model_instr>::id_type>, std::greater<>>
+      ready_to_execute;
+
+  // the number of instructions at the head of the ROB that have been scheduled, and how many of those have not yet executed
+  std::size_t scheduled_prefix = 0;
+  std::size_t scheduled_prefix_waiting = 0;
+
+  // the largest number of registers named by any instruction that has been scheduled
+  std::size_t max_scheduled_register_demand = 0;
+
   // branch
   champsim::chrono::clock::time_point fetch_resume_time{};
   champsim::address l1i_fetch_context_ip{};
 
   const long IN_QUEUE_SIZE;
-  std::deque<ooo_model_instr> input_queue;
+  champsim::circular_buffer<ooo_model_instr> input_queue;
 
   CacheBus L1I_bus, L1D_bus;
   CACHE* l1i;
 
   void initialize() final;
   long operate() final;
+
+  /**
+   * The earliest time at which an instruction in the pipeline becomes ready for its next stage. The next cycle if an instruction can enter the
+   * pipeline, a memory request is waiting to be retried, or the caches have returned data.
+   */
+  [[nodiscard]] champsim::chrono::clock::time_point next_event_time() const final;
+
+  [[nodiscard]] std::vector<const champsim::channel*> lower_channels() const final;
   void begin_phase() final;
   void end_phase(unsigned cpu) final;
 
@@ -173,11 +206,14 @@ public:
   bool do_init_instruction(ooo_model_instr& instr);
   bool do_predict_branch(ooo_model_instr& instr);
   void do_check_dib(ooo_model_instr& instr);
-  bool do_fetch_instruction(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end);
+  bool do_fetch_instruction(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end);
   void do_dib_update(const ooo_model_instr& instr);
   void do_scheduling(ooo_model_instr& instr);
+  champsim::circular_buffer<ooo_model_instr>::iterator find_unexecuted(champsim::program_ordered<ooo_model_instr>::id_type id);
   void do_execution(ooo_model_instr& instr);
   void do_memory_scheduling(ooo_model_instr& instr);
+  LSQ_ENTRY* find_forwarding_store(champsim::address addr);
+  void release_lq_entry(std::optional<LSQ_ENTRY>& lq_entry);
   void do_complete_execution(ooo_model_instr& instr);
   void do_sq_forward_to_lq(LSQ_ENTRY& sq_entry, LSQ_ENTRY& lq_entry);
 
@@ -192,6 +228,17 @@ public:
 
   void print_deadlock() final;
 
+  /**
+   * Write the decoded instruction buffer and the state of every branch predictor and BTB that provides a ``serialize()`` member function.
+   * Instructions in the pipeline are not saved.
+   */
+  void save_state(champsim::serialization::output_archive& ar) final;
+
+  /**
+   * Restore state written by save_state(). Instructions in the pipeline, and their requests to the caches, are discarded.
+   */
+  void load_state(champsim::serialization::input_archive& ar) final;
+
 #include "module_decl.inc"
 
   struct branch_module_concept {
@@ -200,6 +247,9 @@ public:
     virtual void impl_initialize_branch_predictor() = 0;
     virtual void impl_last_branch_result(champsim::address ip, champsim::address target, bool taken, uint8_t branch_type) = 0;
     virtual bool impl_predict_branch(champsim::address ip, champsim::address predicted_target, bool always_taken, uint8_t branch_type) = 0;
+
+    virtual void impl_save_state(champsim::serialization::output_archive& ar) = 0;
+    virtual void impl_load_state(champsim::serialization::input_archive& ar) = 0;
   };
 
   struct btb_module_concept {
@@ -208,6 +258,9 @@ public:
     virtual void impl_initialize_btb() = 0;
     virtual void impl_update_btb(champsim::address ip, champsim::address predicted_target, bool taken, uint8_t branch_type) = 0;
     virtual std::pair<champsim::address, bool> impl_btb_prediction(champsim::address ip, uint8_t branch_type) = 0;
+
+    virtual void impl_save_state(champsim::serialization::output_archive& ar) = 0;
+    virtual void impl_load_state(champsim::serialization::input_archive& ar) = 0;
   };
 
   template <typename... Bs>
@@ -218,6 +271,9 @@ public:
     void impl_initialize_branch_predictor() final;
     void impl_last_branch_result(champsim::address ip, champsim::address target, bool taken, uint8_t branch_type) final;
     [[nodiscard]] bool impl_predict_branch(champsim::address ip, champsim::address predicted_target, bool always_taken, uint8_t branch_type) final;
+
+    void impl_save_state(champsim::serialization::output_archive& ar) final;
+    void impl_load_state(champsim::serialization::input_archive& ar) final;
   };
 
   template <typename... Ts>
@@ -228,12 +284,15 @@ public:
     void impl_initialize_btb() final;
     void impl_update_btb(champsim::address ip, champsim::address predicted_target, bool taken, uint8_t branch_type) final;
     [[nodiscard]] std::pair<champsim::address, bool> impl_btb_prediction(champsim::address ip, uint8_t branch_type) final;
+
+    void impl_save_state(champsim::serialization::output_archive& ar) final;
+    void impl_load_state(champsim::serialization::input_archive& ar) final;
   };
 
   std::unique_ptr<branch_module_concept> branch_module_pimpl;
   std::unique_ptr<btb_module_concept> btb_module_pimpl;
 
-  std::unique_ptr<std::ofstream> commit_trace_stream{};
+  std::unique_ptr<champsim::commit_trace_writer> commit_trace{};
   bool commit_trace_dump_warmup = false;
   std::optional<uint64_t> commit_trace_last_cycle{};
 
@@ -251,17 +310,22 @@ public:
   explicit O3_CPU(champsim::core_builder<champsim::core_builder_module_type_holder<Bs...>, champsim::core_builder_module_type_holder<Ts...>> b)
       : champsim::operable(b.m_clock_period), cpu(b.m_cpu),
         DIB(b.m_dib_set, b.m_dib_way, {champsim::data::bits{champsim::lg2(b.m_dib_window)}}, {champsim::data::bits{champsim::lg2(b.m_dib_window)}}),
-        LQ(b.m_lq_size), IFETCH_BUFFER_SIZE(b.m_ifetch_buffer_size), DISPATCH_BUFFER_SIZE(b.m_dispatch_buffer_size), DECODE_BUFFER_SIZE(b.m_decode_buffer_size),
+        IFETCH_BUFFER(b.m_ifetch_buffer_size), DISPATCH_BUFFER(b.m_dispatch_buffer_size), DECODE_BUFFER(b.m_decode_buffer_size), ROB(b.m_rob_size),
+        DIB_HIT_BUFFER(b.m_dib_hit_buffer_size), LQ(b.m_lq_size), IFETCH_BUFFER_SIZE(b.m_ifetch_buffer_size), DISPATCH_BUFFER_SIZE(b.m_dispatch_buffer_size), DECODE_BUFFER_SIZE(b.m_decode_buffer_size),
         REGISTER_FILE_SIZE(b.m_register_file_size), ROB_SIZE(b.m_rob_size), SQ_SIZE(b.m_sq_size), DIB_HIT_BUFFER_SIZE(b.m_dib_hit_buffer_size),
         FETCH_WIDTH(b.m_fetch_width), DECODE_WIDTH(b.m_decode_width), DISPATCH_WIDTH(b.m_dispatch_width), SCHEDULER_SIZE(b.m_schedule_width),
         EXEC_WIDTH(b.m_execute_width), DIB_INORDER_WIDTH(b.m_dib_inorder_width), LQ_WIDTH(b.m_lq_width), SQ_WIDTH(b.m_sq_width), RETIRE_WIDTH(b.m_retire_width),
         BRANCH_MISPREDICT_PENALTY(b.m_mispredict_penalty * b.m_clock_period), DISPATCH_LATENCY(b.m_dispatch_latency * b.m_clock_period),
         DECODE_LATENCY(b.m_decode_latency * b.m_clock_period), SCHEDULING_LATENCY(b.m_schedule_latency * b.m_clock_period),
         EXEC_LATENCY(b.m_execute_latency * b.m_clock_period), DIB_HIT_LATENCY(b.m_dib_hit_latency * b.m_clock_period), L1I_BANDWIDTH(b.m_l1i_bw),
-        L1D_BANDWIDTH(b.m_l1d_bw), IN_QUEUE_SIZE(2 * champsim::to_underlying(b.m_fetch_width)), L1I_bus(b.m_cpu, b.m_fetch_queues),
+        L1D_BANDWIDTH(b.m_l1d_bw), IN_QUEUE_SIZE(2 * champsim::to_underlying(b.m_fetch_width)),
+        input_queue(static_cast<std::size_t>(IN_QUEUE_SIZE)), L1I_bus(b.m_cpu, b.m_fetch_queues),
         L1D_bus(b.m_cpu, b.m_data_queues), l1i(b.m_l1i), branch_module_pimpl(std::make_unique<branch_module_model<Bs...>>(this)),
         btb_module_pimpl(std::make_unique<btb_module_model<Ts...>>(this))
   {
+    for (std::size_t slot = 0; slot < std::size(LQ); ++slot) {
+      lq_free_slots.push(slot);
+    }
   }
 };
 
@@ -380,6 +444,50 @@ std::pair<champsim::address, bool> O3_CPU::btb_module_model<Ts...>::impl_btb_pre
   return return_type{};
 }
 
+template <typename... Bs>
+void O3_CPU::branch_module_model<Bs...>::impl_save_state(champsim::serialization::output_archive& ar)
+{
+  [[maybe_unused]] auto process_one = [&](auto& b) {
+    if constexpr (champsim::serialization::has_serialize_v<decltype(b), champsim::serialization::output_archive>)
+      ar(b);
+  };
+
+  std::apply([&](auto&... b) { (..., process_one(b)); }, intern_);
+}
+
+template <typename... Bs>
+void O3_CPU::branch_module_model<Bs...>::impl_load_state(champsim::serialization::input_archive& ar)
+{
+  [[maybe_unused]] auto process_one = [&](auto& b) {
+    if constexpr (champsim::serialization::has_serialize_v<decltype(b), champsim::serialization::input_archive>)
+      ar(b);
+  };
+
+  std::apply([&](auto&... b) { (..., process_one(b)); }, intern_);
+}
+
+template <typename... Ts>
+void O3_CPU::btb_module_model<Ts...>::impl_save_state(champsim::serialization::output_archive& ar)
+{
+  [[maybe_unused]] auto process_one = [&](auto& t) {
+    if constexpr (champsim::serialization::has_serialize_v<decltype(t), champsim::serialization::output_archive>)
+      ar(t);
+  };
+
+  std::apply([&](auto&... t) { (..., process_one(t)); }, intern_);
+}
+
+template <typename... Ts>
+void O3_CPU::btb_module_model<Ts...>::impl_load_state(champsim::serialization::input_archive& ar)
+{
+  [[maybe_unused]] auto process_one = [&](auto& t) {
+    if constexpr (champsim::serialization::has_serialize_v<decltype(t), champsim::serialization::input_archive>)
+      ar(t);
+  };
+
+  std::apply([&](auto&... t) { (..., process_one(t)); }, intern_);
+}
+
 #ifdef SET_ASIDE_CHAMPSIM_MODULE
 #undef SET_ASIDE_CHAMPSIM_MODULE
 #define CHAMPSIM_MODULE
@@ -17,10 +17,15 @@
 #ifndef OPERABLE_H
 #define OPERABLE_H
 
+#include <vector>
+
 #include "chrono.h"
+#include "serialization.h"
 
 namespace champsim
 {
+class channel;
+
 class operable
 {
 public:
@@ -34,6 +39,7 @@ public:
 
   long _operate();
   long operate_on(const champsim::chrono::clock& clock);
+  long idle_on(const champsim::chrono::clock& clock);
 
   virtual void initialize() {} // LCOV_EXCL_LINE
   virtual long operate() = 0;
@@ -41,6 +47,42 @@ public:
   virtual void end_phase(unsigned /*cpu index*/) {} // LCOV_EXCL_LINE
   virtual void print_deadlock() {}                  // LCOV_EXCL_LINE
 
+  /**
+   * The earliest time at which operate() might make progress, given that its last call made none.
+   * The simulation may pass over the cycles before this time without operating any component.
+   * Components that cannot tell return the time of their next cycle, which never allows a skip.
+   */
+  virtual champsim::chrono::clock::time_point next_event_time() const { return current_time + clock_period; } // LCOV_EXCL_LINE
+
+  /**
+   * Account for cycles that were passed over without calling operate(). The clock has already been advanced.
+   * Components that do bookkeeping every cycle, whether or not they make progress, repeat it here.
+   *
+   * :param cycles: The number of cycles passed over
+   */
+  virtual void idle_cycles(long /*cycles*/) {} // LCOV_EXCL_LINE
+
+  /**
+   * The channels on which this component takes requests from the levels above it.
+   */
+  virtual std::vector<const champsim::channel*> upper_channels() const { return {}; } // LCOV_EXCL_LINE
+
+  /**
+   * The channels on which this component sends requests to the levels below it.
+   */
+  virtual std::vector<const champsim::channel*> lower_channels() const { return {}; } // LCOV_EXCL_LINE
+
+  /**
+   * Write the microarchitectural state of this component, so that load_state() can restore it in another run of the same binary.
+   * Components without persistent state write nothing.
+   */
+  virtual void save_state(champsim::serialization::output_archive& /*ar*/) {} // LCOV_EXCL_LINE
+
+  /**
+   * Restore state written by save_state().
+   */
+  virtual void load_state(champsim::serialization::input_archive& /*ar*/) {} // LCOV_EXCL_LINE
+
   [[deprecated]] uint64_t current_cycle() const;
 };
 
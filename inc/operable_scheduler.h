@@ -0,0 +1,116 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OPERABLE_SCHEDULER_H
+#define OPERABLE_SCHEDULER_H
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "chrono.h"
+#include "operable.h"
+
+namespace champsim
+{
+/**
+ * Operates a fixed set of components, earliest local time first.
+ *
+ * The components are divided into clock domains, each of which holds the components that share a clock period and a current time.
+ * Since every member of a domain is operated on the same global clock, the members never drift apart, and the order of all components is
+ * determined entirely by the relative order of the domain times. The scheduler sorts the components once for each such relative order it
+ * encounters, in the same way as a sort by current time of the components in their given order, and reuses that order thereafter.
+ * A system with a single clock domain is sorted exactly once.
+ *
+ * Components may also be assigned to partitions, such as the private caches of one core, that share no state with other partitions.
+ * The order of a cycle is then divided into stages. Within a stage, the partitions may be operated in any order relative to each other, or
+ * concurrently, without changing the result.
+ *
+ * The components must not be operated other than through this scheduler while it is in use.
+ */
+class operable_scheduler
+{
+public:
+  using value_type = std::reference_wrapper<operable>;
+  using partition_type = std::vector<value_type>;
+
+  /**
+   * The partition of a component that shares state with other partitions, and so must be operated alone
+   */
+  constexpr static std::size_t shared_partition = std::numeric_limits<std::size_t>::max();
+
+  /**
+   * A step of a cycle. Each partition is operated in order, but the partitions are independent of each other.
+   */
+  using stage_type = std::vector<partition_type>;
+
+  struct plan_type {
+    std::vector<stage_type> stages{};
+    std::vector<partition_type> private_members{}; // the members of each partition, in order
+    partition_type shared_members{};               // the shared components, in order
+  };
+
+  explicit operable_scheduler(std::vector<value_type> operables);
+
+  /**
+   * :param operables: The components to operate
+   * :param partitions: For each component, the index of its partition, or ``shared_partition``
+   */
+  operable_scheduler(std::vector<value_type> operables, std::vector<std::size_t> partitions);
+
+  /**
+   * Operate each component until its local time reaches the given clock, in order of local time.
+   *
+   * :returns: The total progress made by the components
+   */
+  long operate_on(const champsim::chrono::clock& clock);
+
+  /**
+   * The stages of the next cycle, given the current times of the components.
+   */
+  const plan_type& current_plan();
+
+  /**
+   * The components, in the order they were given.
+   */
+  [[nodiscard]] const std::vector<value_type>& operables() const;
+
+  /**
+   * The number of clock domains.
+   */
+  [[nodiscard]] std::size_t num_domains() const;
+
+  /**
+   * The number of partitions, not counting the shared components.
+   */
+  [[nodiscard]] std::size_t num_partitions() const;
+
+private:
+  std::vector<value_type> m_operables;
+  std::vector<std::size_t> m_partitions;
+  std::size_t m_num_partitions = 0;
+  std::vector<std::size_t> m_domain_leaders{}; // one member of each domain, whose time is that of the domain
+  std::vector<long> m_domain_ranks{};          // for each domain, the number of domains whose time is earlier
+  std::vector<std::pair<std::vector<long>, plan_type>> m_plans{}; // the plan for each relative order of the domains seen so far
+  std::size_t m_last_plan = 0;
+
+  [[nodiscard]] plan_type make_plan() const;
+};
+} // namespace champsim
+
+#endif
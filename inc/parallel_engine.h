@@ -0,0 +1,107 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARALLEL_ENGINE_H
+#define PARALLEL_ENGINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "chrono.h"
+#include "operable_scheduler.h"
+
+namespace champsim
+{
+struct environment;
+
+/**
+ * Find the components that belong to exactly one core: those that only that core's requests can reach.
+ * The page table walkers are shared, since every walker allocates pages from the same virtual memory.
+ *
+ * :returns: For each component of ``env.operable_view()``, the index of its core in ``env.cpu_view()``, or ``operable_scheduler::shared_partition``
+ */
+std::vector<std::size_t> core_partitions(environment& env);
+
+/**
+ * Operates the partitions of an operable_scheduler on a pool of host threads.
+ *
+ * Each cycle is operated stage by stage, and the partitions of a stage are shared among the threads. The threads synchronize at the end of
+ * every stage, so the result is identical to that of the serial scheduler.
+ *
+ * With run_ahead(), the partitions instead run a number of cycles on their own before the shared components catch up. This synchronizes less
+ * often, but a partition does not see the shared components respond until the end of each such quantum, so the result is only approximate.
+ */
+class parallel_engine
+{
+public:
+  /**
+   * :param num_threads: The total number of threads to use, including the calling thread
+   */
+  explicit parallel_engine(std::size_t num_threads);
+  ~parallel_engine();
+
+  parallel_engine(const parallel_engine&) = delete;
+  parallel_engine& operator=(const parallel_engine&) = delete;
+
+  /**
+   * Operate one cycle, as operable_scheduler::operate_on() does.
+   */
+  long operate_on(operable_scheduler& scheduler, const champsim::chrono::clock& clock);
+
+  /**
+   * Operate each partition for the given number of time quanta, then operate the shared components for the same period.
+   * The clock is advanced by the whole period.
+   *
+   * :param after_tick: Called with the index of a partition after each of its time quanta, on the thread that operates it
+   */
+  long run_ahead(operable_scheduler& scheduler, champsim::chrono::clock& clock, champsim::chrono::clock::duration time_quantum, long quanta,
+                 const std::function<void(std::size_t)>& after_tick);
+
+  [[nodiscard]] std::size_t num_threads() const;
+
+private:
+  std::vector<std::thread> m_workers{};
+
+  std::atomic<uint64_t> m_generation{0};
+  std::atomic<bool> m_stop{false};
+  std::atomic<std::size_t> m_next_task{0};
+  std::atomic<std::size_t> m_workers_done{0};
+  std::atomic<long> m_progress{0};
+  std::size_t m_num_tasks = 0;
+  const std::function<long(std::size_t)>* m_task = nullptr;
+
+  std::mutex m_error_mutex{};
+  std::exception_ptr m_error{};
+
+  void work();
+  void worker_loop();
+
+  /**
+   * Call the task once for each index in [0, count), spread over the threads, and wait for all calls to finish.
+   *
+   * :returns: The sum of the values returned by the task
+   */
+  long run_concurrently(std::size_t count, const std::function<long(std::size_t)>& task);
+};
+} // namespace champsim
+
+#endif
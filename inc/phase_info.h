@@ -24,6 +24,7 @@
 #include <string_view>
 #include <vector>
 
+#include "cache_checkpoint.h"
 #include "cache_stats.h"
 #include "core_stats.h"
 #include "dram_stats.h"
@@ -39,7 +40,11 @@ struct phase_info {
   std::vector<std::string> trace_names;
   std::optional<std::string> cache_checkpoint_in;
   std::optional<std::string> cache_checkpoint_out;
+  checkpoint_format cache_checkpoint_format = checkpoint_format::binary;
   bool verbose = false;
+  bool skip_idle_cycles = true;
+  std::size_t num_threads = 1; // host threads that operate the private components of the cores
+  long parallel_slack = 1;     // time quanta that the cores may run ahead of the shared components
 };
 
 struct phase_stats {
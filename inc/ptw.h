@@ -55,8 +55,8 @@ class PageTableWalker : public champsim::operable
     champsim::address v_address{};
     champsim::waitable<champsim::address> data{};
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::channel::dependents_type instr_depend_on_me{};
+    champsim::channel::return_list_type to_return{};
 
     uint32_t pf_metadata = 0;
     uint32_t cpu = std::numeric_limits<uint32_t>::max();
@@ -95,8 +95,22 @@ public:
 
   long operate() final;
 
+  /**
+   * The time at which the next walk step or completed walk is ready. The next cycle if a request or a response is waiting.
+   */
+  [[nodiscard]] champsim::chrono::clock::time_point next_event_time() const final;
+
+  [[nodiscard]] std::vector<const champsim::channel*> upper_channels() const final;
+  [[nodiscard]] std::vector<const champsim::channel*> lower_channels() const final;
+
   void begin_phase() final;
   void print_deadlock() final;
+
+  /**
+   * Write the contents of the paging structure caches. The virtual memory is shared between walkers, so it is saved separately.
+   */
+  void save_state(champsim::serialization::output_archive& ar) final;
+  void load_state(champsim::serialization::input_archive& ar) final;
 };
 
 #endif
@@ -22,12 +22,27 @@ private:
   std::array<PHYSICAL_REGISTER_ID, std::numeric_limits<uint8_t>::max() + 1> frontend_RAT, backend_RAT;
   std::queue<PHYSICAL_REGISTER_ID> free_registers;
   std::vector<physical_register> physical_register_file;
+  std::vector<std::vector<champsim::program_ordered<ooo_model_instr>::id_type>> register_waiters;
 
 public:
   RegisterAllocator(size_t num_physical_registers);
   PHYSICAL_REGISTER_ID rename_dest_register(int16_t reg, champsim::program_ordered<ooo_model_instr>::id_type producer_id);
   PHYSICAL_REGISTER_ID rename_src_register(int16_t reg);
   void complete_dest_register(PHYSICAL_REGISTER_ID physreg);
+
+  /**
+   * Mark the physical register as valid, and wake the instructions that are waiting for it.
+   *
+   * :param physreg: The register whose value has been produced
+   * :param wake: A callable that is given the ID of each waiting instruction, in the order in which they began to wait
+   */
+  template <typename F>
+  void complete_dest_register(PHYSICAL_REGISTER_ID physreg, F&& wake);
+
+  /**
+   * Record that an instruction is waiting for the value of a physical register that is not yet valid.
+   */
+  void wait_for_register(PHYSICAL_REGISTER_ID physreg, champsim::program_ordered<ooo_model_instr>::id_type waiter);
   void retire_dest_register(PHYSICAL_REGISTER_ID physreg);
   void free_register(PHYSICAL_REGISTER_ID physreg);
   bool isValid(PHYSICAL_REGISTER_ID physreg) const;
@@ -37,4 +52,17 @@ public:
   void reset_frontend_RAT();
   void print_deadlock();
 };
+
+template <typename F>
+void RegisterAllocator::complete_dest_register(PHYSICAL_REGISTER_ID physreg, F&& wake)
+{
+  // mark the physical register as valid
+  physical_register_file.at(physreg).valid = true;
+
+  auto& waiters = register_waiters.at(physreg);
+  for (auto waiter : waiters) {
+    wake(waiter);
+  }
+  waiters.clear();
+}
 #endif
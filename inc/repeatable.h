@@ -44,6 +44,25 @@ struct repeatable {
     return intern_();
   }
 
+  uint64_t skip(uint64_t count)
+  {
+    uint64_t skipped = 0;
+    while (skipped < count) {
+      if (intern_.eof()) {
+        fmt::print("*** Reached end of trace: {}\n", args_);
+        intern_ = T{std::apply([](auto... x) { return T{x...}; }, args_)};
+      }
+
+      auto step = intern_.skip(count - skipped);
+      if (step == 0) {
+        break; // The trace is empty
+      }
+      skipped += step;
+    }
+
+    return skipped;
+  }
+
   [[nodiscard]] bool eof() const { return false; }
 };
 } // namespace champsim
@@ -0,0 +1,242 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "util/detect.h"
+#include "util/type_traits.h"
+
+namespace champsim::serialization
+{
+class output_archive;
+class input_archive;
+
+namespace detail
+{
+template <typename T, typename Archive>
+using serialize_member_t = decltype(std::declval<T&>().serialize(std::declval<Archive&>()));
+
+template <typename T>
+struct is_std_array : std::false_type {
+};
+template <typename T, std::size_t N>
+struct is_std_array<std::array<T, N>> : std::true_type {
+};
+
+template <typename T>
+constexpr bool is_sequence_v = champsim::is_specialization_v<T, std::vector> || champsim::is_specialization_v<T, std::deque>;
+
+template <typename T>
+constexpr bool is_associative_v = champsim::is_specialization_v<T, std::map> || champsim::is_specialization_v<T, std::unordered_map>
+                                  || champsim::is_specialization_v<T, std::set>;
+} // namespace detail
+
+/**
+ * Whether a type describes its own state with a member function ``template <typename Archive> void serialize(Archive& ar)``.
+ * Types that do not, but are trivially copyable, are written as raw bytes.
+ */
+template <typename T, typename Archive>
+constexpr bool has_serialize_v = champsim::is_detected<detail::serialize_member_t, std::remove_cv_t<std::remove_reference_t<T>>, Archive>::value;
+
+/**
+ * Write simulator state to a binary stream.
+ *
+ * A type is serialized by the first of these that applies:
+ *
+ * - Its ``serialize()`` member function, which calls the archive on each of its members in turn.
+ * - A byte copy, if it is trivially copyable.
+ * - Element by element, if it is a standard container, pair, tuple, optional, or string.
+ *
+ * The encoding is not portable between builds. It is meant to be read back by the same binary.
+ */
+class output_archive
+{
+  std::ostream& stream;
+
+  template <typename T>
+  void write(const T& value);
+
+public:
+  explicit output_archive(std::ostream& str) : stream(str) {}
+
+  void write_bytes(const void* data, std::size_t size) { stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size)); }
+
+  template <typename... Ts>
+  void operator()(const Ts&... values)
+  {
+    (..., write(values));
+  }
+};
+
+/**
+ * Read simulator state from a binary stream written by output_archive. Each value is read in place, in the order it was written.
+ */
+class input_archive
+{
+  std::istream& stream;
+
+  template <typename T>
+  void read(T& value);
+
+public:
+  explicit input_archive(std::istream& str) : stream(str) {}
+
+  void read_bytes(void* data, std::size_t size)
+  {
+    stream.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+    if (stream.gcount() != static_cast<std::streamsize>(size)) {
+      throw std::runtime_error("Serialized state is truncated");
+    }
+  }
+
+  template <typename... Ts>
+  void operator()(Ts&... values)
+  {
+    (..., read(values));
+  }
+};
+
+template <typename T>
+void output_archive::write(const T& value)
+{
+  if constexpr (has_serialize_v<T, output_archive>) {
+    // serialize() is shared between saving and loading, so it cannot be const
+    const_cast<T&>(value).serialize(*this); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+  } else if constexpr (std::is_trivially_copyable_v<T>) {
+    write_bytes(&value, sizeof(T));
+  } else if constexpr (detail::is_std_array<T>::value) {
+    for (const auto& elem : value) {
+      write(elem);
+    }
+  } else if constexpr (std::is_same_v<T, std::vector<bool>>) {
+    write(static_cast<uint64_t>(std::size(value)));
+    for (bool elem : value) {
+      write(static_cast<uint8_t>(elem));
+    }
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    write(static_cast<uint64_t>(std::size(value)));
+    write_bytes(std::data(value), std::size(value));
+  } else if constexpr (detail::is_sequence_v<T> || detail::is_associative_v<T>) {
+    write(static_cast<uint64_t>(std::size(value)));
+    for (const auto& elem : value) {
+      write(elem);
+    }
+  } else if constexpr (champsim::is_specialization_v<T, std::pair>) {
+    write(value.first);
+    write(value.second);
+  } else if constexpr (champsim::is_specialization_v<T, std::tuple>) {
+    std::apply([this](const auto&... elems) { (..., write(elems)); }, value);
+  } else if constexpr (champsim::is_specialization_v<T, std::optional>) {
+    write(value.has_value());
+    if (value.has_value()) {
+      write(*value);
+    }
+  } else {
+    static_assert(has_serialize_v<T, output_archive>, "This type must have a serialize() member function to be saved");
+  }
+}
+
+template <typename T>
+void input_archive::read(T& value)
+{
+  if constexpr (has_serialize_v<T, input_archive>) {
+    value.serialize(*this);
+  } else if constexpr (std::is_trivially_copyable_v<T>) {
+    read_bytes(&value, sizeof(T));
+  } else if constexpr (detail::is_std_array<T>::value) {
+    for (auto& elem : value) {
+      read(elem);
+    }
+  } else if constexpr (std::is_same_v<T, std::vector<bool>>) {
+    uint64_t size{};
+    read(size);
+    value.resize(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      uint8_t elem{};
+      read(elem);
+      value[i] = (elem != 0);
+    }
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    uint64_t size{};
+    read(size);
+    value.resize(size);
+    read_bytes(std::data(value), size);
+  } else if constexpr (detail::is_sequence_v<T>) {
+    uint64_t size{};
+    read(size);
+    if constexpr (std::is_default_constructible_v<typename T::value_type>) {
+      value.resize(size);
+    } else if (size != std::size(value)) {
+      // Elements that cannot be default-constructed are restored in place
+      throw std::runtime_error("Serialized state holds " + std::to_string(size) + " elements, expected " + std::to_string(std::size(value)));
+    }
+    for (auto& elem : value) {
+      read(elem);
+    }
+  } else if constexpr (detail::is_associative_v<T>) {
+    uint64_t size{};
+    read(size);
+    value.clear();
+    for (uint64_t i = 0; i < size; ++i) {
+      std::remove_const_t<typename T::key_type> key{};
+      if constexpr (champsim::is_specialization_v<T, std::set>) {
+        read(key);
+        value.insert(std::move(key));
+      } else {
+        typename T::mapped_type mapped{};
+        read(key);
+        read(mapped);
+        value.emplace(std::move(key), std::move(mapped));
+      }
+    }
+  } else if constexpr (champsim::is_specialization_v<T, std::pair>) {
+    read(value.first);
+    read(value.second);
+  } else if constexpr (champsim::is_specialization_v<T, std::tuple>) {
+    std::apply([this](auto&... elems) { (..., read(elems)); }, value);
+  } else if constexpr (champsim::is_specialization_v<T, std::optional>) {
+    bool engaged{};
+    read(engaged);
+    if (engaged) {
+      value.emplace();
+      read(*value);
+    } else {
+      value.reset();
+    }
+  } else {
+    static_assert(has_serialize_v<T, input_archive>, "This type must have a serialize() member function to be loaded");
+  }
+}
+} // namespace champsim::serialization
+
+#endif
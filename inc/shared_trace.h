@@ -0,0 +1,88 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SHARED_TRACE_H
+#define SHARED_TRACE_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "instruction.h"
+#include "tracereader.h"
+
+namespace champsim
+{
+/**
+ * A trace that is decoded once and read in full by several simulations, each at its own pace.
+ *
+ * A thread reads the source trace in batches. Each consumer reads every batch in turn, and a batch is freed once every consumer has read it.
+ * The thread runs ahead of the slowest consumer by at most the given depth, unless another consumer is waiting for the next batch. Then it
+ * reads on, and the backlog of the slower consumers grows. Consumers that read several shared traces in different orders therefore never
+ * wait on each other. A consumer that destroys its reader no longer holds the others back.
+ *
+ * The thread is started on first use. Each consumer must take its reader, or its backlog will hold every batch that is read.
+ */
+class shared_trace
+{
+  struct state_type;
+  std::shared_ptr<state_type> state;
+
+public:
+  constexpr static std::size_t default_batch_size = 1024;
+
+  /**
+   * The instructions of a shared trace, as seen by one consumer.
+   */
+  class cursor
+  {
+    std::shared_ptr<state_type> state;
+    std::size_t consumer;
+    std::size_t consumed = 0; // the number of instructions taken from the current batch
+    mutable std::shared_ptr<const std::vector<ooo_model_instr>> batch{}; // the batch being read, if it has been published
+
+    bool wait_for_batch() const;
+
+  public:
+    cursor(std::shared_ptr<state_type> state, std::size_t consumer);
+    cursor(cursor&&) noexcept = default;
+    cursor& operator=(cursor&&) = delete;
+    cursor(const cursor&) = delete;
+    cursor& operator=(const cursor&) = delete;
+    ~cursor();
+
+    ooo_model_instr operator()();
+    [[nodiscard]] bool eof() const { return !wait_for_batch(); }
+  };
+
+  /**
+   * :param source: The trace to read. Its instruction IDs are discarded; each consumer's reader assigns its own.
+   * :param consumers: The number of readers that will read the trace
+   * :param depth: The number of batches that may be read ahead of the slowest consumer while no consumer waits
+   * :param batch_size: The number of instructions in each batch
+   */
+  shared_trace(tracereader&& source, std::size_t consumers, std::size_t depth, std::size_t batch_size = default_batch_size);
+
+  /**
+   * The reader for one consumer, which produces every instruction of the source from the start.
+   *
+   * :throws std::invalid_argument: If there is no such consumer, or its reader was already taken.
+   */
+  tracereader reader(std::size_t consumer);
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIM_SERVER_H
+#define SIM_SERVER_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chrono.h"
+#include "environment.h"
+#include "phase_info.h"
+#include "tracereader.h"
+
+namespace champsim
+{
+/**
+ * A long-lived simulation that is driven by text commands, one per line.
+ *
+ * The environment is initialized once, and the traces, the global clock, and all microarchitectural state persist between commands.
+ * Each command produces exactly one line of JSON in response, with ``"status"`` set to ``"ok"`` or ``"error"``.
+ *
+ * The commands are:
+ *
+ * - ``run N``: simulate a window of N instructions on each core. The response holds the statistics of that window alone.
+ * - ``warmup N``: as ``run``, but as a warmup phase.
+ * - ``skip N``: advance every trace by N instructions without simulating them.
+ * - ``prefetcher CACHE NAME[,NAME...]``: replace the prefetchers of a cache with modules compiled into the binary.
+ * - ``replacement CACHE NAME[,NAME...]``: replace the replacement policy of a cache with modules compiled into the binary.
+ * - ``save PATH [bin|text]``: write a cache checkpoint.
+ * - ``load PATH``: restore a cache checkpoint.
+ * - ``snapshot PATH``: write the state of the whole simulator. See save_snapshot().
+ * - ``restore PATH``: restore the state of the whole simulator. Requests in flight are discarded.
+ * - ``branch SOCKET``: fork the simulation. The child process continues from the exact current state, including requests in flight,
+ *   and serves its own commands on the Unix domain socket SOCKET until it receives ``quit``. The response holds the process ID of the child.
+ *   The child does not write the commit traces of the parent.
+ * - ``quit``: stop serving.
+ */
+class simulation_server
+{
+  environment& env;
+  std::vector<tracereader>& traces;
+  std::vector<std::string> trace_names;
+  std::vector<std::size_t> trace_index;
+  champsim::chrono::clock global_clock{};
+  long window_count = 0;
+  bool done = false;
+
+public:
+  using trace_opener = std::function<tracereader(std::size_t)>;
+
+private:
+  trace_opener open_trace;
+  std::vector<int> open_sockets;
+  std::vector<int> branches;
+
+  std::string run_window(std::string_view name, bool is_warmup, long long length);
+  std::string skip(uint64_t count);
+  std::string select_module(std::string_view kind, std::string_view cache_name, std::string_view module_names);
+  std::string save(std::string_view path, std::string_view format);
+  std::string load(std::string_view path);
+  std::string snapshot(std::string_view path);
+  std::string restore(std::string_view path);
+  std::string branch(std::string_view socket_path);
+  void reap_children();
+
+public:
+  /**
+   * Initialize the environment for serving.
+   *
+   * :param env: The environment to simulate.
+   * :param traces: One trace per core. These must outlive the server.
+   * :param trace_names: The names of the traces, as reported in the statistics.
+   * :param open_trace: Opens a fresh copy of the trace with the given index. This is required by the ``branch`` command.
+   */
+  simulation_server(environment& env, std::vector<tracereader>& traces, std::vector<std::string> trace_names, trace_opener open_trace = {});
+
+  /**
+   * Execute a single command.
+   *
+   * :param command: One line of the protocol, without the newline.
+   * :returns: The JSON response, without a newline.
+   */
+  std::string execute(std::string_view command);
+
+  /**
+   * :returns: Whether the ``quit`` command has been received.
+   */
+  [[nodiscard]] bool finished() const { return done; }
+
+  /**
+   * Serve commands from an input stream until it ends or the server is finished, writing each response on its own line.
+   */
+  void serve(std::istream& input, std::ostream& output);
+
+  /**
+   * Listen on a Unix domain socket and serve one client at a time until the server is finished.
+   * The socket file is removed when serving ends.
+   */
+  void serve_unix_socket(const std::string& socket_path);
+};
+} // namespace champsim
+
+#endif
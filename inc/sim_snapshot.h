@@ -0,0 +1,54 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIM_SNAPSHOT_H
+#define SIM_SNAPSHOT_H
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+
+namespace champsim
+{
+class environment;
+
+namespace snapshot
+{
+inline constexpr char magic[8] = {'C', 'S', 'S', 'N', 'A', 'P', '\0', '\0'};
+inline constexpr uint32_t version = 1;
+} // namespace snapshot
+
+/**
+ * Write the microarchitectural state of the whole simulator: the cores and their predictors, the caches and their modules, the page table walkers,
+ * the virtual memory, and the DRAM row buffers.
+ *
+ * The snapshot holds one section per component in the order of ``environment::operable_view()``, followed by one section per distinct virtual memory.
+ * Requests in flight are not saved, so a restored simulation begins with empty queues.
+ * The state is only meaningful to a binary built with the same configuration.
+ */
+void save_snapshot(environment& env, std::ostream& stream);
+void save_snapshot(environment& env, const std::filesystem::path& file_path);
+
+/**
+ * Restore a snapshot written by save_snapshot().
+ *
+ * :throws std::runtime_error: if the snapshot does not match the configuration of the environment.
+ */
+void load_snapshot(environment& env, std::istream& stream);
+void load_snapshot(environment& env, const std::filesystem::path& file_path);
+} // namespace champsim
+
+#endif
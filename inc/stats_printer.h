@@ -16,6 +16,7 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cache.h"
@@ -46,6 +47,12 @@ class json_printer
 
 public:
   json_printer(std::ostream& str) : stream(str) {}
+  void print(phase_stats& stats);
   void print(std::vector<phase_stats>& stats);
+
+  /**
+   * Print the statistics of several variants of one simulation, each labelled with the module selections that distinguish it.
+   */
+  void print(std::vector<std::pair<std::string, std::vector<phase_stats>>>& variants);
 };
 } // namespace champsim
@@ -17,10 +17,13 @@
 #ifndef TRACEREADER_H
 #define TRACEREADER_H
 
+#include <array>
 #include <cstring>
 #include <deque>
+#include <istream>
 #include <memory>
 #include <numeric>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 
@@ -35,6 +38,7 @@ class tracereader
   struct reader_concept {
     virtual ~reader_concept() = default;
     virtual ooo_model_instr operator()() = 0;
+    virtual uint64_t skip(uint64_t count) = 0;
     [[nodiscard]] virtual bool eof() const = 0;
   };
 
@@ -46,7 +50,25 @@ class tracereader
     template <typename U>
     using has_eof = decltype(std::declval<U>().eof());
 
+    template <typename U>
+    using has_skip = decltype(std::declval<U>().skip(std::declval<uint64_t>()));
+
     ooo_model_instr operator()() override { return intern_(); }
+
+    uint64_t skip(uint64_t count) override
+    {
+      if constexpr (champsim::is_detected_v<has_skip, T>) {
+        return intern_.skip(count);
+      } else {
+        // If a skip() member function is not provided, read and drop each instruction.
+        uint64_t skipped = 0;
+        for (; skipped < count && !eof(); ++skipped) {
+          static_cast<void>(intern_());
+        }
+        return skipped;
+      }
+    }
+
     [[nodiscard]] bool eof() const override
     {
       if constexpr (champsim::is_detected_v<has_eof, T>) {
@@ -57,6 +79,8 @@ class tracereader
   };
 
   std::unique_ptr<reader_concept> pimpl_;
+  uint64_t position_ = 0;
+  uint64_t* next_instr_id_ = &instr_unique_id;
 
 public:
   template <typename T, std::enable_if_t<!std::is_same_v<tracereader, T>, bool> = true>
@@ -67,13 +91,97 @@ public:
   auto operator()()
   {
     auto retval = (*pimpl_)();
-    retval.instr_id = instr_unique_id++;
+    retval.instr_id = (*next_instr_id_)++;
+    ++position_;
     return retval;
   }
 
+  /**
+   * Advance past the next count instructions without simulating them.
+   *
+   * :returns: The number of instructions skipped, which is smaller than count only if the trace ended.
+   */
+  auto skip(uint64_t count)
+  {
+    auto skipped = pimpl_->skip(count);
+    *next_instr_id_ += skipped;
+    position_ += skipped;
+    return skipped;
+  }
+
+  /**
+   * Draw instruction IDs from the given counter, rather than the one that every reader in the process shares.
+   * The readers of one simulation must draw from the same counter, which must outlive them.
+   */
+  void use_instr_ids(uint64_t& counter) { next_instr_id_ = &counter; }
+
+  /**
+   * :returns: The counter from which this reader draws instruction IDs.
+   */
+  [[nodiscard]] uint64_t& instr_id_counter() const { return *next_instr_id_; }
+
+  /**
+   * :returns: The number of instructions read or skipped from this trace so far.
+   */
+  [[nodiscard]] auto position() const { return position_; }
+
+  /**
+   * Replace the source of this trace with a freshly opened copy of it, advanced to the current position.
+   * Instruction IDs continue from where they were. This is needed after fork(), because the file offsets are shared with the parent.
+   */
+  void reopen(tracereader&& fresh)
+  {
+    if (fresh.pimpl_->skip(position_) != position_) {
+      throw std::runtime_error("The reopened trace ended before the current position");
+    }
+    pimpl_ = std::move(fresh.pimpl_);
+  }
+
   [[nodiscard]] auto eof() const { return pimpl_->eof(); }
 };
 
+namespace detail
+{
+template <typename F>
+using has_ignore_bytes = decltype(std::declval<F>().ignore_bytes(std::declval<uint64_t>()));
+
+/**
+ * Drop the next count bytes of the file, seeking over them where the file allows it.
+ *
+ * :returns: The number of bytes dropped.
+ */
+template <typename F>
+uint64_t discard_bytes(F& file, uint64_t count)
+{
+  if constexpr (champsim::is_detected_v<has_ignore_bytes, F>) {
+    return file.ignore_bytes(count);
+  } else {
+    if constexpr (std::is_base_of_v<std::istream, F>) {
+      if (auto start = file.tellg(); start != std::streampos{-1}) {
+        file.seekg(0, std::ios::end);
+        auto available = static_cast<uint64_t>(file.tellg() - start);
+        file.seekg(start);
+        if (available <= count) {
+          file.seekg(0, std::ios::end);
+          file.setstate(std::ios::eofbit | std::ios::failbit);
+          return available;
+        }
+        file.seekg(static_cast<std::streamoff>(count), std::ios::cur);
+        return count;
+      }
+    }
+
+    std::array<char, 1 << 16> scratch;
+    uint64_t discarded = 0;
+    while (discarded < count && !file.eof()) {
+      file.read(std::data(scratch), static_cast<std::streamsize>(std::min<uint64_t>(std::size(scratch), count - discarded)));
+      discarded += static_cast<uint64_t>(file.gcount());
+    }
+    return discarded;
+  }
+}
+} // namespace detail
+
 template <typename T, typename F>
 class bulk_tracereader
 {
@@ -88,9 +196,17 @@ class bulk_tracereader
   constexpr static std::size_t refresh_thresh = 1;
   std::deque<ooo_model_instr> instr_buffer;
 
+  void refill();
+
 public:
   ooo_model_instr operator()();
 
+  /**
+   * Skip the next count instructions. Instructions that have not yet been read from the file are discarded as raw records,
+   * and are never inflated into ooo_model_instr.
+   */
+  uint64_t skip(uint64_t count);
+
   bulk_tracereader(uint8_t cpu_idx, std::string tf) : cpu(cpu_idx), trace_file(tf) {}
   bulk_tracereader(uint8_t cpu_idx, F&& file) : cpu(cpu_idx), trace_file(std::move(file)) {}
 
@@ -108,28 +224,34 @@ void set_branch_targets(It begin, It end)
 }
 
 template <typename T, typename F>
-ooo_model_instr bulk_tracereader<T, F>::operator()()
+void bulk_tracereader<T, F>::refill()
 {
-  if (std::size(instr_buffer) <= refresh_thresh) {
-    std::array<T, buffer_size - refresh_thresh> trace_read_buf;
-    std::array<char, std::size(trace_read_buf) * sizeof(T)> raw_buf;
-    std::size_t bytes_read;
+  std::array<T, buffer_size - refresh_thresh> trace_read_buf;
+  std::array<char, std::size(trace_read_buf) * sizeof(T)> raw_buf;
+  std::size_t bytes_read;
+
+  // Read from trace file
+  trace_file.read(std::data(raw_buf), std::size(raw_buf));
+  bytes_read = static_cast<std::size_t>(trace_file.gcount());
+  eof_ = trace_file.eof();
 
-    // Read from trace file
-    trace_file.read(std::data(raw_buf), std::size(raw_buf));
-    bytes_read = static_cast<std::size_t>(trace_file.gcount());
-    eof_ = trace_file.eof();
+  // Transform bytes into trace format instructions
+  std::memcpy(std::data(trace_read_buf), std::data(raw_buf), bytes_read);
 
-    // Transform bytes into trace format instructions
-    std::memcpy(std::data(trace_read_buf), std::data(raw_buf), bytes_read);
+  // Inflate trace format into core model instructions
+  auto begin = std::begin(trace_read_buf);
+  auto end = std::next(begin, bytes_read / sizeof(T));
+  std::transform(begin, end, std::back_inserter(instr_buffer), [cpu = this->cpu](T t) { return ooo_model_instr{cpu, t}; });
 
-    // Inflate trace format into core model instructions
-    auto begin = std::begin(trace_read_buf);
-    auto end = std::next(begin, bytes_read / sizeof(T));
-    std::transform(begin, end, std::back_inserter(instr_buffer), [cpu = this->cpu](T t) { return ooo_model_instr{cpu, t}; });
+  // Set branch targets
+  set_branch_targets(std::begin(instr_buffer), std::end(instr_buffer));
+}
 
-    // Set branch targets
-    set_branch_targets(std::begin(instr_buffer), std::end(instr_buffer));
+template <typename T, typename F>
+ooo_model_instr bulk_tracereader<T, F>::operator()()
+{
+  if (std::size(instr_buffer) <= refresh_thresh) {
+    refill();
   }
 
   auto retval = instr_buffer.front();
@@ -138,9 +260,35 @@ ooo_model_instr bulk_tracereader<T, F>::operator()()
   return retval;
 }
 
+template <typename T, typename F>
+uint64_t bulk_tracereader<T, F>::skip(uint64_t count)
+{
+  // Drop instructions that were already inflated
+  auto from_buffer = std::min<uint64_t>(count, std::size(instr_buffer));
+  instr_buffer.erase(std::begin(instr_buffer), std::next(std::begin(instr_buffer), static_cast<typename decltype(instr_buffer)::difference_type>(from_buffer)));
+  if (from_buffer == count) {
+    return count;
+  }
+
+  auto bytes_dropped = detail::discard_bytes(trace_file, (count - from_buffer) * sizeof(T));
+  eof_ = trace_file.eof();
+
+  // Read ahead so that eof() is accurate for the next instruction
+  refill();
+
+  return from_buffer + bytes_dropped / sizeof(T);
+}
+
 std::string get_fptr_cmd(std::string_view fname);
 } // namespace champsim
 
 champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool repeat);
 
+/**
+ * Open a trace, decompressing it on a separate thread.
+ *
+ * :param read_ahead: The number of batches of instructions that may be read ahead of the simulation. If zero, the trace is read on the calling thread.
+ */
+champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool repeat, std::size_t read_ahead);
+
 #endif
@@ -0,0 +1,341 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_CIRCULAR_BUFFER_H
+#define UTIL_CIRCULAR_BUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace champsim
+{
+/**
+ * A double-ended queue held in a single allocation, whose elements are constructed in place.
+ *
+ * The capacity is reserved when the buffer is created. Popping an element never allocates, and a push allocates only when it goes past the
+ * current capacity. Unlike a bounded queue, such a push grows the buffer to twice its capacity rather than failing. O3_CPU reserves each of its
+ * buffers from the sizes given to its core_builder and checks the occupancy of a buffer before it pushes, so the pipeline never grows one.
+ */
+template <typename T>
+class circular_buffer
+{
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+
+private:
+  template <bool is_const>
+  class iterator_type
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<is_const, const T*, T*>;
+    using reference = std::conditional_t<is_const, const T&, T&>;
+
+  private:
+    using buffer_type = std::conditional_t<is_const, const circular_buffer, circular_buffer>;
+    buffer_type* buffer = nullptr;
+    difference_type index = 0; // the position relative to the front of the buffer
+
+    friend class circular_buffer;
+    friend class iterator_type<!is_const>;
+
+  public:
+    iterator_type() = default;
+    iterator_type(buffer_type* buf, difference_type idx) : buffer(buf), index(idx) {}
+
+    template <bool other_const, std::enable_if_t<is_const && !other_const, bool> = true>
+    iterator_type(iterator_type<other_const> other) : buffer(other.buffer), index(other.index) // NOLINT(google-explicit-constructor)
+    {
+    }
+
+    reference operator*() const { return (*buffer)[static_cast<size_type>(index)]; }
+    pointer operator->() const { return &(**this); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    iterator_type& operator++()
+    {
+      ++index;
+      return *this;
+    }
+    iterator_type operator++(int)
+    {
+      auto retval = *this;
+      ++index;
+      return retval;
+    }
+    iterator_type& operator--()
+    {
+      --index;
+      return *this;
+    }
+    iterator_type operator--(int)
+    {
+      auto retval = *this;
+      --index;
+      return retval;
+    }
+    iterator_type& operator+=(difference_type n)
+    {
+      index += n;
+      return *this;
+    }
+    iterator_type& operator-=(difference_type n)
+    {
+      index -= n;
+      return *this;
+    }
+
+    friend iterator_type operator+(iterator_type it, difference_type n) { return it += n; }
+    friend iterator_type operator+(difference_type n, iterator_type it) { return it += n; }
+    friend iterator_type operator-(iterator_type it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const iterator_type& lhs, const iterator_type& rhs) { return lhs.index - rhs.index; }
+
+    friend bool operator==(const iterator_type& lhs, const iterator_type& rhs) { return lhs.index == rhs.index; }
+    friend bool operator!=(const iterator_type& lhs, const iterator_type& rhs) { return lhs.index != rhs.index; }
+    friend bool operator<(const iterator_type& lhs, const iterator_type& rhs) { return lhs.index < rhs.index; }
+    friend bool operator>(const iterator_type& lhs, const iterator_type& rhs) { return lhs.index > rhs.index; }
+    friend bool operator<=(const iterator_type& lhs, const iterator_type& rhs) { return lhs.index <= rhs.index; }
+    friend bool operator>=(const iterator_type& lhs, const iterator_type& rhs) { return lhs.index >= rhs.index; }
+  };
+
+  std::allocator<T> m_alloc{};
+  T* m_data = nullptr;
+  size_type m_capacity = 0; // always a power of two, or zero
+  size_type m_head = 0;
+  size_type m_size = 0;
+
+  [[nodiscard]] T* slot(size_type pos) const { return m_data + ((m_head + pos) & (m_capacity - 1)); }
+
+  void grow_to(size_type new_capacity)
+  {
+    circular_buffer grown{new_capacity};
+    for (auto& x : *this) {
+      grown.push_back(std::move_if_noexcept(x));
+    }
+    swap(grown);
+  }
+
+  void grow_for_push()
+  {
+    if (m_size == m_capacity) {
+      grow_to(std::max<size_type>(1, 2 * m_capacity));
+    }
+  }
+
+public:
+  using iterator = iterator_type<false>;
+  using const_iterator = iterator_type<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  circular_buffer() = default;
+
+  /**
+   * :param capacity: The number of elements that may be held without allocating. It is rounded up to a power of two.
+   */
+  explicit circular_buffer(size_type capacity)
+  {
+    if (capacity > 0) {
+      m_capacity = 1;
+      while (m_capacity < capacity) {
+        m_capacity *= 2;
+      }
+      m_data = m_alloc.allocate(m_capacity);
+    }
+  }
+
+  circular_buffer(const circular_buffer& other) : circular_buffer(other.m_capacity)
+  {
+    for (const auto& x : other) {
+      push_back(x);
+    }
+  }
+
+  circular_buffer(circular_buffer&& other) noexcept
+      : m_data(std::exchange(other.m_data, nullptr)), m_capacity(std::exchange(other.m_capacity, 0)), m_head(std::exchange(other.m_head, 0)),
+        m_size(std::exchange(other.m_size, 0))
+  {
+  }
+
+  circular_buffer& operator=(const circular_buffer& other)
+  {
+    if (this != &other) {
+      circular_buffer copy{other};
+      swap(copy);
+    }
+    return *this;
+  }
+
+  circular_buffer& operator=(circular_buffer&& other) noexcept
+  {
+    circular_buffer moved{std::move(other)};
+    swap(moved);
+    return *this;
+  }
+
+  ~circular_buffer()
+  {
+    clear();
+    if (m_data != nullptr) {
+      m_alloc.deallocate(m_data, m_capacity);
+    }
+  }
+
+  void swap(circular_buffer& other) noexcept
+  {
+    std::swap(m_data, other.m_data);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(m_head, other.m_head);
+    std::swap(m_size, other.m_size);
+  }
+
+  [[nodiscard]] size_type size() const { return m_size; }
+  [[nodiscard]] bool empty() const { return m_size == 0; }
+  [[nodiscard]] size_type capacity() const { return m_capacity; }
+
+  /**
+   * Ensure that the buffer can hold the given number of elements without allocating.
+   */
+  void reserve(size_type new_capacity)
+  {
+    if (new_capacity > m_capacity) {
+      grow_to(new_capacity);
+    }
+  }
+
+  reference operator[](size_type pos) { return *slot(pos); }
+  const_reference operator[](size_type pos) const { return *slot(pos); }
+
+  reference at(size_type pos)
+  {
+    if (pos >= m_size) {
+      throw std::out_of_range{"circular_buffer::at"};
+    }
+    return (*this)[pos];
+  }
+
+  const_reference at(size_type pos) const
+  {
+    if (pos >= m_size) {
+      throw std::out_of_range{"circular_buffer::at"};
+    }
+    return (*this)[pos];
+  }
+
+  reference front() { return (*this)[0]; }
+  const_reference front() const { return (*this)[0]; }
+  reference back() { return (*this)[m_size - 1]; }
+  const_reference back() const { return (*this)[m_size - 1]; }
+
+  iterator begin() { return iterator{this, 0}; }
+  iterator end() { return iterator{this, static_cast<difference_type>(m_size)}; }
+  const_iterator begin() const { return const_iterator{this, 0}; }
+  const_iterator end() const { return const_iterator{this, static_cast<difference_type>(m_size)}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+  reverse_iterator rbegin() { return reverse_iterator{end()}; }
+  reverse_iterator rend() { return reverse_iterator{begin()}; }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator{end()}; }
+  const_reverse_iterator rend() const { return const_reverse_iterator{begin()}; }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args)
+  {
+    grow_for_push();
+    auto* place = slot(m_size);
+    ::new (static_cast<void*>(place)) T(std::forward<Args>(args)...);
+    ++m_size;
+    return *place;
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void pop_front()
+  {
+    std::destroy_at(slot(0));
+    m_head = (m_head + 1) & (m_capacity - 1);
+    --m_size;
+  }
+
+  void pop_back()
+  {
+    std::destroy_at(slot(m_size - 1));
+    --m_size;
+  }
+
+  void clear()
+  {
+    while (!empty()) {
+      pop_back();
+    }
+    m_head = 0;
+  }
+
+  /**
+   * Remove the elements in the range. Removing from the front of the buffer moves no other elements.
+   */
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    const auto first_idx = first.index;
+    const auto count = last.index - first.index;
+    if (first_idx == 0) {
+      for (difference_type i = 0; i < count; ++i) {
+        pop_front();
+      }
+    } else {
+      std::move(begin() + last.index, end(), begin() + first_idx);
+      for (difference_type i = 0; i < count; ++i) {
+        pop_back();
+      }
+    }
+    return begin() + first_idx;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  /**
+   * Insert copies of the elements in the range before the given position.
+   */
+  template <typename InputIt>
+  iterator insert(const_iterator pos, InputIt first, InputIt last)
+  {
+    const auto pos_idx = pos.index;
+    const auto old_size = static_cast<difference_type>(m_size);
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+    std::rotate(begin() + pos_idx, begin() + old_size, end());
+    return begin() + pos_idx;
+  }
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_FLAT_HASH_MAP_H
+#define UTIL_FLAT_HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace champsim
+{
+namespace serialization
+{
+class input_archive;
+}
+
+/**
+ * A hash map for keys that are inserted but never erased, held in two flat arrays.
+ *
+ * The entries are held contiguously, in the order in which they were inserted, and are visited in that order. A table of positions into the
+ * entries is probed linearly, and is kept at most half full. Iterators and references are invalidated by any insertion.
+ *
+ * The map is written to a checkpoint as a sequence of its entries, so the bytes written depend only on the order of insertion.
+ */
+template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class flat_hash_map
+{
+public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using size_type = std::size_t;
+  using iterator = typename std::vector<value_type>::iterator;
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+
+private:
+  constexpr static size_type empty_slot = 0; // slots hold the position of their entry plus one
+
+  std::vector<value_type> entries{};
+  std::vector<size_type> slots{};
+  Hash hasher{};
+  KeyEqual key_eq{};
+
+  [[nodiscard]] size_type home_slot(const Key& key) const
+  {
+    // Spread the hash over the high bits, so that hashes that differ only in their upper bits do not share a slot
+    constexpr uint64_t golden_ratio = 0x9e3779b97f4a7c15ULL;
+    return static_cast<size_type>((static_cast<uint64_t>(hasher(key)) * golden_ratio) >> 32) & (std::size(slots) - 1);
+  }
+
+  // The slot that holds the key, or the empty slot where it would be placed
+  [[nodiscard]] size_type probe(const Key& key) const
+  {
+    auto slot = home_slot(key);
+    while (slots[slot] != empty_slot && !key_eq(entries[slots[slot] - 1].first, key)) {
+      slot = (slot + 1) & (std::size(slots) - 1);
+    }
+    return slot;
+  }
+
+  void rehash(size_type slot_count)
+  {
+    slots.assign(slot_count, empty_slot);
+    for (size_type pos = 0; pos < std::size(entries); ++pos) {
+      slots[probe(entries[pos].first)] = pos + 1;
+    }
+  }
+
+public:
+  flat_hash_map() = default;
+
+  [[nodiscard]] size_type size() const { return std::size(entries); }
+  [[nodiscard]] bool empty() const { return std::empty(entries); }
+
+  iterator begin() { return std::begin(entries); }
+  iterator end() { return std::end(entries); }
+  const_iterator begin() const { return std::begin(entries); }
+  const_iterator end() const { return std::end(entries); }
+  const_iterator cbegin() const { return std::cbegin(entries); }
+  const_iterator cend() const { return std::cend(entries); }
+
+  void clear()
+  {
+    entries.clear();
+    slots.clear();
+  }
+
+  /**
+   * Allocate enough space to hold the given number of entries without rehashing.
+   */
+  void reserve(size_type count)
+  {
+    entries.reserve(count);
+    size_type slot_count = 16;
+    while (slot_count < 2 * count) {
+      slot_count *= 2;
+    }
+    if (slot_count > std::size(slots)) {
+      rehash(slot_count);
+    }
+  }
+
+  iterator find(const Key& key)
+  {
+    if (std::empty(slots)) {
+      return end();
+    }
+    auto slot = slots[probe(key)];
+    return slot == empty_slot ? end() : std::next(begin(), static_cast<typename iterator::difference_type>(slot - 1));
+  }
+
+  const_iterator find(const Key& key) const
+  {
+    if (std::empty(slots)) {
+      return end();
+    }
+    auto slot = slots[probe(key)];
+    return slot == empty_slot ? end() : std::next(begin(), static_cast<typename const_iterator::difference_type>(slot - 1));
+  }
+
+  [[nodiscard]] size_type count(const Key& key) const { return find(key) == end() ? 0 : 1; }
+
+  /**
+   * Insert an entry constructed from the given arguments, if the key is not already present.
+   *
+   * :returns: A pair of an iterator to the entry with the key, and whether it was inserted.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+  {
+    if (2 * (std::size(entries) + 1) > std::size(slots)) {
+      reserve(std::size(entries) + 1);
+    }
+
+    auto slot = probe(key);
+    if (slots[slot] != empty_slot) {
+      return {std::next(begin(), static_cast<typename iterator::difference_type>(slots[slot] - 1)), false};
+    }
+
+    entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    slots[slot] = std::size(entries);
+    return {std::prev(end()), true};
+  }
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(entries);
+    if constexpr (std::is_same_v<Archive, serialization::input_archive>) {
+      slots.clear();
+      reserve(std::size(entries));
+    }
+  }
+};
+} // namespace champsim
+
+#endif
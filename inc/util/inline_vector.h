@@ -0,0 +1,167 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_INLINE_VECTOR_H
+#define UTIL_INLINE_VECTOR_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace champsim
+{
+/**
+ * A sequence of at most N elements, held within the object rather than in an allocation.
+ *
+ * The interface follows std::vector, except that the capacity is fixed. Pushing past the capacity throws std::length_error.
+ * All N elements are default-constructed, so an inline_vector of a trivially copyable type is itself trivially copyable.
+ */
+template <typename T, std::size_t N>
+class inline_vector
+{
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+  std::array<T, N> m_data{};
+  size_type m_size = 0;
+
+  void check_room(size_type count) const
+  {
+    if (count > N) {
+      throw std::length_error{"inline_vector cannot hold more elements than its capacity"};
+    }
+  }
+
+public:
+  inline_vector() = default;
+
+  inline_vector(std::initializer_list<T> init)
+  {
+    check_room(std::size(init));
+    std::copy(std::begin(init), std::end(init), std::begin(m_data));
+    m_size = std::size(init);
+  }
+
+  template <typename InputIt>
+  inline_vector(InputIt first, InputIt last)
+  {
+    std::copy(first, last, std::back_inserter(*this));
+  }
+
+  iterator begin() { return std::data(m_data); }
+  iterator end() { return std::next(begin(), static_cast<difference_type>(m_size)); }
+  const_iterator begin() const { return std::data(m_data); }
+  const_iterator end() const { return std::next(begin(), static_cast<difference_type>(m_size)); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+  reverse_iterator rbegin() { return reverse_iterator{end()}; }
+  reverse_iterator rend() { return reverse_iterator{begin()}; }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator{end()}; }
+  const_reverse_iterator rend() const { return const_reverse_iterator{begin()}; }
+
+  [[nodiscard]] size_type size() const { return m_size; }
+  [[nodiscard]] bool empty() const { return m_size == 0; }
+  [[nodiscard]] constexpr static size_type capacity() { return N; }
+  [[nodiscard]] constexpr static size_type max_size() { return N; }
+
+  pointer data() { return std::data(m_data); }
+  const_pointer data() const { return std::data(m_data); }
+
+  reference operator[](size_type pos) { return m_data[pos]; }
+  const_reference operator[](size_type pos) const { return m_data[pos]; }
+
+  reference at(size_type pos)
+  {
+    if (pos >= m_size) {
+      throw std::out_of_range{"inline_vector index out of range"};
+    }
+    return m_data[pos];
+  }
+
+  const_reference at(size_type pos) const
+  {
+    if (pos >= m_size) {
+      throw std::out_of_range{"inline_vector index out of range"};
+    }
+    return m_data[pos];
+  }
+
+  reference front() { return m_data[0]; }
+  const_reference front() const { return m_data[0]; }
+  reference back() { return m_data[m_size - 1]; }
+  const_reference back() const { return m_data[m_size - 1]; }
+
+  void push_back(const T& value)
+  {
+    check_room(m_size + 1);
+    m_data[m_size++] = value;
+  }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args)
+  {
+    check_room(m_size + 1);
+    m_data[m_size] = T{std::forward<Args>(args)...};
+    return m_data[m_size++];
+  }
+
+  void pop_back() { --m_size; }
+
+  void clear() { m_size = 0; }
+
+  /**
+   * The capacity is fixed, so this only checks that the count fits.
+   */
+  void reserve(size_type count) const { check_room(count); }
+
+  void resize(size_type count)
+  {
+    check_room(count);
+    std::fill(std::next(begin(), static_cast<difference_type>(std::min(count, m_size))), std::next(begin(), static_cast<difference_type>(count)), T{});
+    m_size = count;
+  }
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    auto pos = std::next(begin(), std::distance(cbegin(), first));
+    auto new_end = std::move(std::next(begin(), std::distance(cbegin(), last)), end(), pos);
+    m_size = static_cast<size_type>(std::distance(begin(), new_end));
+    return pos;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  friend bool operator==(const inline_vector& lhs, const inline_vector& rhs) { return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+  friend bool operator!=(const inline_vector& lhs, const inline_vector& rhs) { return !(lhs == rhs); }
+};
+} // namespace champsim
+
+#endif
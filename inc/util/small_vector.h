@@ -0,0 +1,185 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_SMALL_VECTOR_H
+#define UTIL_SMALL_VECTOR_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace champsim
+{
+/**
+ * A sequence that holds up to N elements within the object, and moves them to an allocation only when it grows past that.
+ *
+ * The interface follows std::vector. The elements must be trivially copyable, so that they can be copied and moved as bytes.
+ * Copying a small_vector that has not grown past N elements never allocates.
+ */
+template <typename T, std::size_t N>
+class small_vector
+{
+  static_assert(std::is_trivially_copyable_v<T>, "The elements of a small_vector are copied as bytes");
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+private:
+  std::array<T, N> m_inline{};
+  std::unique_ptr<T[]> m_heap{}; // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+  size_type m_size = 0;
+  size_type m_capacity = N;
+
+  [[nodiscard]] bool is_inline() const { return m_heap == nullptr; }
+
+  void grow_to(size_type new_capacity)
+  {
+    auto grown = std::make_unique<T[]>(new_capacity); // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+    std::copy(begin(), end(), grown.get());
+    m_heap = std::move(grown);
+    m_capacity = new_capacity;
+  }
+
+public:
+  small_vector() = default;
+
+  small_vector(std::initializer_list<T> init) : small_vector(std::begin(init), std::end(init)) {}
+
+  template <typename InputIt>
+  small_vector(InputIt first, InputIt last)
+  {
+    std::copy(first, last, std::back_inserter(*this));
+  }
+
+  small_vector(const small_vector& other) : small_vector(std::begin(other), std::end(other)) {}
+
+  small_vector(small_vector&& other) noexcept : m_size(other.m_size)
+  {
+    if (other.is_inline()) {
+      std::copy(std::begin(other), std::end(other), std::begin(m_inline));
+    } else {
+      m_heap = std::move(other.m_heap);
+      m_capacity = std::exchange(other.m_capacity, N);
+    }
+    other.m_size = 0;
+  }
+
+  small_vector& operator=(const small_vector& other)
+  {
+    if (this != &other) {
+      clear();
+      reserve(std::size(other));
+      std::copy(std::begin(other), std::end(other), begin());
+      m_size = std::size(other);
+    }
+    return *this;
+  }
+
+  small_vector& operator=(small_vector&& other) noexcept
+  {
+    if (this != &other) {
+      if (other.is_inline()) {
+        std::copy(std::begin(other), std::end(other), begin());
+      } else {
+        m_heap = std::move(other.m_heap);
+        m_capacity = std::exchange(other.m_capacity, N);
+      }
+      m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+  }
+
+  ~small_vector() = default;
+
+  iterator begin() { return is_inline() ? std::data(m_inline) : m_heap.get(); }
+  iterator end() { return std::next(begin(), static_cast<difference_type>(m_size)); }
+  const_iterator begin() const { return is_inline() ? std::data(m_inline) : m_heap.get(); }
+  const_iterator end() const { return std::next(begin(), static_cast<difference_type>(m_size)); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  [[nodiscard]] size_type size() const { return m_size; }
+  [[nodiscard]] bool empty() const { return m_size == 0; }
+  [[nodiscard]] size_type capacity() const { return m_capacity; }
+
+  pointer data() { return begin(); }
+  const_pointer data() const { return begin(); }
+
+  reference operator[](size_type pos) { return begin()[pos]; }
+  const_reference operator[](size_type pos) const { return begin()[pos]; }
+
+  reference front() { return *begin(); }
+  const_reference front() const { return *begin(); }
+  reference back() { return *std::prev(end()); }
+  const_reference back() const { return *std::prev(end()); }
+
+  void reserve(size_type count)
+  {
+    if (count > m_capacity) {
+      grow_to(std::max(count, 2 * m_capacity));
+    }
+  }
+
+  void push_back(const T& value)
+  {
+    reserve(m_size + 1);
+    begin()[m_size++] = value;
+  }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args)
+  {
+    reserve(m_size + 1);
+    begin()[m_size] = T{std::forward<Args>(args)...};
+    return begin()[m_size++];
+  }
+
+  void pop_back() { --m_size; }
+
+  /**
+   * Remove every element. An allocation, if there is one, is kept for reuse.
+   */
+  void clear() { m_size = 0; }
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    auto pos = std::next(begin(), std::distance(cbegin(), first));
+    auto new_end = std::copy(std::next(begin(), std::distance(cbegin(), last)), end(), pos);
+    m_size = static_cast<size_type>(std::distance(begin(), new_end));
+    return pos;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  friend bool operator==(const small_vector& lhs, const small_vector& rhs) { return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+  friend bool operator!=(const small_vector& lhs, const small_vector& rhs) { return !(lhs == rhs); }
+};
+} // namespace champsim
+
+#endif
@@ -18,14 +18,17 @@
 #define VMEM_H
 
 #include <cstdint>
-#include <deque>
-#include <map>
 #include <optional>
 #include <random>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 
 #include "address.h"
 #include "champsim.h"
 #include "chrono.h"
+#include "serialization.h"
+#include "util/flat_hash_map.h"
 
 class MEMORY_CONTROLLER;
 
@@ -34,8 +37,23 @@ using pte_entry = champsim::data::size<long long, std::ratio<8>>;
 class VirtualMemory
 {
 private:
-  std::map<std::pair<uint32_t, champsim::page_number>, champsim::page_number> vpage_to_ppage_map;
-  std::map<std::tuple<uint32_t, uint32_t, champsim::address_slice<champsim::dynamic_extent>>, champsim::address> page_table;
+  // Keyed by the address space and the virtual page
+  using vpage_key_type = std::pair<uint32_t, champsim::page_number>;
+  struct vpage_key_hash {
+    std::size_t operator()(const vpage_key_type& key) const { return std::hash<uint64_t>{}(key.second.to<uint64_t>() ^ (uint64_t{key.first} << 48)); }
+  };
+
+  // Keyed by the address space, the level, and the bits of the virtual page above that level. The extent of those bits is determined by the level.
+  using pte_key_type = std::tuple<uint32_t, uint32_t, uint64_t>;
+  struct pte_key_hash {
+    std::size_t operator()(const pte_key_type& key) const
+    {
+      return std::hash<uint64_t>{}(std::get<2>(key) ^ (uint64_t{std::get<1>(key)} << 56) ^ (uint64_t{std::get<0>(key)} << 48));
+    }
+  };
+
+  champsim::flat_hash_map<vpage_key_type, champsim::page_number, vpage_key_hash> vpage_to_ppage_map;
+  champsim::flat_hash_map<pte_key_type, champsim::address, pte_key_hash> page_table;
   std::optional<uint64_t> randomization_seed;
   MEMORY_CONTROLLER& dram;
 
@@ -45,7 +63,14 @@ public:
   const pte_entry pte_page_size; // Size of a PTE page
 
 private:
-  std::deque<champsim::page_number> ppage_free_list;
+  // The physical pages are handed out in a random order, which is drawn one page at a time as a Fisher-Yates shuffle.
+  // Only the positions of the order that have been swapped past, but not yet handed out, are stored.
+  champsim::page_number first_ppage{};
+  std::size_t num_ppages = 0;
+  std::size_t num_allocated_ppages = 0;
+  champsim::page_number next_ppage{};
+  std::unordered_map<std::size_t, std::size_t> ppage_swaps{};
+  std::mt19937_64 ppage_rng{};
   champsim::page_number active_pte_page{};
   champsim::address_slice<champsim::dynamic_extent> next_pte_page;
 
@@ -55,7 +80,7 @@ private:
   [[nodiscard]] champsim::page_number ppage_front() const;
   void ppage_pop();
 
-  void shuffle_pages();
+  void draw_ppage();
   void populate_pages();
 
 public:
@@ -118,6 +143,16 @@ public:
    * :returns: A pair of the page table page address and the latency to be applied to the operation.
    */
   std::pair<champsim::address, champsim::chrono::clock::duration> get_pte_pa(uint32_t cpu_num, champsim::page_number vaddr, std::size_t level);
+
+  /**
+   * Write the page mappings and the position in the physical page allocation order.
+   */
+  void save_state(champsim::serialization::output_archive& ar) const;
+
+  /**
+   * Restore state written by save_state(). The virtual memory must have the same configuration and randomization seed as the one that was saved.
+   */
+  void load_state(champsim::serialization::input_archive& ar);
 };
 
 #endif
@@ -0,0 +1,105 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef XZ_STREAM_H
+#define XZ_STREAM_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "inf_stream.h"
+
+namespace champsim
+{
+/**
+ * A restart point for the decompressor: the start of one block in an .xz file.
+ */
+struct xz_block_info {
+  uint64_t compressed_offset;
+  uint64_t uncompressed_offset;
+  lzma_check check;
+};
+
+/**
+ * Read the block boundaries of an .xz file from the index that every .xz stream carries in its footer.
+ * Only the footer and the index are read, not the compressed data.
+ *
+ * :returns: The non-empty blocks of the file in order, or an empty optional if the file could not be indexed.
+ */
+std::optional<std::vector<xz_block_info>> read_xz_index(const std::string& fname);
+
+/**
+ * An input stream that decodes an .xz file one block at a time, beginning at an arbitrary block.
+ */
+class xz_block_istream
+{
+  std::ifstream file;
+  std::vector<xz_block_info> blocks;
+  std::size_t next_block;
+
+  decomp_tags::lzma_tag_t<>::inflate_state_type strm{new lzma_stream{}};
+  std::unique_ptr<lzma_block> block = std::make_unique<lzma_block>(); // The decoder refers to this until the block ends
+  std::vector<uint8_t> in_buf = std::vector<uint8_t>(1 << 16);
+  bool block_open = false;
+  bool eof_ = false;
+  std::streamsize gcount_ = 0;
+
+  bool open_next_block();
+
+public:
+  xz_block_istream(const std::string& fname, std::vector<xz_block_info> blocks, std::size_t first_block);
+
+  xz_block_istream& read(char* s, std::streamsize count);
+  [[nodiscard]] bool eof() const { return eof_; }
+  [[nodiscard]] std::streamsize gcount() const { return gcount_; }
+};
+
+/**
+ * An .xz input stream that can skip forward without decompressing the skipped data, as far as the block structure of the file allows.
+ * It reads sequentially like inf_istream until asked to skip, after which it restarts at the last block boundary before the target.
+ * A file with a single block, as xz writes by default, cannot be skipped without decompressing it; a warning is printed on the first skip.
+ */
+class seekable_xz_istream
+{
+  std::string fname;
+  std::variant<inf_istream<decomp_tags::lzma_tag_t<>>, xz_block_istream> stream;
+  std::optional<std::optional<std::vector<xz_block_info>>> index;
+  uint64_t position = 0;
+  bool warned_unseekable = false;
+
+public:
+  explicit seekable_xz_istream(std::string s);
+
+  seekable_xz_istream& read(char* s, std::streamsize count);
+  [[nodiscard]] bool eof() const;
+  [[nodiscard]] std::streamsize gcount() const;
+
+  /**
+   * Discard the next count bytes of uncompressed data.
+   *
+   * :returns: The number of bytes discarded, which is smaller than count only if the end of the file was reached.
+   */
+  uint64_t ignore_bytes(uint64_t count);
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""
+Read ChampSim commit traces (produced by --commit-trace) in any of the formats ChampSim writes.
+
+  csv: a header line, then one line of decimal integers per committed instruction
+  bin: headerless rows of eight little-endian 64-bit unsigned integers, in the column order of COLUMNS
+  npy: the rows of bin, as a NumPy array of shape (N, 8)
+
+A ".xz" suffix marks a compressed csv or bin trace. Uncompressed bin and npy traces are mapped into memory
+rather than read, so that a trace much larger than memory can be sliced.
+"""
+
+from __future__ import annotations
+
+import csv
+import io
+import lzma
+from pathlib import Path
+
+import numpy as np
+
+COLUMNS = (
+    "pc",
+    "memory_address",
+    "opcode",
+    "source_register1",
+    "source_register2",
+    "destination_register1",
+    "commit_cycle",
+    "delta_cycles",
+)
+
+_ROW_DTYPE = np.dtype("<u8")
+
+
+def _parse_int(x: str) -> int:
+    x = x.strip()
+    if x == "":
+        return 0
+    return int(x, 0)
+
+
+def _read_csv(f: io.TextIOBase, path: Path) -> np.ndarray:
+    reader = csv.DictReader(f)
+    if reader.fieldnames is None:
+        raise ValueError(f"missing CSV header in {path}")
+    missing = [c for c in COLUMNS if c not in reader.fieldnames]
+    if missing:
+        raise ValueError(f"missing columns {missing} in {path}; available={reader.fieldnames}")
+    rows = [[_parse_int(row[c]) for c in COLUMNS] for row in reader]
+    return np.asarray(rows, dtype=np.uint64).reshape((-1, len(COLUMNS)))
+
+
+def _from_bytes(data: bytes, path: Path) -> np.ndarray:
+    if len(data) % (_ROW_DTYPE.itemsize * len(COLUMNS)) != 0:
+        raise ValueError(f"{path} does not hold a whole number of records")
+    return np.frombuffer(data, dtype=_ROW_DTYPE).reshape((-1, len(COLUMNS)))
+
+
+def load_commit_trace(path: str | Path) -> np.ndarray:
+    """
+    Return the records of a commit trace as an array of shape (N, 8) and unsigned 64-bit type, whose columns are COLUMNS.
+    Uncompressed bin and npy traces are returned as read-only memory maps.
+    """
+    path = Path(path)
+    suffixes = path.suffixes
+    compressed = bool(suffixes) and suffixes[-1] == ".xz"
+    fmt = suffixes[-2] if compressed and len(suffixes) > 1 else (suffixes[-1] if suffixes else "")
+
+    if fmt == ".npy":
+        if compressed:
+            raise ValueError(f"{path}: ChampSim does not compress .npy traces")
+        arr = np.load(path, mmap_mode="r")
+        if arr.ndim != 2 or arr.shape[1] != len(COLUMNS):
+            raise ValueError(f"{path} has shape {arr.shape}, expected (N, {len(COLUMNS)})")
+        return arr
+
+    if fmt == ".bin":
+        if compressed:
+            with lzma.open(path, "rb") as f:
+                return _from_bytes(f.read(), path)
+        if path.stat().st_size == 0:
+            return np.empty((0, len(COLUMNS)), dtype=_ROW_DTYPE)
+        if path.stat().st_size % (_ROW_DTYPE.itemsize * len(COLUMNS)) != 0:
+            raise ValueError(f"{path} does not hold a whole number of records")
+        return np.memmap(path, dtype=_ROW_DTYPE, mode="r").reshape((-1, len(COLUMNS)))
+
+    if compressed:
+        with lzma.open(path, "rt", newline="") as f:
+            return _read_csv(f, path)
+    with path.open("r", newline="") as f:
+        return _read_csv(f, path)
@@ -1,11 +1,13 @@
 #!/usr/bin/env python3
 """
-Parse ChampSim commit-trace CSV (produced by --commit-trace) into input.npy/output.npy.
+Parse ChampSim commit traces (produced by --commit-trace) into input.npy/output.npy.
 
 Default columns match the NeuroScalar-style feature set:
   inputs: pc, memory_address, opcode, source_register1, source_register2, destination_register1
   target: delta_cycles
 
+Traces may be in any --commit-trace-format (csv, bin, npy), optionally xz-compressed; see commit_trace.py.
+Binary and NumPy traces are mapped into memory, so only the selected columns and rows are copied.
 The CSV values are written as decimal integers by ChampSim, but this parser also accepts
 hex strings like "0x400123" (via int(x, 0)).
 """
@@ -13,27 +15,19 @@ hex strings like "0x400123" (via int(x, 0)).
 from __future__ import annotations
 
 import argparse
-import csv
 import glob
+import sys
 from pathlib import Path
-from typing import Iterable
-
-
-def _parse_int(x: str) -> int:
-    x = x.strip()
-    if x == "":
-        return 0
-    return int(x, 0)
 
 
 def _parse_args() -> argparse.Namespace:
     p = argparse.ArgumentParser(
-        description="Convert ChampSim --commit-trace CSV into input.npy/output.npy"
+        description="Convert ChampSim --commit-trace output into input.npy/output.npy"
     )
     p.add_argument(
         "trace_csv",
         type=str,
-        help="CSV path or glob pattern from ChampSim --commit-trace (e.g., commit_trace*.csv)",
+        help="Trace path or glob pattern from ChampSim --commit-trace (e.g., commit_trace*.csv, commit_trace*.npy)",
     )
     p.add_argument(
         "--out-dir",
@@ -60,14 +54,6 @@ def _parse_args() -> argparse.Namespace:
     return p.parse_args()
 
 
-def _iter_rows(path: Path) -> Iterable[dict[str, str]]:
-    with path.open("r", newline="") as f:
-        reader = csv.DictReader(f)
-        if reader.fieldnames is None:
-            raise SystemExit(f"missing CSV header in {path}")
-        yield from reader
-
-
 def main() -> int:
     args = _parse_args()
     matched = [Path(p) for p in sorted(glob.glob(args.trace_csv))]
@@ -89,27 +75,34 @@ def main() -> int:
     except Exception as e:  # pragma: no cover
         raise SystemExit(f"failed to import numpy: {e}") from e
 
-    xs: list[list[int]] = []
-    ys: list[int] = []
+    sys.path.insert(0, str(Path(__file__).resolve().parent))
+    from commit_trace import COLUMNS, load_commit_trace
+
+    for c in [*input_cols, str(args.target)]:
+        if c not in COLUMNS:
+            raise SystemExit(f"unknown column {c!r}; available={list(COLUMNS)}")
+    input_idx = [COLUMNS.index(c) for c in input_cols]
+    target_idx = COLUMNS.index(str(args.target))
+
+    xs = []
+    ys = []
 
     row_count = 0
-    for trace_csv in matched:
-        for row in _iter_rows(trace_csv):
-            if max_rows is not None and row_count >= max_rows:
-                break
-            try:
-                xs.append([_parse_int(row[c]) for c in input_cols])
-                ys.append(_parse_int(row[str(args.target)]))
-            except KeyError as e:
-                raise SystemExit(
-                    f"missing column {e} in {trace_csv}; available={sorted(row.keys())}"
-                ) from e
-            row_count += 1
+    for trace in matched:
+        try:
+            records = load_commit_trace(trace)
+        except ValueError as e:
+            raise SystemExit(str(e)) from e
+        if max_rows is not None:
+            records = records[: max(max_rows - row_count, 0)]
+        xs.append(np.asarray(records[:, input_idx], dtype=np.int64))
+        ys.append(np.asarray(records[:, target_idx], dtype=np.int64))
+        row_count += len(records)
         if max_rows is not None and row_count >= max_rows:
             break
 
-    x = np.asarray(xs, dtype=np.int64).reshape((-1, len(input_cols)))
-    y = np.asarray(ys, dtype=np.int64).reshape((-1, 1))
+    x = np.concatenate(xs).reshape((-1, len(input_cols)))
+    y = np.concatenate(ys).reshape((-1, 1))
 
     np.save(out_dir / "input.npy", x)
     np.save(out_dir / "output.npy", y)
@@ -1170,6 +1170,8 @@ uint32_t barca::prefetcher_cache_operate(champsim::address addr, champsim::addre
 
 // this is called on "every" cycle except when it's not
 
+bool barca::prefetcher_cycle_idle() const { return prefetch_queue.empty() && would_be_nice_queue.empty(); }
+
 void barca::prefetcher_cycle_operate()
 {
         // issue up to dequeue_per_cycle many prefetches on this cycle
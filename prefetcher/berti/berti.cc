@@ -39,26 +39,6 @@
 
 using namespace berti_space;
 
-// Global state backing declarations in berti.h
-namespace berti_space
-{
-welford_t average_latency{};
-uint64_t pf_to_l1 = 0;
-uint64_t pf_to_l2 = 0;
-uint64_t pf_to_l2_bc_mshr = 0;
-uint64_t cant_track_latency = 0;
-uint64_t cross_page = 0;
-uint64_t no_cross_page = 0;
-uint64_t no_found_berti = 0;
-uint64_t found_berti = 0;
-uint64_t average_issued = 0;
-uint64_t average_num = 0;
-
-LatencyTable* latencyt = nullptr;
-ShadowCache* scache = nullptr;
-HistoryTable* historyt = nullptr;
-Berti* berti_table = nullptr;
-} // namespace berti_space
 /******************************************************************************/
 /*                      Latency table functions                               */
 /******************************************************************************/
@@ -85,7 +65,7 @@ uint8_t LatencyTable::add(uint64_t addr, uint64_t tag, bool pf, uint64_t cycle)
         latency_table* free;
         free = nullptr;
 
-        for(int i = 0; i < size; i++)
+        for(std::size_t i = 0; i < std::size(latencyt); i++)
         {
                 // Search if the addr already exists. If it exist we does not have
                 // to do nothing more
@@ -138,7 +118,7 @@ uint64_t LatencyTable::del(uint64_t addr)
                 std::cout << " addr: " << std::hex << addr;
         }
 
-        for(int i = 0; i < size; i++)
+        for(std::size_t i = 0; i < std::size(latencyt); i++)
         {
                 // Line already in the table
                 if(latencyt[i].addr == addr)
@@ -186,7 +166,7 @@ uint64_t LatencyTable::get(uint64_t addr)
                 std::cout << " addr: " << std::hex << addr << std::dec;
         }
 
-        for(int i = 0; i < size; i++)
+        for(std::size_t i = 0; i < std::size(latencyt); i++)
         {
                 // Search if the addr already exists
                 if(latencyt[i].addr == addr)
@@ -221,7 +201,7 @@ uint64_t LatencyTable::get_tag(uint64_t addr)
                 std::cout << " addr: " << std::hex << addr;
         }
 
-        for(int i = 0; i < size; i++)
+        for(std::size_t i = 0; i < std::size(latencyt); i++)
         {
                 if(latencyt[i].addr == addr && latencyt[i].tag) // This is the address
                 {
@@ -241,13 +221,35 @@ uint64_t LatencyTable::get_tag(uint64_t addr)
 /******************************************************************************/
 /*                       Shadow Cache functions                               */
 /******************************************************************************/
+ShadowCache::shadow_cache* ShadowCache::find(uint64_t addr)
+{
+        /*
+         * Parameters:
+         *      - addr: cache block v_addr
+         *
+         * Return: the entry of the addr, or nullptr if it is not in the l1d cache
+         */
+        for(std::size_t i = 0; i < std::size(scache); i++)
+        {
+                if(scache[i].addr == addr)
+                {
+                        if constexpr(champsim::debug_print)
+                        {
+                                std::cout << " set: " << i / ways << " way: " << i % ways;
+                        }
+                        return &scache[i];
+                }
+        }
+
+        return nullptr;
+}
+
 bool ShadowCache::add(uint32_t set, uint32_t way, uint64_t addr, bool pf, uint64_t lat)
 {
         /*
          * Add block to shadow cache
          *
          * Parameters:
-         *      - cpu: cpu
          *      - set: cache set
          *      - way: cache way
          *      - addr: cache block v_addr
@@ -263,10 +265,11 @@ bool ShadowCache::add(uint32_t set, uint32_t way, uint64_t addr, bool pf, uint64
                 std::cout << " latency: " << lat << std::endl;
         }
 
-        scache[set][way].addr = addr;
-        scache[set][way].pf   = pf;
-        scache[set][way].lat  = lat;
-        return scache[set][way].pf;
+        shadow_cache& entry = scache[set * ways + way];
+        entry.addr = addr;
+        entry.pf   = pf;
+        entry.lat  = lat;
+        return entry.pf;
 }
 
 bool ShadowCache::get(uint64_t addr)
@@ -281,25 +284,14 @@ bool ShadowCache::get(uint64_t addr)
         if constexpr(champsim::debug_print)
         {
                 std::cout << "[BERTI_SHADOW_CACHE] " << __func__;
-                std::cout << " addr: " << std::hex << addr << std::endl;
+                std::cout << " addr: " << std::hex << addr << std::dec;
         }
 
-        for(int i = 0; i < sets; i++)
-        {
-                for(int ii = 0; ii < ways; ii++)
-                {
-                        if(scache[i][ii].addr == addr)
-                        {
-                                if constexpr(champsim::debug_print)
-                                {
-                                        std::cout << " set: " << i << " way: " << ii << std::endl;
-                                }
-                                return true;
-                        }
-                }
-        }
+        bool found = (find(addr) != nullptr);
 
-        return false;
+        if constexpr(champsim::debug_print)
+                std::cout << std::endl;
+        return found;
 }
 
 void ShadowCache::set_pf(uint64_t addr, bool pf)
@@ -316,26 +308,17 @@ void ShadowCache::set_pf(uint64_t addr, bool pf)
                 std::cout << " addr: " << std::hex << addr << std::dec;
         }
 
-        for(int i = 0; i < sets; i++)
-        {
-                for(int ii = 0; ii < ways; ii++)
-                {
-                        if(scache[i][ii].addr == addr)
-                        {
-                                if constexpr(champsim::debug_print)
-                                {
-                                        std::cout << " set: " << i << " way: " << ii;
-                                        std::cout << " old_pf_value: " << +scache[i][ii].pf;
-                                        std::cout << " new_pf_value: " << +pf << std::endl;
-                                }
-                                scache[i][ii].pf = pf;
-                                return;
-                        }
-                }
-        }
+        shadow_cache* entry = find(addr);
 
         // The address should always be in the cache
-        assert((0) && "Address is must be in shadow cache");
+        assert((entry != nullptr) && "Address is must be in shadow cache");
+
+        if constexpr(champsim::debug_print)
+        {
+                std::cout << " old_pf_value: " << +entry->pf;
+                std::cout << " new_pf_value: " << +pf << std::endl;
+        }
+        entry->pf = pf;
 }
 
 bool ShadowCache::is_pf(uint64_t addr)
@@ -353,32 +336,20 @@ bool ShadowCache::is_pf(uint64_t addr)
                 std::cout << " addr: " << std::hex << addr << std::dec;
         }
 
-        for(int i = 0; i < sets; i++)
-        {
-                for(int ii = 0; ii < ways; ii++)
-                {
-                        if(scache[i][ii].addr == addr)
-                        {
-                                if constexpr(champsim::debug_print)
-                                {
-                                        std::cout << " set: " << i << " way: " << ii;
-                                        std::cout << " pf: " << +scache[i][ii].pf << std::endl;
-                                }
+        shadow_cache* entry = find(addr);
 
-                                return scache[i][ii].pf;
-                        }
-                }
-        }
+        assert((entry != nullptr) && "Address is must be in shadow cache");
+        if(entry == nullptr)
+                return 0;
 
-        assert((0) && "Address is must be in shadow cache");
-        return 0;
+        if constexpr(champsim::debug_print)
+                std::cout << " pf: " << +entry->pf << std::endl;
+        return entry->pf;
 }
 
 uint64_t ShadowCache::get_latency(uint64_t addr)
 {
         /*
-         * Init shadow cache
-         *
          * Parameters:
          *      - addr: cache block v_addr
          *
@@ -390,25 +361,46 @@ uint64_t ShadowCache::get_latency(uint64_t addr)
                 std::cout << " addr: " << std::hex << addr << std::dec;
         }
 
-        for(int i = 0; i < sets; i++)
+        shadow_cache* entry = find(addr);
+
+        assert((entry != nullptr) && "Address is must be in shadow cache");
+        if(entry == nullptr)
+                return 0;
+
+        if constexpr(champsim::debug_print)
+                std::cout << " latency: " << entry->lat << std::endl;
+        return entry->lat;
+}
+
+std::optional<uint64_t> ShadowCache::take_pf(uint64_t addr)
+{
+        /*
+         * Parameters:
+         *      - addr: cache block v_addr
+         *
+         * Return: the saved latency if the saved one is a prefetch, whose
+         * prefetch bit is then cleared
+         */
+        if constexpr(champsim::debug_print)
         {
-                for(int ii = 0; ii < ways; ii++)
-                {
-                        if(scache[i][ii].addr == addr)
-                        {
-                                if constexpr(champsim::debug_print)
-                                {
-                                        std::cout << " set: " << i << " way: " << ii;
-                                        std::cout << " latency: " << scache[i][ii].lat << std::endl;
-                                }
+                std::cout << "[BERTI_SHADOW_CACHE] " << __func__;
+                std::cout << " addr: " << std::hex << addr << std::dec;
+        }
 
-                                return scache[i][ii].lat;
-                        }
-                }
+        shadow_cache* entry = find(addr);
+
+        assert((entry != nullptr) && "Address is must be in shadow cache");
+        if(entry == nullptr || !entry->pf)
+        {
+                if constexpr(champsim::debug_print)
+                        std::cout << " pf: 0" << std::endl;
+                return std::nullopt;
         }
 
-        assert((0) && "Address is must be in shadow cache");
-        return 0;
+        if constexpr(champsim::debug_print)
+                std::cout << " pf: 1 latency: " << entry->lat << std::endl;
+        entry->pf = false;
+        return entry->lat;
 }
 
 /******************************************************************************/
@@ -423,20 +415,17 @@ void HistoryTable::add(uint64_t tag, uint64_t addr, uint64_t cycle)
          *  - tag: PC tag
          *  - addr: addr access
          */
-        uint16_t set = tag & TABLE_SET_MASK;
+        uint16_t     set  = tag & TABLE_SET_MASK;
+        std::size_t& next = history_pointers[set];
+
         // If the latest entry is the same, we do not add it
-        if(history_pointers[set] == &historyt[set][ways - 1])
-        {
-                if(historyt[set][0].addr == (addr & ADDR_MASK))
-                        return;
-        }
-        else if((history_pointers[set] - 1)->addr == (addr & ADDR_MASK))
+        if(entry(set, (next + ways - 1) % ways).addr == (addr & ADDR_MASK))
                 return;
 
         // Save new element into the history table
-        history_pointers[set]->tag  = tag;
-        history_pointers[set]->time = cycle & TIME_MASK;
-        history_pointers[set]->addr = addr & ADDR_MASK;
+        entry(set, next).tag  = tag;
+        entry(set, next).time = cycle & TIME_MASK;
+        entry(set, next).addr = addr & ADDR_MASK;
 
         if constexpr(champsim::debug_print)
         {
@@ -445,12 +434,7 @@ void HistoryTable::add(uint64_t tag, uint64_t addr, uint64_t cycle)
                 std::cout << " cycle: " << cycle << " set: " << set << std::endl;
         }
 
-        if(history_pointers[set] == &historyt[set][ways - 1])
-        {
-                history_pointers[set] = &historyt[set][0]; // End the cycle
-        }
-        else
-                history_pointers[set]++; // Pointer to the next (oldest) entry
+        next = (next + 1) % ways; // Pointer to the next (oldest) entry
 }
 
 uint16_t HistoryTable::get_aux(uint32_t latency, uint64_t tag, uint64_t act_addr, uint64_t* tags, uint64_t* addr, uint64_t cycle)
@@ -470,7 +454,7 @@ uint16_t HistoryTable::get_aux(uint32_t latency, uint64_t tag, uint64_t act_addr
         if constexpr(champsim::debug_print)
         {
                 std::cout << "[BERTI_HISTORY_TABLE] " << __func__;
-                std::cout << " tag: " << std::hex << tag << " line_addr: " << addr << std::dec;
+                std::cout << " tag: " << std::hex << tag << " line_addr: " << act_addr << std::dec;
                 std::cout << " cycle: " << cycle << " set: " << set << std::endl;
         }
 
@@ -481,32 +465,28 @@ uint16_t HistoryTable::get_aux(uint32_t latency, uint64_t tag, uint64_t act_addr
         // The IPs that is launch in this cycle will be able to launch this prefetch
         cycle -= latency;
 
-        // Pointer to guide
-        history_table* pointer = history_pointers[set];
+        // Start from the oldest entry, then go from the newest to the oldest
+        std::size_t way = history_pointers[set];
 
         do
         {
+                const history_table& pointer = entry(set, way);
+
                 // Look for the IPs that can launch this prefetch
-                if(pointer->tag == tag && pointer->time <= cycle)
+                if(pointer.tag == tag && pointer.time <= cycle)
                 {
                         // Test that addr is not duplicated
-                        if(pointer->addr == act_addr)
+                        if(pointer.addr == act_addr)
                                 return num_on_time;
 
                         // This IP can launch the prefetch
-                        tags[num_on_time] = pointer->tag;
-                        addr[num_on_time] = pointer->addr;
+                        tags[num_on_time] = pointer.tag;
+                        addr[num_on_time] = pointer.addr;
                         num_on_time++;
                 }
 
-                if(pointer == historyt[set])
-                {
-                        // We get at the end of the history, we start again
-                        pointer = &historyt[set][ways - 1];
-                }
-                else
-                        pointer--;
-        } while(pointer != history_pointers[set]);
+                way = (way + ways - 1) % ways;
+        } while(way != history_pointers[set]);
 
         return num_on_time;
 }
@@ -536,6 +516,17 @@ uint16_t HistoryTable::get(uint32_t latency, uint64_t tag, uint64_t act_addr, ui
 /******************************************************************************/
 /*                        Berti table functions                               */
 /******************************************************************************/
+Berti::berti* Berti::find(uint64_t tag)
+{
+        /*
+         * Return the entry of the tag, or nullptr if we are not tracking it
+         */
+        auto found = std::find_if(std::begin(bertit), std::end(bertit), [tag](const berti& x) { return x.valid && x.tag == tag; });
+        if(found == std::end(bertit))
+                return nullptr;
+        return &*found;
+}
+
 void Berti::increase_conf_tag(uint64_t tag)
 {
         /*
@@ -547,7 +538,8 @@ void Berti::increase_conf_tag(uint64_t tag)
         if constexpr(champsim::debug_print)
                 std::cout << "[BERTI_BERTI] " << __func__ << " tag: " << std::hex << tag << std::dec;
 
-        if(bertit.find(tag) == bertit.end())
+        berti* entry = find(tag);
+        if(entry == nullptr)
         {
                 // Tag not found
                 if constexpr(champsim::debug_print)
@@ -558,16 +550,18 @@ void Berti::increase_conf_tag(uint64_t tag)
 
         // Get the entries and the deltas
 
-        bertit[tag]->conf += CONFIDENCE_INC;
+        entry->conf += CONFIDENCE_INC;
 
         if constexpr(champsim::debug_print)
-                std::cout << " global_conf: " << bertit[tag]->conf;
+                std::cout << " global_conf: " << entry->conf;
 
-        if(bertit[tag]->conf == CONFIDENCE_MAX)
+        if(entry->conf == CONFIDENCE_MAX)
         {
                 // Max confidence achieve
-                for(auto& i: bertit[tag]->deltas)
+                for(std::size_t d = 0; d < entry->num_deltas; d++)
                 {
+                        delta_t& i = entry->deltas[d];
+
                         // Set bits to prefetch level
                         if(i.conf > CONFIDENCE_L1)
                                 i.rpl = BERTI_L1;
@@ -588,7 +582,7 @@ void Berti::increase_conf_tag(uint64_t tag)
                         i.conf = 0; // Reset confidence
                 }
 
-                bertit[tag]->conf = 0; // Reset global confidence
+                entry->conf = 0; // Reset global confidence
         }
 
         if constexpr(champsim::debug_print)
@@ -602,7 +596,6 @@ void Berti::add(uint64_t tag, int64_t delta)
          *
          * Parameters:
          *  - tag: PC tag
-         *  - cpu: actual cpu
          *  - stride: actual cpu
          */
         if constexpr(champsim::debug_print)
@@ -619,36 +612,29 @@ void Berti::add(uint64_t tag, int64_t delta)
                 new_delta.delta = delta;
                 new_delta.conf  = CONFIDENCE_INIT;
                 new_delta.rpl   = BERTI_R;
-                entry->deltas.push_back(new_delta);
+                entry->deltas[entry->num_deltas++] = new_delta;
         };
 
-        if(bertit.find(tag) == bertit.end())
+        berti* entry = find(tag);
+        if(entry == nullptr)
         {
                 if constexpr(champsim::debug_print)
                         std::cout << " allocating a new entry;";
 
-                // We are not tracking this tag
-                if(bertit_queue.size() > BERTI_TABLE_SIZE)
-                {
-                        // FIFO replacent algorithm
-                        uint64_t key   = bertit_queue.front();
-                        berti*   entry = bertit[key];
-
-                        if constexpr(champsim::debug_print)
-                                std::cout << " removing tag: " << std::hex << key << std::dec << ";";
+                // We are not tracking this tag, FIFO replacent algorithm
+                entry       = &bertit[bertit_next];
+                bertit_next = (bertit_next + 1) % std::size(bertit);
 
-                        delete entry; // Free previous entry
-
-                        bertit.erase(bertit_queue.front());
-                        bertit_queue.pop();
-                }
+                if constexpr(champsim::debug_print)
+                        if(entry->valid)
+                                std::cout << " removing tag: " << std::hex << entry->tag << std::dec << ";";
 
-                bertit_queue.push(tag); // Add new tag
-                assert((bertit.size() <= BERTI_TABLE_SIZE) && "Tracking too much tags");
+                *entry       = berti{};
+                entry->valid = true;
+                entry->tag   = tag;
 
                 // Confidence IP
-                berti* entry = new berti;
-                entry->conf  = CONFIDENCE_INC;
+                entry->conf = CONFIDENCE_INC;
 
                 // Saving the new stride
                 add_delta(delta, entry);
@@ -656,16 +642,15 @@ void Berti::add(uint64_t tag, int64_t delta)
                 if constexpr(champsim::debug_print)
                         std::cout << " confidence: " << CONFIDENCE_INIT << std::endl;
 
-                // Save the new tag
-                bertit.insert(std::make_pair(tag, entry));
                 return;
         }
 
         // Get the delta
-        berti* entry = bertit[tag];
+        auto deltas_end = std::next(std::begin(entry->deltas), static_cast<std::ptrdiff_t>(entry->num_deltas));
 
-        for(auto& i: entry->deltas)
+        for(auto it = std::begin(entry->deltas); it != deltas_end; ++it)
         {
+                delta_t& i = *it;
                 if(i.delta == delta)
                 {
                         // We already track the delta
@@ -682,15 +667,14 @@ void Berti::add(uint64_t tag, int64_t delta)
         }
 
         // We have space to add a new entry
-        if(std::size(entry->deltas) < size)
+        if(entry->num_deltas < std::size(entry->deltas))
         {
                 add_delta(delta, entry);
-                assert((std::size(entry->deltas) <= size) && "I remember too much deltas");
                 return;
         }
 
         // We find the delta with less confidence
-        std::sort(std::begin(entry->deltas), std::end(entry->deltas), compare_rpl);
+        std::sort(std::begin(entry->deltas), deltas_end, compare_rpl);
         if(entry->deltas.front().rpl == BERTI_R || entry->deltas.front().rpl == BERTI_L2R)
         {
                 if constexpr(champsim::debug_print)
@@ -716,30 +700,30 @@ uint8_t Berti::get(uint64_t tag, std::vector<delta_t>& res)
                 std::cout << std::dec;
         }
 
-        if(!bertit.count(tag))
+        berti* entry = find(tag);
+        if(entry == nullptr)
         {
                 if constexpr(champsim::debug_print)
                         std::cout << " TAG NOT FOUND" << std::endl;
-                no_found_berti++;
                 return 0;
         }
-        found_berti++;
 
         if constexpr(champsim::debug_print)
                 std::cout << std::endl;
 
         // We found the tag
-        berti* entry = bertit[tag];
+        auto deltas_end = std::next(std::begin(entry->deltas), static_cast<std::ptrdiff_t>(entry->num_deltas));
 
-        for(auto& i: entry->deltas)
-                if(i.delta != 0 && i.rpl != BERTI_R)
-                        res.push_back(i);
+        for(auto it = std::begin(entry->deltas); it != deltas_end; ++it)
+                if(it->delta != 0 && it->rpl != BERTI_R)
+                        res.push_back(*it);
 
         if(res.empty() && entry->conf >= LAUNCH_MIDDLE_CONF)
         {
                 // We do not find any delta, so we will try to launch with small confidence
-                for(auto& i: entry->deltas)
+                for(auto it = std::begin(entry->deltas); it != deltas_end; ++it)
                 {
+                        const delta_t& i = *it;
                         if(i.delta != 0)
                         {
                                 delta_t new_delta;
@@ -760,7 +744,7 @@ uint8_t Berti::get(uint64_t tag, std::vector<delta_t>& res)
         return 1;
 }
 
-void Berti::find_and_update(uint64_t latency, uint64_t tag, uint64_t cycle, uint64_t line_addr)
+void Berti::find_and_update(HistoryTable& historyt, uint64_t latency, uint64_t tag, uint64_t cycle, uint64_t line_addr)
 {
         // We were tracking this miss
         uint64_t tags[HISTORY_TABLE_WAYS];
@@ -768,7 +752,7 @@ void Berti::find_and_update(uint64_t latency, uint64_t tag, uint64_t cycle, uint
         uint16_t num_on_time = 0;
 
         // Get the IPs that can launch a prefetch
-        num_on_time = historyt->get(latency, tag, line_addr, tags, addr, cycle);
+        num_on_time = historyt.get(static_cast<uint32_t>(latency), tag, line_addr, tags, addr, cycle);
 
         for(uint32_t i = 0; i < num_on_time; i++)
         {
@@ -960,10 +944,10 @@ void berti::prefetcher_initialize()
         for(auto const& i: intern_->get_pq_size()) latency_table_size += i;
 
         // New structures
-        latencyt    = new LatencyTable(latency_table_size);
-        scache      = new ShadowCache(intern_->NUM_SET, intern_->NUM_WAY);
-        historyt    = new HistoryTable();
-        berti_table = new Berti(BERTI_TABLE_DELTA_SIZE);
+        latencyt    = LatencyTable(latency_table_size);
+        scache      = ShadowCache(intern_->NUM_SET, intern_->NUM_WAY);
+        historyt    = HistoryTable();
+        berti_table = Berti();
 
         std::cout << "Berti Prefetcher" << std::endl;
 
@@ -972,8 +956,6 @@ void berti::prefetcher_initialize()
 #endif
 }
 
-void berti::prefetcher_cycle_operate() {}
-
 uint32_t berti::prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
                                          uint32_t metadata_in)
 {
@@ -996,30 +978,28 @@ uint32_t berti::prefetcher_cache_operate(champsim::address addr, champsim::addre
                 std::cout << " line_address: " << line_addr << std::dec << std::endl;
         }
 
-        uint64_t ip_hash = berti_table->ip_hash(ip_val) & IP_MASK;
+        uint64_t ip_hash = Berti::ip_hash(ip_val) & IP_MASK;
 
         if(!cache_hit) // This is a miss
         {
                 if constexpr(champsim::debug_print)
                         std::cout << "[BERTI] operate cache miss" << std::endl;
 
-                latencyt->add(line_addr, ip_hash, false, cycle_now); // Add @ to latency
-                historyt->add(ip_hash, line_addr, cycle_now);        // Add to the table
+                latencyt.add(line_addr, ip_hash, false, cycle_now); // Add @ to latency
+                historyt.add(ip_hash, line_addr, cycle_now);        // Add to the table
         }
-        else if(cache_hit && scache->is_pf(line_addr)) // Hit bc prefetch
+        else if(auto pf_latency = scache.take_pf(line_addr); pf_latency.has_value()) // Hit bc prefetch
         {
                 if constexpr(champsim::debug_print)
                         std::cout << "[BERTI] operate cache hit because of pf" << std::endl;
 
-                scache->set_pf(line_addr, false);
-
-                uint64_t latency = scache->get_latency(line_addr); // Get latency
+                uint64_t latency = *pf_latency; // Get latency
 
                 if(latency > LAT_MASK)
                         latency = 0;
 
-                berti_table->find_and_update(latency, ip_hash, cycle_now & TIME_MASK, line_addr);
-                historyt->add(ip_hash, line_addr, cycle_now & TIME_MASK);
+                berti_table.find_and_update(historyt, latency, ip_hash, cycle_now & TIME_MASK, line_addr);
+                historyt.add(ip_hash, line_addr, cycle_now & TIME_MASK);
         }
         else
         {
@@ -1027,8 +1007,11 @@ uint32_t berti::prefetcher_cache_operate(champsim::address addr, champsim::addre
                         std::cout << "[BERTI] operate cache hit" << std::endl;
         }
 
-        std::vector<delta_t> deltas;
-        berti_table->get(ip_hash, deltas);
+        deltas.clear();
+        if(berti_table.get(ip_hash, deltas))
+                stats.found_berti++;
+        else
+                stats.no_found_berti++;
 
         bool first_issue = true;
         for(auto i: deltas)
@@ -1036,7 +1019,7 @@ uint32_t berti::prefetcher_cache_operate(champsim::address addr, champsim::addre
                 uint64_t p_addr   = (line_addr + i.delta) << LOG2_BLOCK_SIZE;
                 uint64_t p_b_addr = (p_addr >> LOG2_BLOCK_SIZE);
 
-                if(latencyt->get(p_b_addr))
+                if(latencyt.get(p_b_addr))
                         continue;
                 if(i.rpl == BERTI_R)
                         return metadata_in;
@@ -1045,33 +1028,33 @@ uint32_t berti::prefetcher_cache_operate(champsim::address addr, champsim::addre
 
                 if((p_addr >> LOG2_PAGE_SIZE) != (full_addr >> LOG2_PAGE_SIZE))
                 {
-                        cross_page++;
+                        stats.cross_page++;
 #ifdef NO_CROSS_PAGE
                         // We do not cross virtual page
                         continue;
 #endif
                 }
                 else
-                        no_cross_page++;
+                        stats.no_cross_page++;
 
                 float mshr_load = intern_->get_mshr_occupancy_ratio() * 100;
 
                 bool fill_this_level = (i.rpl == BERTI_L1) && (mshr_load < MSHR_LIMIT);
 
                 if(i.rpl == BERTI_L1 && mshr_load >= MSHR_LIMIT)
-                        pf_to_l2_bc_mshr++;
+                        stats.pf_to_l2_bc_mshr++;
                 if(fill_this_level)
-                        pf_to_l1++;
+                        stats.pf_to_l1++;
                 else
-                        pf_to_l2++;
+                        stats.pf_to_l2++;
 
                 if(prefetch_line(champsim::address{p_addr}, fill_this_level, metadata_in))
                 {
-                        ++average_issued;
+                        ++stats.average_issued;
                         if(first_issue)
                         {
                                 first_issue = false;
-                                ++average_num;
+                                ++stats.average_num;
                         }
 
                         if constexpr(champsim::debug_print)
@@ -1083,9 +1066,9 @@ uint32_t berti::prefetcher_cache_operate(champsim::address addr, champsim::addre
 
                         if(fill_this_level)
                         {
-                                if(!scache->get(p_b_addr))
+                                if(!scache.get(p_b_addr))
                                 {
-                                        latencyt->add(p_b_addr, ip_hash, true, cycle_now);
+                                        latencyt.add(p_b_addr, ip_hash, true, cycle_now);
                                 }
                 }
         }
@@ -1101,8 +1084,8 @@ uint32_t berti::prefetcher_cache_fill(champsim::address addr, long set, long way
 
         const uint64_t line_addr = (addr.to<uint64_t>() >> LOG2_BLOCK_SIZE); // Line addr
         const uint64_t cycle_now = intern_->current_cycle();
-        uint64_t tag       = latencyt->get_tag(line_addr);
-        uint64_t cycle     = latencyt->del(line_addr) & TIME_MASK;
+        uint64_t tag       = latencyt.get_tag(line_addr);
+        uint64_t cycle     = latencyt.del(line_addr) & TIME_MASK;
         uint64_t latency   = 0;
 
         if constexpr(champsim::debug_print)
@@ -1119,29 +1102,30 @@ uint32_t berti::prefetcher_cache_fill(champsim::address addr, long set, long way
         if(latency > LAT_MASK)
         {
                 latency = 0;
-                cant_track_latency++;
+                stats.cant_track_latency++;
         }
         else
         {
                 if(latency != 0)
                 {
                         // Calculate average latency
-                        if(average_latency.num == 0)
-                                average_latency.average = (float)latency;
+                        if(stats.average_latency.num == 0)
+                                stats.average_latency.average = (float)latency;
                         else
                         {
-                                average_latency.average = average_latency.average + ((((float)latency) - average_latency.average) / average_latency.num);
+                                stats.average_latency.average = stats.average_latency.average
+                                        + ((((float)latency) - stats.average_latency.average) / stats.average_latency.num);
                         }
-                        average_latency.num++;
+                        stats.average_latency.num++;
                 }
         }
 
         // Add to the shadow cache
-        scache->add(static_cast<uint32_t>(set), static_cast<uint32_t>(way), line_addr, prefetch, latency);
+        scache.add(static_cast<uint32_t>(set), static_cast<uint32_t>(way), line_addr, prefetch, latency);
 
         if(latency != 0 && !prefetch)
         {
-                berti_table->find_and_update(latency, tag, cycle, line_addr);
+                berti_table.find_and_update(historyt, latency, tag, cycle, line_addr);
         }
         return metadata_in;
 }
@@ -1149,22 +1133,22 @@ uint32_t berti::prefetcher_cache_fill(champsim::address addr, long set, long way
 void berti::prefetcher_final_stats()
 {
         std::cout << "BERTI "
-                  << "TO_L1: " << pf_to_l1 << " TO_L2: " << pf_to_l2;
-        std::cout << " TO_L2_BC_MSHR: " << pf_to_l2_bc_mshr << std::endl;
+                  << "TO_L1: " << stats.pf_to_l1 << " TO_L2: " << stats.pf_to_l2;
+        std::cout << " TO_L2_BC_MSHR: " << stats.pf_to_l2_bc_mshr << std::endl;
 
         std::cout << "BERTI AVG_LAT: ";
-        std::cout << average_latency.average << " NUM_TRACK_LATENCY: ";
-        std::cout << average_latency.num << " NUM_CANT_TRACK_LATENCY: ";
-        std::cout << cant_track_latency << std::endl;
+        std::cout << stats.average_latency.average << " NUM_TRACK_LATENCY: ";
+        std::cout << stats.average_latency.num << " NUM_CANT_TRACK_LATENCY: ";
+        std::cout << stats.cant_track_latency << std::endl;
 
-        std::cout << "BERTI CROSS_PAGE " << cross_page;
-        std::cout << " NO_CROSS_PAGE: " << no_cross_page << std::endl;
+        std::cout << "BERTI CROSS_PAGE " << stats.cross_page;
+        std::cout << " NO_CROSS_PAGE: " << stats.no_cross_page << std::endl;
 
         std::cout << "BERTI";
-        std::cout << " FOUND_BERTI: " << found_berti;
-        std::cout << " NO_FOUND_BERTI: " << no_found_berti << std::endl;
+        std::cout << " FOUND_BERTI: " << stats.found_berti;
+        std::cout << " NO_FOUND_BERTI: " << stats.no_found_berti << std::endl;
 
         std::cout << "BERTI";
-        std::cout << " AVERAGE_ISSUED: " << ((1.0 * average_issued) / average_num);
+        std::cout << " AVERAGE_ISSUED: " << ((1.0 * stats.average_issued) / stats.average_num);
         std::cout << std::endl;
 }
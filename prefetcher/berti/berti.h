@@ -44,12 +44,12 @@
 #include "modules.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
 #include <iostream>
-#include <map>
-#include <queue>
+#include <optional>
 #include <stdlib.h>
 #include <time.h>
 #include <tuple>
@@ -67,19 +67,21 @@ namespace berti_space
                         float    average = 0.0;
         } welford_t;
 
-        extern welford_t average_latency;
-
         // Get more info
-        extern uint64_t pf_to_l1;
-        extern uint64_t pf_to_l2;
-        extern uint64_t pf_to_l2_bc_mshr;
-        extern uint64_t cant_track_latency;
-        extern uint64_t cross_page;
-        extern uint64_t no_cross_page;
-        extern uint64_t no_found_berti;
-        extern uint64_t found_berti;
-        extern uint64_t average_issued;
-        extern uint64_t average_num;
+        struct stats
+        {
+                        welford_t average_latency{};
+                        uint64_t  pf_to_l1           = 0;
+                        uint64_t  pf_to_l2           = 0;
+                        uint64_t  pf_to_l2_bc_mshr   = 0;
+                        uint64_t  cant_track_latency = 0;
+                        uint64_t  cross_page         = 0;
+                        uint64_t  no_cross_page      = 0;
+                        uint64_t  no_found_berti     = 0;
+                        uint64_t  found_berti        = 0;
+                        uint64_t  average_issued     = 0;
+                        uint64_t  average_num        = 0;
+        };
 
         /*****************************************************************************
          *                      General Structs                                      *
@@ -95,6 +97,9 @@ namespace berti_space
 
         /*****************************************************************************
          *                      Berti structures                                     *
+         *                                                                           *
+         * Every table is a flat array of fixed size, owned by one instance of the   *
+         * prefetcher, and holds no pointers so that it can be saved and restored.   *
          *****************************************************************************/
         class LatencyTable
         {
@@ -108,24 +113,23 @@ namespace berti_space
                                         uint64_t time = 0;     // Event cycle
                                         bool     pf   = false; // Is the entry accessed by a demand miss
                         };
-                        int size;
 
-                        latency_table* latencyt;
+                        std::vector<latency_table> latencyt;
 
                 public:
-                        LatencyTable(const int size): size(size)
-                        {
-                                latencyt = new latency_table[size];
-                        }
-                        ~LatencyTable()
-                        {
-                                delete latencyt;
-                        }
+                        LatencyTable() = default;
+                        explicit LatencyTable(std::size_t size): latencyt(size) {}
 
                         uint8_t  add(uint64_t addr, uint64_t tag, bool pf, uint64_t cycle);
                         uint64_t get(uint64_t addr);
                         uint64_t del(uint64_t addr);
                         uint64_t get_tag(uint64_t addr);
+
+                        template <typename Archive>
+                        void serialize(Archive& ar)
+                        {
+                                ar(latencyt);
+                        }
         };
 
         class ShadowCache
@@ -140,31 +144,33 @@ namespace berti_space
                                         bool     pf   = false; // Is a prefetch
                         };                                     // This struct is the vberti table
 
-                        int            sets;
-                        int            ways;
-                        shadow_cache** scache;
+                        std::size_t               ways = 0;
+                        std::vector<shadow_cache> scache; // sets * ways entries, one set after another
 
-                public:
-                        ShadowCache(const int sets, const int ways)
-                        {
-                                scache = new shadow_cache*[sets];
-                                for(int i = 0; i < sets; i++) scache[i] = new shadow_cache[ways];
+                        // The first entry that holds the address, in the order of the sets and then the ways
+                        shadow_cache* find(uint64_t addr);
 
-                                this->sets = sets;
-                                this->ways = ways;
-                        }
-
-                        ~ShadowCache()
-                        {
-                                for(int i = 0; i < sets; i++) delete scache[i];
-                                delete scache;
-                        }
+                public:
+                        ShadowCache() = default;
+                        ShadowCache(std::size_t num_sets, std::size_t num_ways): ways(num_ways), scache(num_sets * num_ways) {}
 
                         bool     add(uint32_t set, uint32_t way, uint64_t addr, bool pf, uint64_t lat);
                         bool     get(uint64_t addr);
                         void     set_pf(uint64_t addr, bool pf);
                         bool     is_pf(uint64_t addr);
                         uint64_t get_latency(uint64_t addr);
+
+                        /*
+                         * If the address was brought by a prefetch, clear its
+                         * prefetch bit and return its latency, in one search.
+                         */
+                        std::optional<uint64_t> take_pf(uint64_t addr);
+
+                        template <typename Archive>
+                        void serialize(Archive& ar)
+                        {
+                                ar(ways, scache);
+                        }
         };
 
         class HistoryTable
@@ -179,35 +185,25 @@ namespace berti_space
                                         uint64_t time = 0; // Time where the line is accessed
                         };                                 // This struct is the history table
 
-                        const int sets = HISTORY_TABLE_SETS;
-                        const int ways = HISTORY_TABLE_WAYS;
+                        constexpr static std::size_t sets = HISTORY_TABLE_SETS;
+                        constexpr static std::size_t ways = HISTORY_TABLE_WAYS;
+
+                        std::array<history_table, sets * ways> historyt{};
+                        std::array<std::size_t, sets>          history_pointers{}; // The next (oldest) way of each set
 
-                        history_table** historyt;
-                        history_table** history_pointers;
+                        history_table& entry(std::size_t set, std::size_t way) { return historyt[set * ways + way]; }
 
                         uint16_t get_aux(uint32_t latency, uint64_t tag, uint64_t act_addr, uint64_t* tags, uint64_t* addr, uint64_t cycle);
 
                 public:
-                        HistoryTable()
-                        {
-                                history_pointers = new history_table*[sets];
-                                historyt         = new history_table*[sets];
-
-                                for(int i = 0; i < sets; i++) historyt[i] = new history_table[ways];
-                                for(int i = 0; i < sets; i++) history_pointers[i] = historyt[i];
-                        }
+                        void     add(uint64_t tag, uint64_t addr, uint64_t cycle);
+                        uint16_t get(uint32_t latency, uint64_t tag, uint64_t act_addr, uint64_t* tags, uint64_t* addr, uint64_t cycle);
 
-                        ~HistoryTable()
+                        template <typename Archive>
+                        void serialize(Archive& ar)
                         {
-                                for(int i = 0; i < sets; i++) delete historyt[i];
-                                delete historyt;
-
-                                delete history_pointers;
+                                ar(historyt, history_pointers);
                         }
-
-                        int      get_ways();
-                        void     add(uint64_t tag, uint64_t addr, uint64_t cycle);
-                        uint16_t get(uint32_t latency, uint64_t tag, uint64_t act_addr, uint64_t* tags, uint64_t* addr, uint64_t cycle);
         };
 
         class Berti
@@ -217,45 +213,59 @@ namespace berti_space
                 private:
                         struct berti
                         {
-                                        std::vector<delta_t> deltas;
-                                        uint64_t             conf;
-                                        uint64_t             total_used;
+                                        bool                                         valid = false;
+                                        uint64_t                                     tag   = 0;
+                                        std::array<delta_t, BERTI_TABLE_DELTA_SIZE> deltas{};
+                                        std::size_t                                  num_deltas = 0;
+                                        uint64_t                                     conf       = 0;
                         };
 
-                        std::map<uint64_t, berti*> bertit;
-                        std::queue<uint64_t>       bertit_queue;
-
-                        uint64_t size = 0;
+                        // Fully associative, replaced in FIFO order
+                        std::array<berti, BERTI_TABLE_SIZE> bertit{};
+                        std::size_t                         bertit_next = 0; // The entry to replace next
 
                         bool static compare_greater_delta(delta_t a, delta_t b);
                         bool static compare_rpl(delta_t a, delta_t b);
 
-                        void increase_conf_tag(uint64_t tag);
-                        void conf_tag(uint64_t tag);
-                        void add(uint64_t tag, int64_t delta);
+                        berti* find(uint64_t tag);
+                        void   increase_conf_tag(uint64_t tag);
+                        void   add(uint64_t tag, int64_t delta);
 
                 public:
-                        Berti(uint64_t p_size): size(p_size) {};
-                        void     find_and_update(uint64_t latency, uint64_t tag, uint64_t cycle, uint64_t line_addr);
-                        uint8_t  get(uint64_t tag, std::vector<delta_t>& res);
-                        uint64_t ip_hash(uint64_t ip);
-        };
+                        void           find_and_update(HistoryTable& historyt, uint64_t latency, uint64_t tag, uint64_t cycle, uint64_t line_addr);
+                        uint8_t        get(uint64_t tag, std::vector<delta_t>& res);
+                        uint64_t static ip_hash(uint64_t ip);
 
-        extern LatencyTable* latencyt;
-        extern ShadowCache*  scache;
-        extern HistoryTable* historyt;
-        extern Berti*        berti_table;
+                        template <typename Archive>
+                        void serialize(Archive& ar)
+                        {
+                                ar(bertit, bertit_next);
+                        }
+        };
 }; // namespace berti_space
 
 struct berti : public champsim::modules::prefetcher {
+  berti_space::LatencyTable latencyt;
+  berti_space::ShadowCache scache;
+  berti_space::HistoryTable historyt;
+  berti_space::Berti berti_table;
+  berti_space::stats stats;
+
+  std::vector<berti_space::delta_t> deltas; // Reused by each access, to avoid allocating
+
   using champsim::modules::prefetcher::prefetcher;
 
   void prefetcher_initialize();
   uint32_t prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
                                     uint32_t metadata_in);
   uint32_t prefetcher_cache_fill(champsim::address addr, long set, long way, bool prefetch, champsim::address evicted_addr, uint32_t metadata_in);
-  void prefetcher_cycle_operate();
   void prefetcher_final_stats();
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(latencyt, scache, historyt, berti_table);
+  }
 };
 
 #endif
@@ -50,6 +50,13 @@ public:
   uint32_t prefetcher_cache_fill(champsim::address addr, long set, long way, uint8_t prefetch, champsim::address evicted_addr, uint32_t metadata_in);
   void prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target);
   void prefetcher_cycle_operate();
+  [[nodiscard]] bool prefetcher_cycle_idle() const { return !active_lookahead.has_value(); }
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(active_lookahead, branch_context_ip, table);
+  }
 };
 
 #endif
@@ -27,8 +27,6 @@ void spp_dev::prefetcher_initialize()
   GHR._parent = this;
 }
 
-void spp_dev::prefetcher_cycle_operate() {}
-
 uint32_t spp_dev::prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
                                            uint32_t metadata_in)
 {
@@ -53,7 +53,6 @@ struct spp_dev : public champsim::modules::prefetcher {
   uint32_t prefetcher_cache_fill(champsim::address addr, long set, long way, uint8_t prefetch, champsim::address evicted_addr, uint32_t metadata_in);
 
   void prefetcher_initialize();
-  void prefetcher_cycle_operate();
   void prefetcher_final_stats();
 
   enum FILTER_REQUEST { SPP_L2C_PREFETCH, SPP_LLC_PREFETCH, L2C_DEMAND, L2C_EVICT }; // Request type for prefetch filter
@@ -39,6 +39,12 @@ public:
 
   void update_bip(long set, long way);
   void update_srrip(long set, long way);
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(bip_counter, PSEL, rrpv);
+  }
 };
 
 #endif
@@ -24,6 +24,12 @@ public:
   void update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip, champsim::address victim_addr,
                                 access_type type, uint8_t hit);
   // void replacement_final_stats()
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(last_used_cycles, cycle);
+  }
 };
 
 #endif
@@ -22,6 +22,12 @@ struct mockingjay : public champsim::modules::replacement {
                                 champsim::address victim_addr, access_type type, bool hit);
   void replacement_final_stats();
 
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(etr, etr_clock, current_timestamp, rdp, sampled_cache);
+  }
+
 private:
   static constexpr int HISTORY = 8;
   static constexpr int GRANULARITY = 8;
@@ -51,6 +51,12 @@ public:
 
   // use this function to print out your own stats at the end of simulation
   // void replacement_final_stats() {}
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(access_count, sampler, rrpv_values, SHCT);
+  }
 };
 
 #endif
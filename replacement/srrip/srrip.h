@@ -18,6 +18,12 @@ struct srrip_set_helper {
 
   long victim();
   void update(long way, bool hit);
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(rrpv_values);
+  }
 };
 
 struct srrip : public champsim::modules::replacement {
@@ -35,6 +41,12 @@ struct srrip : public champsim::modules::replacement {
 
   // use this function to print out your own stats at the end of simulation
   // void replacement_final_stats() {}
+
+  template <typename Archive>
+  void serialize(Archive& ar)
+  {
+    ar(sets);
+  }
 };
 
 #endif
@@ -34,12 +34,18 @@ class ChampSimBuildManager:
     fcntl.flock(lock_file.fileno(), fcntl.LOCK_EX)
     return lock_file
 
-  def _binary_name(self, action_updates: Mapping[str, str]) -> str:
-    suffix = "_".join(f"{key.replace('.', '-')}-{value}" for key, value in sorted(action_updates.items()))
-    return f"champsim_rl_{suffix}"
-
-  def ensure_binary(self, action_updates: Mapping[str, str]) -> BuildResult:
-    name = self._binary_name(action_updates)
+  def _binary_name(self, action_updates: Mapping[str, str], compile_all_modules: bool = False) -> str:
+    parts = [f"{key.replace('.', '-')}-{value}" for key, value in sorted(action_updates.items())]
+    if compile_all_modules:
+      parts.append("all-modules")
+    return f"champsim_rl_{'_'.join(parts)}"
+
+  def ensure_binary(self, action_updates: Mapping[str, str], compile_all_modules: bool = False) -> BuildResult:
+    """Build the binary for the given configuration updates, unless it exists.
+
+    With compile_all_modules, every module in the search path is compiled in, so that any of them can be selected at run time.
+    """
+    name = self._binary_name(action_updates, compile_all_modules)
     binary_path = self.bin_root / name
     config_path = self.build_root / f"{name}.json"
 
@@ -50,7 +56,7 @@ class ChampSimBuildManager:
       lock_file = self._acquire_build_lock()
       try:
         if not binary_path.exists():
-          self._build_binary(name, binary_path, config_path, action_updates)
+          self._build_binary(name, binary_path, config_path, action_updates, compile_all_modules)
       finally:
         fcntl.flock(lock_file.fileno(), fcntl.LOCK_UN)
         lock_file.close()
@@ -58,7 +64,7 @@ class ChampSimBuildManager:
     return BuildResult(binary_path=binary_path, config_path=config_path)
 
   def _build_binary(
-      self, name: str, binary_path: Path, config_path: Path, action_updates: Mapping[str, str]
+      self, name: str, binary_path: Path, config_path: Path, action_updates: Mapping[str, str], compile_all_modules: bool
   ) -> None:
     with self.template_config.open("r", encoding="utf-8") as handle:
       config = json.load(handle)
@@ -71,8 +77,9 @@ class ChampSimBuildManager:
       json.dump(config, handle, indent=2)
 
     # Reconfigure ChampSim for this binary
+    config_flags = "--compile-all-modules " if compile_all_modules else ""
     subprocess.run(
-        ["bash", "-lc", f"./config.sh {config_path}"],
+        ["bash", "-lc", f"./config.sh {config_flags}{config_path}"],
         cwd=self.repo_root,
         check=True,
     )
@@ -3,12 +3,13 @@ from __future__ import annotations
 import argparse
 import json
 import os
+import shlex
 import signal
 import subprocess
 from pathlib import Path
-from typing import Dict, Optional
+from typing import Dict, List, Mapping, Optional
 
-from .action_space import Action, ActionSpace, load_action_space
+from .action_space import Action, ActionHead, ActionSpace, load_action_space
 from .builder import ChampSimBuildManager
 from .state import WindowMetrics, parse_stats_json
 
@@ -19,6 +20,9 @@ except AttributeError:
 
 EPS = 1e-12
 
+# Caches that a single-core build names after its core
+PRIVATE_CACHES = ("L1I", "L1D", "L2C", "ITLB", "DTLB", "STLB")
+
 
 def parse_args() -> argparse.Namespace:
   parser = argparse.ArgumentParser(
@@ -54,6 +58,14 @@ def parse_args() -> argparse.Namespace:
       default=None,
       help='Value for env var L2C_IPV (required by PACIPV). If omitted, uses existing $L2C_IPV.',
   )
+  parser.add_argument(
+      "--lockstep",
+      action="store_true",
+      help=(
+          "Run every policy in one invocation of a binary with all modules compiled in. "
+          "The trace is decoded once and each policy is simulated on its own thread."
+      ),
+  )
   parser.add_argument("--dry-run", action="store_true", help="Print commands without running them")
   parser.add_argument("--force", action="store_true", help="Re-run even if output stats already exist")
   return parser.parse_args()
@@ -81,6 +93,51 @@ def _needs_ipv(action_space: ActionSpace) -> bool:
   return False
 
 
+def _empty_metrics() -> WindowMetrics:
+  return WindowMetrics(
+      instructions=0.0,
+      cycles=0.0,
+      ipc=0.0,
+      l1d_mpki=0.0,
+      l2_mpki=0.0,
+      llc_mpki=0.0,
+      prefetch_coverage=0.0,
+      prefetch_accuracy=0.0,
+      branch_miss_rate=0.0,
+  )
+
+
+def _base_command(binary_path: Path, warmup: int, skip_instructions: int, simulation_instructions: Optional[int], stats_path: Path) -> List[str]:
+  cmd_parts = [
+      str(binary_path),
+      "--warmup-instructions",
+      str(warmup),
+      "--subtrace-count",
+      "1",
+      "--json",
+      str(stats_path),
+  ]
+  if skip_instructions:
+    cmd_parts[1:1] = ["--skip-instructions", str(skip_instructions)]
+  if simulation_instructions is not None:
+    cmd_parts[1:1] = ["--simulation-instructions", str(simulation_instructions)]
+  return cmd_parts
+
+
+def variant_spec(action: Action, heads: Mapping[str, ActionHead]) -> str:
+  """The --variant argument that selects the modules of an action at run time."""
+  selections = []
+  for name, value in sorted(action.values.items()):
+    head = heads[name]
+    cache, kind = head.path[0], head.path[-1]
+    if len(head.path) != 2 or kind not in ("prefetcher", "replacement"):
+      raise ValueError(f"Action head '{name}' cannot be selected at run time")
+    if cache in PRIVATE_CACHES:
+      cache = f"cpu0_{cache}"
+    selections.append(f"{kind}:{cache}={value}")
+  return ";".join(selections)
+
+
 def run_full_trace(
     repo_root: Path,
     build_manager: ChampSimBuildManager,
@@ -108,35 +165,13 @@ def run_full_trace(
   updates = action.as_config_updates(action_space.heads)
   build = build_manager.ensure_binary(updates)
 
-  cmd_parts = [
-      str(build.binary_path),
-      "--warmup-instructions",
-      str(warmup),
-      "--subtrace-count",
-      "1",
-      "--json",
-      str(stats_path),
-  ]
-  if skip_instructions:
-    cmd_parts[1:1] = ["--skip-instructions", str(skip_instructions)]
-  if simulation_instructions is not None:
-    cmd_parts[1:1] = ["--simulation-instructions", str(simulation_instructions)]
+  cmd_parts = _base_command(build.binary_path, warmup, skip_instructions, simulation_instructions, stats_path)
   cmd_parts.append(str(trace_path))
 
   cmd = " ".join(cmd_parts)
   if dry_run:
     print(cmd)
-    return WindowMetrics(
-        instructions=0.0,
-        cycles=0.0,
-        ipc=0.0,
-        l1d_mpki=0.0,
-        l2_mpki=0.0,
-        llc_mpki=0.0,
-        prefetch_coverage=0.0,
-        prefetch_accuracy=0.0,
-        branch_miss_rate=0.0,
-    )
+    return _empty_metrics()
 
   with log_path.open("w", encoding="utf-8") as log_handle:
     log_handle.write(cmd + "\n")
@@ -146,6 +181,55 @@ def run_full_trace(
   return parse_stats_json(stats_path)
 
 
+def run_lockstep(
+    repo_root: Path,
+    build_manager: ChampSimBuildManager,
+    action_space: ActionSpace,
+    trace_path: Path,
+    actions: List[Action],
+    warmup: int,
+    skip_instructions: int,
+    simulation_instructions: Optional[int],
+    output_root: Path,
+    env: Dict[str, str],
+    dry_run: bool,
+    force: bool,
+) -> Dict[str, WindowMetrics]:
+  """Simulate every action in one invocation, and split its statistics into the per-action files that run_full_trace writes."""
+  out_dirs = {action.key(): output_root / "baseline" / sanitize(action.key()) for action in actions}
+  pending = [action for action in actions if force or not (out_dirs[action.key()] / "full_trace_stats.json").exists()]
+
+  if pending:
+    build = build_manager.ensure_binary({}, compile_all_modules=True)
+    stats_path = ensure_dir(output_root / "lockstep") / "lockstep_stats.json"
+    log_path = output_root / "lockstep" / "lockstep.log"
+
+    cmd_parts = _base_command(build.binary_path, warmup, skip_instructions, simulation_instructions, stats_path)
+    for action in pending:
+      cmd_parts += ["--variant", shlex.quote(variant_spec(action, action_space.heads))]
+    cmd_parts.append(str(trace_path))
+
+    cmd = " ".join(cmd_parts)
+    if dry_run:
+      print(cmd)
+      return {action.key(): _empty_metrics() for action in actions}
+
+    with log_path.open("w", encoding="utf-8") as log_handle:
+      log_handle.write(cmd + "\n")
+      log_handle.flush()
+      subprocess.run(["bash", "-lc", cmd], cwd=repo_root, check=True, stdout=log_handle, stderr=subprocess.STDOUT, env=env)
+
+    with stats_path.open("r", encoding="utf-8") as handle:
+      variants = json.load(handle)
+    for action, variant in zip(pending, variants):
+      out_dir = ensure_dir(out_dirs[action.key()])
+      with (out_dir / "full_trace_stats.json").open("w", encoding="utf-8") as handle:
+        json.dump(variant["stats"], handle)
+      (out_dir / "full_trace.log").write_text(f"Simulated as variant '{variant['variant']}' of {cmd}\n", encoding="utf-8")
+
+  return {key: parse_stats_json(out_dir / "full_trace_stats.json") for key, out_dir in out_dirs.items()}
+
+
 def main() -> int:
   args = parse_args()
   repo_root = Path(__file__).resolve().parents[1]
@@ -163,25 +247,46 @@ def main() -> int:
 
   results: Dict[str, Dict[str, object]] = {}
   actions = action_space.all_actions()
-  for idx, action in enumerate(actions):
-    key = action.key()
-    safe_key = sanitize(key)
-    out_dir = output_root / "baseline" / safe_key
-    print(f"[{idx+1}/{len(actions)}] {key}")
-    metrics = run_full_trace(
+  lockstep_metrics: Dict[str, WindowMetrics] = {}
+  if args.lockstep:
+    print(f"Simulating {len(actions)} policies in lockstep")
+    lockstep_metrics = run_lockstep(
         repo_root=repo_root,
         build_manager=build_manager,
         action_space=action_space,
         trace_path=args.trace.resolve(),
-        action=action,
+        actions=actions,
         warmup=args.warmup,
         skip_instructions=args.skip_instructions,
         simulation_instructions=args.simulation_instructions,
-        out_dir=out_dir,
+        output_root=output_root,
         env=env,
         dry_run=args.dry_run,
         force=args.force,
     )
+
+  for idx, action in enumerate(actions):
+    key = action.key()
+    safe_key = sanitize(key)
+    out_dir = output_root / "baseline" / safe_key
+    if args.lockstep:
+      metrics = lockstep_metrics[key]
+    else:
+      print(f"[{idx+1}/{len(actions)}] {key}")
+      metrics = run_full_trace(
+          repo_root=repo_root,
+          build_manager=build_manager,
+          action_space=action_space,
+          trace_path=args.trace.resolve(),
+          action=action,
+          warmup=args.warmup,
+          skip_instructions=args.skip_instructions,
+          simulation_instructions=args.simulation_instructions,
+          out_dir=out_dir,
+          env=env,
+          dry_run=args.dry_run,
+          force=args.force,
+      )
     if not args.dry_run:
       results[key] = {
           # Keep compatibility with existing analysis scripts
@@ -0,0 +1,142 @@
+from __future__ import annotations
+
+import json
+import socket
+import subprocess
+import time
+from pathlib import Path
+from typing import Any, Dict, Iterable, Optional
+
+from .state import WindowMetrics, metrics_from_phase
+
+
+class ChampSimServerError(RuntimeError):
+  """A command was rejected by the ChampSim server."""
+
+
+class _ChampSimCommands:
+  """The commands shared by the server process and its branches."""
+
+  def command(self, *words: Any) -> Dict[str, Any]:
+    raise NotImplementedError
+
+  @staticmethod
+  def _check(line: str) -> Dict[str, Any]:
+    response = json.loads(line)
+    if response.get("status") != "ok":
+      raise ChampSimServerError(response.get("message", "unknown error"))
+    return response
+
+  def skip(self, instructions: int) -> None:
+    self.command("skip", instructions)
+
+  def warmup(self, instructions: int) -> Dict[str, Any]:
+    return self.command("warmup", instructions)
+
+  def run(self, instructions: int) -> WindowMetrics:
+    return metrics_from_phase(self.command("run", instructions)["stats"])
+
+  def select(self, kind: str, cache: str, modules: Iterable[str] | str) -> None:
+    names = modules if isinstance(modules, str) else ",".join(modules)
+    self.command(kind, cache, names)
+
+  def save(self, path: Path) -> None:
+    self.command("save", path)
+
+  def load(self, path: Path) -> None:
+    self.command("load", path)
+
+  def snapshot(self, path: Path) -> None:
+    self.command("snapshot", path)
+
+  def restore(self, path: Path) -> None:
+    self.command("restore", path)
+
+  def branch(self, socket_path: Path, timeout: float = 10.0) -> "ChampSimBranch":
+    """Fork the simulation at its current state, and connect to the copy."""
+    self.command("branch", socket_path)
+    return ChampSimBranch(socket_path, timeout)
+
+
+class ChampSimServer(_ChampSimCommands):
+  """Drive a single long-lived `champsim --server` process over stdin/stdout.
+
+  The trace stream and the warm microarchitectural state persist between
+  windows, so each step costs only the instructions it simulates.
+  """
+
+  def __init__(self, binary_path: Path, trace_path: Path, cwd: Optional[Path] = None):
+    self._proc = subprocess.Popen(
+        [str(binary_path), "--server", str(trace_path)],
+        cwd=cwd,
+        stdin=subprocess.PIPE,
+        stdout=subprocess.PIPE,
+        text=True,
+        bufsize=1,
+    )
+
+  def command(self, *words: Any) -> Dict[str, Any]:
+    assert self._proc.stdin is not None and self._proc.stdout is not None
+    self._proc.stdin.write(" ".join(str(w) for w in words) + "\n")
+    self._proc.stdin.flush()
+    line = self._proc.stdout.readline()
+    if not line:
+      raise ChampSimServerError(f"server exited with status {self._proc.wait()}")
+    return self._check(line)
+
+  def close(self) -> None:
+    if self._proc.poll() is None:
+      try:
+        self.command("quit")
+      finally:
+        self._proc.wait()
+
+  def __enter__(self) -> "ChampSimServer":
+    return self
+
+  def __exit__(self, *exc) -> None:
+    self.close()
+
+
+class ChampSimBranch(_ChampSimCommands):
+  """A forked copy of a simulation, served on a Unix socket.
+
+  The branch starts from the exact state of its parent, including requests in
+  flight, and exits when it is closed.
+  """
+
+  def __init__(self, socket_path: Path, timeout: float = 10.0):
+    deadline = time.monotonic() + timeout
+    while True:
+      try:
+        self._sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self._sock.connect(str(socket_path))
+        break
+      except (FileNotFoundError, ConnectionRefusedError):
+        self._sock.close()
+        if time.monotonic() > deadline:
+          raise ChampSimServerError(f"branch did not listen on {socket_path}")
+        time.sleep(0.01)
+    self._reader = self._sock.makefile("r")
+
+  def command(self, *words: Any) -> Dict[str, Any]:
+    self._sock.sendall((" ".join(str(w) for w in words) + "\n").encode())
+    line = self._reader.readline()
+    if not line:
+      raise ChampSimServerError("branch closed the connection")
+    return self._check(line)
+
+  def close(self) -> None:
+    try:
+      self.command("quit")
+    except (ChampSimServerError, OSError):
+      pass
+    finally:
+      self._reader.close()
+      self._sock.close()
+
+  def __enter__(self) -> "ChampSimBranch":
+    return self
+
+  def __exit__(self, *exc) -> None:
+    self.close()
@@ -45,7 +45,12 @@ def parse_stats_json(stats_path: Path) -> WindowMetrics:
   if not data:
     raise ValueError(f"Stats file {stats_path} is empty")
 
-  phase = data[0]["sim"]
+  return metrics_from_phase(data[0])
+
+
+def metrics_from_phase(phase_stats: Mapping) -> WindowMetrics:
+  """Summarise one phase object, as written by ChampSim's JSON printer."""
+  phase = phase_stats["sim"]
   core = phase["cores"][0]
   instructions = float(core.get("instructions", 0))
   cycles = float(core.get("cycles", 0))
@@ -86,6 +91,15 @@ def parse_stats_json(stats_path: Path) -> WindowMetrics:
   )
 
 
+def shadow_policy_mpki(phase_stats: Mapping, cache: str = "LLC") -> Dict[str, float]:
+  """
+  The MPKI that each replacement policy evaluated with --replacement-shadow is estimated to reach on a cache,
+  from one phase object. The result is empty if the cache was run without shadows.
+  """
+  shadows = phase_stats["sim"][cache].get("replacement shadows", {})
+  return {name: float(policy["MPKI"]) for name, policy in shadows.get("policies", {}).items()}
+
+
 def _load_total_misses(node: Mapping) -> float:
   total = 0.0
   for bucket in ("LOAD", "WRITE", "TRANSLATION", "PREFETCH", "RFO"):
@@ -21,7 +21,9 @@
 #include <cmath>
 #include <iomanip>
 #include <numeric>
+#include <sstream>
 #include <stdexcept>
+#include <typeinfo>
 #include <fmt/core.h>
 
 #include "bandwidth.h"
@@ -39,16 +41,24 @@ CACHE::CACHE(CACHE&& other)
       upper_levels(std::move(other.upper_levels)), lower_level(std::move(other.lower_level)), lower_translate(std::move(other.lower_translate)),
 
       cpu(other.cpu), NAME(std::move(other.NAME)), NUM_SET(other.NUM_SET), NUM_WAY(other.NUM_WAY), MSHR_SIZE(other.MSHR_SIZE), PQ_SIZE(other.PQ_SIZE),
-      HIT_LATENCY(other.HIT_LATENCY), FILL_LATENCY(other.FILL_LATENCY), OFFSET_BITS(other.OFFSET_BITS), block(std::move(other.block)), MAX_TAG(other.MAX_TAG),
+      HIT_LATENCY(other.HIT_LATENCY), FILL_LATENCY(other.FILL_LATENCY), OFFSET_BITS(other.OFFSET_BITS), block(std::move(other.block)), tag_store(std::move(other.tag_store)),
+      MAX_TAG(other.MAX_TAG),
       MAX_FILL(other.MAX_FILL), prefetch_as_load(other.prefetch_as_load), match_offset_bits(other.match_offset_bits), virtual_prefetch(other.virtual_prefetch),
       pref_activate_mask(std::move(other.pref_activate_mask)),
 
       sim_stats(std::move(other.sim_stats)), roi_stats(std::move(other.roi_stats)),
 
-      pref_module_pimpl(std::move(other.pref_module_pimpl)), repl_module_pimpl(std::move(other.repl_module_pimpl))
+      pref_module_pimpl(std::move(other.pref_module_pimpl)), repl_module_pimpl(std::move(other.repl_module_pimpl)),
+      replacement_shadows(std::move(other.replacement_shadows))
 {
+  replacement_shadow_slot = std::move(other.replacement_shadow_slot);
+  replacement_shadow_sets = other.replacement_shadow_sets;
+
   pref_module_pimpl->bind(this);
   repl_module_pimpl->bind(this);
+  for (auto& shadow : replacement_shadows) {
+    shadow.module->bind(this);
+  }
 }
 
 auto CACHE::operator=(CACHE&& other) -> CACHE&
@@ -74,6 +84,7 @@ auto CACHE::operator=(CACHE&& other) -> CACHE&
   this->OFFSET_BITS = other.OFFSET_BITS;
   ;
   this->block = std::move(other.block);
+  this->tag_store = std::move(other.tag_store);
   this->MAX_TAG = other.MAX_TAG;
   this->MAX_FILL = other.MAX_FILL;
   this->prefetch_as_load = other.prefetch_as_load;
@@ -86,9 +97,15 @@ auto CACHE::operator=(CACHE&& other) -> CACHE&
 
   this->pref_module_pimpl = std::move(other.pref_module_pimpl);
   this->repl_module_pimpl = std::move(other.repl_module_pimpl);
+  this->replacement_shadows = std::move(other.replacement_shadows);
+  this->replacement_shadow_slot = std::move(other.replacement_shadow_slot);
+  this->replacement_shadow_sets = other.replacement_shadow_sets;
 
   pref_module_pimpl->bind(this);
   repl_module_pimpl->bind(this);
+  for (auto& shadow : replacement_shadows) {
+    shadow.module->bind(this);
+  }
 
   return *this;
 }
@@ -108,8 +125,8 @@ CACHE::mshr_type::mshr_type(const tag_lookup_type& req, champsim::chrono::clock:
 
 CACHE::mshr_type CACHE::mshr_type::merge(mshr_type predecessor, mshr_type successor)
 {
-  std::vector<uint64_t> merged_instr{};
-  std::vector<std::deque<response_type>*> merged_return{};
+  champsim::channel::dependents_type merged_instr{};
+  champsim::channel::return_list_type merged_return{};
 
   std::set_union(std::begin(predecessor.instr_depend_on_me), std::end(predecessor.instr_depend_on_me), std::begin(successor.instr_depend_on_me),
                  std::end(successor.instr_depend_on_me), std::back_inserter(merged_instr));
@@ -121,8 +138,8 @@ CACHE::mshr_type CACHE::mshr_type::merge(mshr_type predecessor, mshr_type succes
   // set the time enqueued to the predecessor unless its a demand into prefetch, in which case we use the successor
   retval.time_enqueued =
       ((successor.type != access_type::PREFETCH && predecessor.type == access_type::PREFETCH)) ? successor.time_enqueued : predecessor.time_enqueued;
-  retval.instr_depend_on_me = merged_instr;
-  retval.to_return = merged_return;
+  retval.instr_depend_on_me = std::move(merged_instr);
+  retval.to_return = std::move(merged_return);
   retval.data_promise = predecessor.data_promise;
 
   if constexpr (champsim::debug_print) {
@@ -154,6 +171,8 @@ auto CACHE::fill_block(mshr_type mshr, uint32_t metadata) -> BLOCK
   return to_fill;
 }
 
+uint64_t CACHE::block_tag(champsim::address address) const { return address.slice_upper(OFFSET_BITS).to<uint64_t>(); }
+
 auto CACHE::matches_address(champsim::address addr) const
 {
   return [match = addr.slice_upper(OFFSET_BITS), shamt = OFFSET_BITS](const auto& entry) {
@@ -173,8 +192,9 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
   cpu = fill_mshr.cpu;
 
   // find victim
+  const auto set_idx = static_cast<std::size_t>(get_set_index(fill_mshr.address));
   auto [set_begin, set_end] = get_set_span(fill_mshr.address);
-  auto way = std::find_if_not(set_begin, set_end, [](auto x) { return x.valid; });
+  auto way = std::next(set_begin, static_cast<set_type::difference_type>(tag_store.first_invalid(set_idx)));
   if (way == set_end) {
     way = std::next(set_begin, impl_find_victim(fill_mshr.cpu, fill_mshr.instr_id, get_set_index(fill_mshr.address), &*set_begin, fill_mshr.ip,
                                                 fill_mshr.address, fill_mshr.type));
@@ -234,6 +254,7 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
     }
 
     *way = fill_block(fill_mshr, metadata_thru);
+    tag_store.assign(set_idx, static_cast<std::size_t>(way_idx), block_tag(way->address), true);
   }
 
   // COLLECT STATS
@@ -255,7 +276,8 @@ bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
 
   // access cache
   auto [set_begin, set_end] = get_set_span(handle_pkt.address);
-  auto way = std::find_if(set_begin, set_end, [matcher = matches_address(handle_pkt.address)](const auto& x) { return x.valid && matcher(x); });
+  auto way = std::next(set_begin, static_cast<set_type::difference_type>(
+                                      tag_store.find_valid(static_cast<std::size_t>(get_set_index(handle_pkt.address)), block_tag(handle_pkt.address))));
   const auto hit = (way != set_end);
   const auto useful_prefetch = (hit && way->prefetch && !handle_pkt.prefetch_from_this);
 
@@ -278,6 +300,7 @@ bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
 
   if (hit) {
     sim_stats.hits.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+    access_replacement_shadows(handle_pkt);
 
     response_type response{handle_pkt.address, handle_pkt.v_address, way->data, metadata_thru, handle_pkt.instr_depend_on_me};
     for (auto* ret : handle_pkt.to_return) {
@@ -335,14 +358,15 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
   auto mshr_pkt = mshr_and_forward_packet(handle_pkt);
 
   // check mshr
-  auto mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR), matches_address(handle_pkt.address));
+  auto mshr_slot = MSHR.find(block_tag(handle_pkt.address));
   bool mshr_full = (MSHR.size() == MSHR_SIZE);
 
-  if (mshr_entry != MSHR.end()) // miss already inflight
+  if (mshr_slot.has_value()) // miss already inflight
   {
-    if (mshr_entry->type == access_type::PREFETCH && handle_pkt.type != access_type::PREFETCH) {
+    auto& mshr_entry = MSHR[*mshr_slot];
+    if (mshr_entry.type == access_type::PREFETCH && handle_pkt.type != access_type::PREFETCH) {
       // Mark the prefetch as useful
-      if (mshr_entry->prefetch_from_this) {
+      if (mshr_entry.prefetch_from_this) {
         ++sim_stats.pf_useful;
       }
     }
@@ -350,7 +374,7 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
     // COLLECT STATS
     sim_stats.mshr_merge.increment(std::pair{to_allocate.type, to_allocate.cpu});
 
-    *mshr_entry = mshr_type::merge(*mshr_entry, to_allocate);
+    mshr_entry = mshr_type::merge(mshr_entry, to_allocate);
   } else {
     if (mshr_full) { // not enough MSHR resource
       return false;  // TODO should we allow prefetches anyway if they will not be filled to this level?
@@ -365,11 +389,12 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
 
     // Allocate an MSHR
     if (mshr_pkt.second.response_requested) {
-      MSHR.emplace_back(std::move(mshr_pkt.first));
+      MSHR.push_back(block_tag(mshr_pkt.first.address), std::move(mshr_pkt.first));
     }
   }
 
   sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  access_replacement_shadows(handle_pkt);
 
   return true;
 }
@@ -387,10 +412,111 @@ bool CACHE::handle_write(const tag_lookup_type& handle_pkt)
   inflight_writes.push_back(to_allocate);
 
   sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  access_replacement_shadows(handle_pkt);
 
   return true;
 }
 
+namespace
+{
+std::vector<long> sample_sets(std::size_t num_set, std::size_t count)
+{
+  std::vector<long> slots(num_set, -1);
+  for (std::size_t i = 0; i < count; ++i) {
+    slots.at(i * num_set / count) = static_cast<long>(i);
+  }
+  return slots;
+}
+} // namespace
+
+void CACHE::add_replacement_shadow(std::string name, std::unique_ptr<replacement_module_concept>&& module)
+{
+  if (std::empty(replacement_shadow_slot)) {
+    replacement_shadow_sets = std::min<std::size_t>(replacement_shadow_sets, NUM_SET);
+    replacement_shadow_slot = sample_sets(NUM_SET, replacement_shadow_sets);
+  }
+
+  for (auto* stats : {&sim_stats, &roi_stats}) {
+    stats->replacement_shadows.push_back({name});
+    stats->replacement_shadow_sets = replacement_shadow_sets;
+    stats->total_sets = NUM_SET;
+  }
+  replacement_shadows.push_back({std::move(name), std::move(module), std::vector<BLOCK>(replacement_shadow_sets * NUM_WAY)});
+}
+
+void CACHE::set_replacement_shadow_sets(std::size_t count)
+{
+  if (count == 0) {
+    throw std::invalid_argument{"At least one set must be sampled for the replacement shadows"};
+  }
+
+  replacement_shadow_sets = std::min<std::size_t>(count, NUM_SET);
+  replacement_shadow_slot = sample_sets(NUM_SET, replacement_shadow_sets);
+  for (auto& shadow : replacement_shadows) {
+    shadow.block.assign(replacement_shadow_sets * NUM_WAY, BLOCK{});
+  }
+  for (auto* stats : {&sim_stats, &roi_stats}) {
+    stats->replacement_shadow_sets = replacement_shadow_sets;
+  }
+}
+
+void CACHE::access_replacement_shadows(const tag_lookup_type& handle_pkt)
+{
+  if (std::empty(replacement_shadows)) {
+    return;
+  }
+
+  const auto set = get_set_index(handle_pkt.address);
+  const auto slot = replacement_shadow_slot.at(static_cast<std::size_t>(set));
+  if (slot < 0) {
+    return;
+  }
+
+  // The shadows fill at once, whenever the cache would eventually fill
+  const auto allocate = !handle_pkt.prefetch_from_this || !handle_pkt.skip_fill;
+  const auto tag = block_tag(handle_pkt.address);
+  for (std::size_t i = 0; i < std::size(replacement_shadows); ++i) {
+    auto& module = *replacement_shadows[i].module;
+    auto& stats = sim_stats.replacement_shadows.at(i);
+
+    auto set_begin = std::next(std::begin(replacement_shadows[i].block), slot * static_cast<long>(NUM_WAY));
+    auto set_end = std::next(set_begin, static_cast<long>(NUM_WAY));
+    auto way = std::find_if(set_begin, set_end, [tag, this](const BLOCK& x) { return x.valid && block_tag(x.address) == tag; });
+    const auto hit = (way != set_end);
+
+    module.impl_update_replacement_state(handle_pkt.cpu, set, std::distance(set_begin, way), module_address(handle_pkt), handle_pkt.ip, {}, handle_pkt.type,
+                                          hit);
+    if (hit) {
+      stats.hits.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+      continue;
+    }
+    stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+
+    if (allocate) {
+      way = std::find_if_not(set_begin, set_end, [](const BLOCK& x) { return x.valid; });
+      if (way == set_end) {
+        way = std::next(set_begin, module.impl_find_victim(handle_pkt.cpu, handle_pkt.instr_id, set, &*set_begin, handle_pkt.ip, handle_pkt.address,
+                                                            handle_pkt.type));
+      }
+
+      champsim::address evicting_address{};
+      if (way != set_end && way->valid) {
+        evicting_address = module_address(*way);
+      }
+      module.impl_replacement_cache_fill(handle_pkt.cpu, set, std::distance(set_begin, way), module_address(handle_pkt), handle_pkt.ip, evicting_address,
+                                          handle_pkt.type);
+
+      if (way != set_end) {
+        *way = BLOCK{};
+        way->valid = true;
+        way->prefetch = handle_pkt.prefetch_from_this;
+        way->address = handle_pkt.address;
+        way->v_address = handle_pkt.v_address;
+      }
+    }
+  }
+}
+
 template <bool UpdateRequest>
 auto CACHE::initiate_tag_check(champsim::channel* ul)
 {
@@ -444,13 +570,15 @@ long CACHE::operate()
 
   // Perform fills
   champsim::bandwidth fill_bw{MAX_FILL};
-  for (auto q : {std::ref(MSHR), std::ref(inflight_writes)}) {
-    auto [fill_begin, fill_end] = champsim::get_span_p(std::cbegin(q.get()), std::cend(q.get()), fill_bw,
-                                                       [time = current_time](const auto& x) { return x.data_promise.is_ready_at(time); });
-    auto complete_end = std::find_if_not(fill_begin, fill_end, [this](const auto& x) { return this->handle_fill(x); });
-    fill_bw.consume(std::distance(fill_begin, complete_end));
-    q.get().erase(fill_begin, complete_end);
+  while (fill_bw.has_remaining() && !std::empty(MSHR) && MSHR.front().data_promise.is_ready_at(current_time) && handle_fill(MSHR.front())) {
+    MSHR.pop_front();
+    fill_bw.consume();
   }
+  auto [fill_begin, fill_end] = champsim::get_span_p(std::cbegin(inflight_writes), std::cend(inflight_writes), fill_bw,
+                                                     [time = current_time](const auto& x) { return x.data_promise.is_ready_at(time); });
+  auto complete_end = std::find_if_not(fill_begin, fill_end, [this](const auto& x) { return this->handle_fill(x); });
+  fill_bw.consume(std::distance(fill_begin, complete_end));
+  inflight_writes.erase(fill_begin, complete_end);
 
   // Initiate tag checks
   const champsim::bandwidth::maximum_type bandwidth_from_tag_checks{champsim::to_underlying(MAX_TAG) * (long)(HIT_LATENCY / clock_period)
@@ -528,6 +656,60 @@ long CACHE::operate()
   return progress + fill_bw.amount_consumed() + initiate_tag_bw.amount_consumed() + tag_check_bw.amount_consumed();
 }
 
+champsim::chrono::clock::time_point CACHE::next_event_time() const
+{
+  const auto next_cycle = current_time + clock_period;
+
+  auto has_requests = [](const auto* ul) {
+    return !std::empty(ul->RQ) || !std::empty(ul->WQ) || !std::empty(ul->PQ);
+  };
+  if (std::any_of(std::begin(upper_levels), std::end(upper_levels), has_requests) || !std::empty(internal_PQ) || !std::empty(lower_level->returned)
+      || (lower_translate != nullptr && !std::empty(lower_translate->returned)) || !impl_prefetcher_cycle_idle()) {
+    return next_cycle;
+  }
+
+  // Translations that were refused by the lower level are retried every cycle
+  auto awaits_translation = [](const auto& entry) {
+    return entry.is_translated || !entry.translate_issued;
+  };
+  if (std::any_of(std::begin(translation_stash), std::end(translation_stash), awaits_translation)) {
+    return next_cycle;
+  }
+
+  auto next_event = champsim::chrono::clock::time_point::max();
+  for (const auto& entry : inflight_tag_check) {
+    if (entry.event_cycle <= current_time || (!entry.is_translated && !entry.translate_issued)) {
+      return next_cycle;
+    }
+    next_event = std::min(next_event, entry.event_cycle);
+  }
+
+  // Fills are taken in order from the front of each queue
+  auto front_ready_time = [&next_event](const auto& queue) {
+    return std::empty(queue) ? next_event : queue.front().data_promise.ready_time().value_or(next_event);
+  };
+  for (auto ready_time : {front_ready_time(MSHR), front_ready_time(inflight_writes)}) {
+    if (ready_time <= current_time) {
+      return next_cycle;
+    }
+    next_event = std::min(next_event, ready_time);
+  }
+
+  return std::max(next_event, next_cycle);
+}
+
+void CACHE::idle_cycles(long cycles)
+{
+  // operate() shares the tag bandwidth among the upper levels in turn, whether or not any of them has a request
+  if (std::size(upper_levels) > 1) {
+    std::rotate(upper_levels.begin(), std::next(upper_levels.begin(), cycles % static_cast<long>(std::size(upper_levels))), upper_levels.end());
+  }
+}
+
+std::vector<const champsim::channel*> CACHE::upper_channels() const { return {std::begin(upper_levels), std::end(upper_levels)}; }
+
+std::vector<const champsim::channel*> CACHE::lower_channels() const { return {lower_level, lower_translate}; }
+
 // LCOV_EXCL_START exclude deprecated function
 uint64_t CACHE::get_set(uint64_t address) const { return static_cast<uint64_t>(get_set_index(champsim::address{address})); }
 // LCOV_EXCL_STOP
@@ -559,21 +741,21 @@ auto CACHE::get_set_span(champsim::address address) const -> std::pair<set_type:
 uint64_t CACHE::get_way(uint64_t address, uint64_t /*unused set index*/) const
 {
   champsim::address intern_addr{address};
-  auto [begin, end] = get_set_span(intern_addr);
-  return static_cast<uint64_t>(std::distance(begin, std::find_if(begin, end, matches_address(champsim::address{address}))));
+  return tag_store.find_any(static_cast<std::size_t>(get_set_index(intern_addr)), block_tag(intern_addr));
 }
 // LCOV_EXCL_STOP
 
 long CACHE::invalidate_entry(champsim::address inval_addr)
 {
-  auto [begin, end] = get_set_span(inval_addr);
-  auto inv_way = std::find_if(begin, end, matches_address(inval_addr));
+  const auto set_idx = static_cast<std::size_t>(get_set_index(inval_addr));
+  const auto inv_way = tag_store.find_any(set_idx, block_tag(inval_addr));
 
-  if (inv_way != end) {
-    inv_way->valid = false;
+  if (inv_way != NUM_WAY) {
+    block.at(set_idx * NUM_WAY + inv_way).valid = false;
+    tag_store.set_valid(set_idx, inv_way, false);
   }
 
-  return std::distance(begin, inv_way);
+  return static_cast<long>(inv_way);
 }
 
 bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint32_t prefetch_metadata)
@@ -613,14 +795,14 @@ bool CACHE::prefetch_line(uint64_t /*deprecated*/, uint64_t /*deprecated*/, uint
 void CACHE::finish_packet(const response_type& packet)
 {
   // check MSHR information
-  auto mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR), matches_address(packet.address));
-  auto first_unreturned = std::find_if(MSHR.begin(), MSHR.end(), [](auto x) { return x.data_promise.has_unknown_readiness(); });
+  auto mshr_slot = MSHR.find(block_tag(packet.address));
 
   // sanity check
-  if (mshr_entry == MSHR.end()) {
+  if (!mshr_slot.has_value()) {
     fmt::print(stderr, "[{}_MSHR] {} cannot find a matching entry! address: {} v_address: {}\n", NAME, __func__, packet.address, packet.v_address);
     assert(0);
   }
+  auto mshr_entry = &MSHR[*mshr_slot];
 
   // MSHR holds the most updated information about this request
   mshr_type::returned_value finished_value{packet.data, packet.pf_metadata};
@@ -632,7 +814,7 @@ void CACHE::finish_packet(const response_type& packet)
 
   // Order this entry after previously-returned entries, but before non-returned
   // entries
-  std::iter_swap(mshr_entry, first_unreturned);
+  MSHR.mark_returned(*mshr_slot);
 }
 
 void CACHE::finish_translation(const response_type& packet)
@@ -817,6 +999,8 @@ uint32_t CACHE::impl_prefetcher_cache_fill(champsim::address addr, long set, lon
 
 void CACHE::impl_prefetcher_cycle_operate() const { pref_module_pimpl->impl_prefetcher_cycle_operate(); }
 
+bool CACHE::impl_prefetcher_cycle_idle() const { return pref_module_pimpl->impl_prefetcher_cycle_idle(); }
+
 void CACHE::impl_prefetcher_final_stats() const { pref_module_pimpl->impl_prefetcher_final_stats(); }
 
 void CACHE::impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target) const
@@ -852,6 +1036,9 @@ void CACHE::initialize()
 {
   impl_prefetcher_initialize();
   impl_initialize_replacement();
+  for (auto& shadow : replacement_shadows) {
+    shadow.module->impl_initialize_replacement();
+  }
 }
 
 void CACHE::begin_phase()
@@ -862,6 +1049,14 @@ void CACHE::begin_phase()
   new_roi_stats.name = NAME;
   new_sim_stats.name = NAME;
 
+  for (auto* stats : {&new_roi_stats, &new_sim_stats}) {
+    for (const auto& shadow : replacement_shadows) {
+      stats->replacement_shadows.push_back({shadow.name});
+    }
+    stats->replacement_shadow_sets = std::empty(replacement_shadows) ? 0 : replacement_shadow_sets;
+    stats->total_sets = NUM_SET;
+  }
+
   roi_stats = new_roi_stats;
   sim_stats = new_sim_stats;
 
@@ -889,6 +1084,8 @@ void CACHE::end_phase(unsigned finished_cpu)
   roi_stats.pf_useless = sim_stats.pf_useless;
   roi_stats.pf_fill = sim_stats.pf_fill;
 
+  roi_stats.replacement_shadows = sim_stats.replacement_shadows;
+
   for (auto* ul : upper_levels) {
     ul->roi_stats.RQ_ACCESS = ul->sim_stats.RQ_ACCESS;
     ul->roi_stats.RQ_MERGED = ul->sim_stats.RQ_MERGED;
@@ -946,13 +1143,38 @@ auto CACHE::checkpoint_contents() const -> std::vector<checkpoint_entry>
   return entries;
 }
 
-void CACHE::restore_checkpoint(const std::vector<checkpoint_entry>& entries)
+void CACHE::clear_inflight_for_checkpoint()
 {
   MSHR.clear();
   inflight_writes.clear();
   internal_PQ.clear();
   inflight_tag_check.clear();
   translation_stash.clear();
+}
+
+void CACHE::rebuild_tag_store()
+{
+  for (std::size_t set = 0; set < NUM_SET; ++set) {
+    for (std::size_t way = 0; way < NUM_WAY; ++way) {
+      const auto& blk = block.at(set * NUM_WAY + way);
+      tag_store.assign(set, way, block_tag(blk.address), blk.valid);
+    }
+  }
+}
+
+void CACHE::replay_checkpoint_fill(long set, long way, const BLOCK& blk)
+{
+  auto module_addr = virtual_prefetch ? blk.v_address : blk.address;
+  auto trimmed_addr = module_addr.slice_upper(match_offset_bits ? champsim::data::bits{} : OFFSET_BITS);
+  champsim::address cache_addr{trimmed_addr};
+
+  auto type = blk.prefetch ? access_type::PREFETCH : (blk.dirty ? access_type::WRITE : access_type::LOAD);
+  impl_replacement_cache_fill(cpu, set, way, cache_addr, champsim::address{}, champsim::address{}, type);
+}
+
+void CACHE::restore_checkpoint(const std::vector<checkpoint_entry>& entries)
+{
+  clear_inflight_for_checkpoint();
 
   for (auto& blk : block) {
     blk = BLOCK{};
@@ -972,17 +1194,106 @@ void CACHE::restore_checkpoint(const std::vector<checkpoint_entry>& entries)
     const auto block_index = static_cast<std::size_t>(entry.set) * static_cast<std::size_t>(NUM_WAY) + static_cast<std::size_t>(entry.way);
     block.at(block_index) = entry.block;
 
-    if (!entry.block.valid) {
-      continue;
+    if (entry.block.valid) {
+      replay_checkpoint_fill(entry.set, entry.way, entry.block);
     }
+  }
 
-    auto module_addr = virtual_prefetch ? entry.block.v_address : entry.block.address;
-    auto trimmed_addr = module_addr.slice_upper(match_offset_bits ? champsim::data::bits{} : OFFSET_BITS);
-    champsim::address cache_addr{trimmed_addr};
+  rebuild_tag_store();
+}
 
-    auto type = entry.block.prefetch ? access_type::PREFETCH : (entry.block.dirty ? access_type::WRITE : access_type::LOAD);
-    impl_replacement_cache_fill(cpu, entry.set, entry.way, cache_addr, champsim::address{}, champsim::address{}, type);
+void CACHE::restore_checkpoint(std::vector<BLOCK>&& contents)
+{
+  if (std::size(contents) != std::size(block)) {
+    throw std::length_error(fmt::format("[{}] checkpoint holds {} blocks, expected {}", NAME, std::size(contents), std::size(block)));
   }
+
+  clear_inflight_for_checkpoint();
+  block = std::move(contents);
+  rebuild_tag_store();
+
+  impl_initialize_replacement();
+
+  for (long set = 0; set < NUM_SET; ++set) {
+    auto [set_begin, set_end] = get_span(std::cbegin(block), static_cast<set_type::difference_type>(set), NUM_WAY);
+    for (auto way = set_begin; way != set_end; ++way) {
+      if (way->valid) {
+        replay_checkpoint_fill(set, static_cast<long>(std::distance(set_begin, way)), *way);
+      }
+    }
+  }
+}
+
+namespace
+{
+template <typename M>
+std::pair<std::string, std::string> module_checkpoint(M& module)
+{
+  std::ostringstream stream;
+  champsim::serialization::output_archive ar{stream};
+  module.impl_save_state(ar);
+  return {typeid(module).name(), stream.str()};
+}
+
+template <typename M>
+void restore_module_checkpoint(M& module, const std::pair<std::string, std::string>& checkpoint)
+{
+  if (checkpoint.first == typeid(module).name()) {
+    std::istringstream stream{checkpoint.second};
+    champsim::serialization::input_archive ar{stream};
+    module.impl_load_state(ar);
+  }
+}
+} // namespace
+
+std::string CACHE::checkpoint_module_state() const
+{
+  std::ostringstream stream;
+  champsim::serialization::output_archive ar{stream};
+  ar(module_checkpoint(*pref_module_pimpl), module_checkpoint(*repl_module_pimpl));
+  return stream.str();
+}
+
+void CACHE::restore_checkpoint_module_state(const std::string& state)
+{
+  std::pair<std::string, std::string> pref_checkpoint;
+  std::pair<std::string, std::string> repl_checkpoint;
+  std::istringstream stream{state};
+  champsim::serialization::input_archive ar{stream};
+  ar(pref_checkpoint, repl_checkpoint);
+
+  restore_module_checkpoint(*pref_module_pimpl, pref_checkpoint);
+  restore_module_checkpoint(*repl_module_pimpl, repl_checkpoint);
+}
+
+void CACHE::save_state(champsim::serialization::output_archive& ar)
+{
+  ar(block);
+  pref_module_pimpl->impl_save_state(ar);
+  repl_module_pimpl->impl_save_state(ar);
+}
+
+void CACHE::load_state(champsim::serialization::input_archive& ar)
+{
+  set_type contents;
+  ar(contents);
+  if (std::size(contents) != std::size(block)) {
+    throw std::length_error(fmt::format("[{}] snapshot holds {} blocks, expected {}", NAME, std::size(contents), std::size(block)));
+  }
+
+  clear_inflight_for_checkpoint();
+  block = std::move(contents);
+  rebuild_tag_store();
+
+  // Requests to the lower levels are discarded. Each upper level discards its own requests to this one
+  lower_level->clear();
+  if (lower_translate != nullptr) {
+    lower_translate->clear();
+  }
+
+  // Modules without a serialize() member keep whatever state they had
+  pref_module_pimpl->impl_load_state(ar);
+  repl_module_pimpl->impl_load_state(ar);
 }
 
 // LCOV_EXCL_START Exclude the following function from LCOV
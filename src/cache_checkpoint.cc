@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -9,6 +10,10 @@
 #include <unordered_map>
 #include <vector>
 #include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <fmt/core.h>
 #include <fmt/ostream.h>
 
@@ -52,18 +57,91 @@ champsim::address parse_address_token(const std::string& token)
 
   return champsim::address{value};
 }
-} // namespace
 
-namespace champsim
+/**
+ * A read-only, private mapping of a whole file. The mapping is released when the object is destroyed.
+ */
+class mapped_file
 {
-void save_cache_checkpoint(environment& env, const std::filesystem::path& file_path)
+  void* base = MAP_FAILED;
+  std::size_t length = 0;
+
+public:
+  explicit mapped_file(const std::filesystem::path& file_path)
+  {
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error(fmt::format("Unable to open '{}' for reading cache checkpoint", file_path.string()));
+    }
+
+    struct stat file_stat {
+    };
+    if (::fstat(fd, &file_stat) != 0) {
+      ::close(fd);
+      throw std::runtime_error(fmt::format("Unable to stat cache checkpoint '{}'", file_path.string()));
+    }
+
+    length = static_cast<std::size_t>(file_stat.st_size);
+    if (length > 0) {
+      base = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+
+    if (length > 0 && base == MAP_FAILED) {
+      throw std::runtime_error(fmt::format("Unable to map cache checkpoint '{}'", file_path.string()));
+    }
+
+    if (base != MAP_FAILED) {
+      ::madvise(base, length, MADV_SEQUENTIAL);
+    }
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  ~mapped_file()
+  {
+    if (base != MAP_FAILED) {
+      ::munmap(base, length);
+    }
+  }
+
+  [[nodiscard]] const unsigned char* data() const { return static_cast<const unsigned char*>(base); }
+  [[nodiscard]] std::size_t size() const { return length; }
+
+  template <typename T>
+  [[nodiscard]] T read_at(std::size_t offset, const std::filesystem::path& file_path) const
+  {
+    if (offset > length || length - offset < sizeof(T)) {
+      throw std::runtime_error(fmt::format("Cache checkpoint '{}' is truncated at offset {}", file_path.string(), offset));
+    }
+
+    T result;
+    std::memcpy(&result, data() + offset, sizeof(T));
+    return result;
+  }
+};
+
+bool has_binary_magic(const std::filesystem::path& file_path)
+{
+  std::ifstream in_file{file_path, std::ios::binary};
+  if (!in_file.is_open()) {
+    throw std::runtime_error(fmt::format("Unable to open '{}' for reading cache checkpoint", file_path.string()));
+  }
+
+  char file_magic[sizeof(champsim::checkpoint::magic)] = {};
+  in_file.read(file_magic, sizeof(file_magic));
+  return in_file.gcount() == sizeof(file_magic) && std::memcmp(file_magic, champsim::checkpoint::magic, sizeof(file_magic)) == 0;
+}
+
+void save_text(const std::vector<std::reference_wrapper<CACHE>>& caches, const std::filesystem::path& file_path)
 {
   std::ofstream out_file{file_path};
   if (!out_file.is_open()) {
     throw std::runtime_error(fmt::format("Unable to open '{}' for writing cache checkpoint", file_path.string()));
   }
 
-  for (const CACHE& cache : env.cache_view()) {
+  for (const CACHE& cache : caches) {
     fmt::print(out_file, "Cache: {}\n", cache.NAME);
     for (const auto& entry : cache.checkpoint_contents()) {
       fmt::print(out_file, "  Set: {} Way: {} Address: {}\n", entry.set, entry.way, entry.block.address);
@@ -72,7 +150,142 @@ void save_cache_checkpoint(environment& env, const std::filesystem::path& file_p
   }
 }
 
-void load_cache_checkpoint(environment& env, const std::filesystem::path& file_path)
+void save_binary(const std::vector<std::reference_wrapper<CACHE>>& caches, const std::filesystem::path& file_path)
+{
+  using namespace champsim::checkpoint;
+
+  std::ofstream out_file{file_path, std::ios::binary | std::ios::trunc};
+  if (!out_file.is_open()) {
+    throw std::runtime_error(fmt::format("Unable to open '{}' for writing cache checkpoint", file_path.string()));
+  }
+
+  file_header header{};
+  std::copy(std::begin(magic), std::end(magic), std::begin(header.magic));
+  header.version = version;
+  header.section_count = static_cast<uint32_t>(std::size(caches));
+
+  std::vector<std::string> module_states;
+  std::transform(std::cbegin(caches), std::cend(caches), std::back_inserter(module_states),
+                 [](const CACHE& cache) { return cache.checkpoint_module_state(); });
+
+  std::vector<section_header> sections;
+  auto record_offset = sizeof(file_header) + std::size(caches) * sizeof(section_header);
+  for (const CACHE& cache : caches) {
+    if (std::size(cache.NAME) >= max_name_length) {
+      throw std::runtime_error(fmt::format("Cache name '{}' is too long for the checkpoint section table", cache.NAME));
+    }
+
+    section_header& section = sections.emplace_back();
+    std::copy(std::begin(cache.NAME), std::end(cache.NAME), std::begin(section.name));
+    section.num_set = cache.NUM_SET;
+    section.num_way = cache.NUM_WAY;
+    section.record_offset = record_offset;
+    section.record_count = std::size(cache.block);
+    record_offset += std::size(cache.block) * sizeof(block_record);
+  }
+
+  // The module state follows every block record
+  auto module_state_offset = record_offset;
+  for (std::size_t i = 0; i < std::size(sections); ++i) {
+    sections.at(i).module_state_offset = module_state_offset;
+    sections.at(i).module_state_size = std::size(module_states.at(i));
+    module_state_offset += std::size(module_states.at(i));
+  }
+
+  out_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out_file.write(reinterpret_cast<const char*>(std::data(sections)), static_cast<std::streamsize>(std::size(sections) * sizeof(section_header)));
+
+  std::vector<block_record> records;
+  for (const CACHE& cache : caches) {
+    records.clear();
+    std::transform(std::cbegin(cache.block), std::cend(cache.block), std::back_inserter(records), [](const CACHE::BLOCK& blk) {
+      block_record record{};
+      record.address = blk.address.to<uint64_t>();
+      record.v_address = blk.v_address.to<uint64_t>();
+      record.data = blk.data.to<uint64_t>();
+      record.pf_metadata = blk.pf_metadata;
+      record.valid = blk.valid;
+      record.prefetch = blk.prefetch;
+      record.dirty = blk.dirty;
+      return record;
+    });
+    out_file.write(reinterpret_cast<const char*>(std::data(records)), static_cast<std::streamsize>(std::size(records) * sizeof(block_record)));
+  }
+
+  for (const auto& state : module_states) {
+    out_file.write(std::data(state), static_cast<std::streamsize>(std::size(state)));
+  }
+
+  if (!out_file) {
+    throw std::runtime_error(fmt::format("Failed while writing cache checkpoint '{}'", file_path.string()));
+  }
+}
+
+void load_binary(const std::vector<std::reference_wrapper<CACHE>>& caches, const std::filesystem::path& file_path)
+{
+  using namespace champsim::checkpoint;
+
+  mapped_file mapping{file_path};
+
+  auto header = mapping.read_at<file_header>(0, file_path);
+  if (header.version != version) {
+    throw std::runtime_error(fmt::format("Cache checkpoint '{}' has version {}, expected {}", file_path.string(), header.version, version));
+  }
+
+  std::unordered_map<std::string, section_header> sections;
+  for (std::size_t i = 0; i < header.section_count; ++i) {
+    auto section = mapping.read_at<section_header>(sizeof(file_header) + i * sizeof(section_header), file_path);
+    std::string name{section.name, strnlen(section.name, max_name_length)};
+    sections.insert_or_assign(std::move(name), section);
+  }
+
+  for (CACHE& cache : caches) {
+    auto it = sections.find(cache.NAME);
+    if (it == std::end(sections)) {
+      cache.restore_checkpoint(std::vector<CACHE::checkpoint_entry>{});
+      continue;
+    }
+
+    const auto& section = it->second;
+    if (section.num_set != cache.NUM_SET || section.num_way != cache.NUM_WAY || section.record_count != section.num_set * section.num_way) {
+      throw std::runtime_error(fmt::format("Cache checkpoint '{}' holds {} sets and {} ways for {}, but the cache has {} sets and {} ways",
+                                           file_path.string(), section.num_set, section.num_way, cache.NAME, cache.NUM_SET, cache.NUM_WAY));
+    }
+
+    const auto section_bytes = section.record_count * sizeof(block_record);
+    if (section.record_offset > mapping.size() || mapping.size() - section.record_offset < section_bytes) {
+      throw std::runtime_error(fmt::format("Cache checkpoint '{}' is truncated in the section for {}", file_path.string(), cache.NAME));
+    }
+
+    std::vector<CACHE::BLOCK> contents(section.record_count);
+    auto record_ptr = mapping.data() + section.record_offset;
+    for (auto& blk : contents) {
+      block_record record;
+      std::memcpy(&record, record_ptr, sizeof(block_record));
+      record_ptr += sizeof(block_record);
+
+      blk.valid = record.valid != 0;
+      blk.prefetch = record.prefetch != 0;
+      blk.dirty = record.dirty != 0;
+      blk.address = champsim::address{record.address};
+      blk.v_address = champsim::address{record.v_address};
+      blk.data = champsim::address{record.data};
+      blk.pf_metadata = record.pf_metadata;
+    }
+
+    cache.restore_checkpoint(std::move(contents));
+
+    if (section.module_state_offset > mapping.size() || mapping.size() - section.module_state_offset < section.module_state_size) {
+      throw std::runtime_error(fmt::format("Cache checkpoint '{}' is truncated in the module state for {}", file_path.string(), cache.NAME));
+    }
+    if (section.module_state_size > 0) {
+      std::string state{reinterpret_cast<const char*>(mapping.data() + section.module_state_offset), section.module_state_size};
+      cache.restore_checkpoint_module_state(state);
+    }
+  }
+}
+
+void load_text(const std::vector<std::reference_wrapper<CACHE>>& caches, const std::filesystem::path& file_path)
 {
   std::ifstream in_file{file_path};
   if (!in_file.is_open()) {
@@ -160,13 +373,41 @@ void load_cache_checkpoint(environment& env, const std::filesystem::path& file_p
     throw std::runtime_error(fmt::format("Checkpoint parse error on line {}: unexpected token '{}'", line_number, token));
   }
 
-  for (CACHE& cache : env.cache_view()) {
+  for (CACHE& cache : caches) {
     auto it = checkpoints.find(cache.NAME);
     if (it != std::end(checkpoints)) {
       cache.restore_checkpoint(it->second);
     } else {
-      cache.restore_checkpoint({});
+      cache.restore_checkpoint(std::vector<CACHE::checkpoint_entry>{});
     }
   }
 }
+} // namespace
+
+namespace champsim
+{
+void save_cache_checkpoint(const std::vector<std::reference_wrapper<CACHE>>& caches, const std::filesystem::path& file_path, checkpoint_format format)
+{
+  if (format == checkpoint_format::text) {
+    save_text(caches, file_path);
+  } else {
+    save_binary(caches, file_path);
+  }
+}
+
+void save_cache_checkpoint(environment& env, const std::filesystem::path& file_path, checkpoint_format format)
+{
+  save_cache_checkpoint(env.cache_view(), file_path, format);
+}
+
+void load_cache_checkpoint(const std::vector<std::reference_wrapper<CACHE>>& caches, const std::filesystem::path& file_path)
+{
+  if (has_binary_magic(file_path)) {
+    load_binary(caches, file_path);
+  } else {
+    load_text(caches, file_path);
+  }
+}
+
+void load_cache_checkpoint(environment& env, const std::filesystem::path& file_path) { load_cache_checkpoint(env.cache_view(), file_path); }
 } // namespace champsim
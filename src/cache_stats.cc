@@ -1,5 +1,7 @@
 #include "cache_stats.h"
 
+#include <algorithm>
+
 cache_stats operator-(cache_stats lhs, cache_stats rhs)
 {
   cache_stats result;
@@ -13,5 +15,13 @@ cache_stats operator-(cache_stats lhs, cache_stats rhs)
   result.misses = lhs.misses - rhs.misses;
 
   result.total_miss_latency_cycles = lhs.total_miss_latency_cycles - rhs.total_miss_latency_cycles;
+
+  result.replacement_shadows = lhs.replacement_shadows;
+  result.replacement_shadow_sets = lhs.replacement_shadow_sets;
+  result.total_sets = lhs.total_sets;
+  for (std::size_t i = 0; i < std::min(std::size(result.replacement_shadows), std::size(rhs.replacement_shadows)); ++i) {
+    result.replacement_shadows[i].hits = lhs.replacement_shadows[i].hits - rhs.replacement_shadows[i].hits;
+    result.replacement_shadows[i].misses = lhs.replacement_shadows[i].misses - rhs.replacement_shadows[i].misses;
+  }
   return result;
 }
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <chrono>
 #include <numeric>
+#include <optional>
 #include <vector>
 #include <fmt/chrono.h>
 #include <fmt/core.h>
@@ -27,6 +28,8 @@
 #include "environment.h"
 #include "ooo_cpu.h"
 #include "operable.h"
+#include "operable_scheduler.h"
+#include "parallel_engine.h"
 #include "phase_info.h"
 #include "tracereader.h"
 
@@ -38,29 +41,98 @@ std::chrono::seconds elapsed_time() { return std::chrono::duration_cast<std::chr
 
 namespace champsim
 {
-long do_cycle(environment& env, std::vector<tracereader>& traces, std::vector<std::size_t> trace_index, champsim::chrono::clock& global_clock)
+void fill_input_queue(O3_CPU& cpu, tracereader& trace)
 {
-  auto operables = env.operable_view();
-  std::sort(std::begin(operables), std::end(operables),
-            [](const champsim::operable& lhs, const champsim::operable& rhs) { return lhs.current_time < rhs.current_time; });
+  for (auto pkt_count = cpu.IN_QUEUE_SIZE - static_cast<long>(std::size(cpu.input_queue)); !trace.eof() && pkt_count > 0; --pkt_count) {
+    cpu.input_queue.push_back(trace());
+  }
+}
 
+long do_cycle(environment& env, operable_scheduler& scheduler, parallel_engine* engine, std::vector<tracereader>& traces,
+              const std::vector<std::size_t>& trace_index, champsim::chrono::clock& global_clock)
+{
   // Operate
-  long progress{0};
-  for (champsim::operable& op : operables) {
-    progress += op.operate_on(global_clock);
-  }
+  long progress = (engine != nullptr) ? engine->operate_on(scheduler, global_clock) : scheduler.operate_on(global_clock);
 
   // Read from trace
   for (O3_CPU& cpu : env.cpu_view()) {
-    auto& trace = traces.at(trace_index.at(cpu.cpu));
-    for (auto pkt_count = cpu.IN_QUEUE_SIZE - static_cast<long>(std::size(cpu.input_queue)); !trace.eof() && pkt_count > 0; --pkt_count) {
-      cpu.input_queue.push_back(trace());
-    }
+    fill_input_queue(cpu, traces.at(trace_index.at(cpu.cpu)));
   }
 
   return progress;
 }
 
+/**
+ * Pass over the cycles in which no component can make progress, as if each had been operated.
+ * This must only be called once every component has operated, without progress, since the last cycle in which any component made progress.
+ *
+ * :param limit: The largest number of time quanta that may be passed over
+ * :returns: The number of time quanta passed over
+ */
+long skip_idle_cycles(const operable_scheduler& scheduler, champsim::chrono::clock& global_clock, champsim::chrono::clock::duration time_quantum, long limit)
+{
+  const auto& operables = scheduler.operables();
+  const auto next_event = std::accumulate(std::cbegin(operables), std::cend(operables), champsim::chrono::clock::time_point::max(),
+                                          [](const auto acc, const operable& op) { return std::min(acc, op.next_event_time()); });
+
+  // Each component may only pass over its cycles that come strictly before the next event
+  auto horizon = global_clock.now() + limit * time_quantum;
+  for (const champsim::operable& op : operables) {
+    auto last_idle_cycle = op.current_time;
+    if (next_event > op.current_time) {
+      last_idle_cycle += ((next_event - op.current_time - champsim::chrono::picoseconds{1}) / op.clock_period) * op.clock_period;
+    }
+    horizon = std::min(horizon, last_idle_cycle);
+  }
+
+  const long skipped = horizon > global_clock.now() ? static_cast<long>((horizon - global_clock.now()) / time_quantum) : 0;
+  if (skipped > 0) {
+    global_clock.tick(skipped * time_quantum);
+    for (champsim::operable& op : operables) {
+      op.idle_on(global_clock);
+    }
+  }
+
+  return skipped;
+}
+
+namespace
+{
+/**
+ * While the cores run ahead, each reads its trace on its own thread, so the traces cannot share a counter of instruction IDs.
+ * For as long as this lives, each trace draws from a counter of its own, starting from its shared counter. The IDs are then unique only
+ * within each core, but they do not depend on the order in which the threads run. Afterwards, each shared counter resumes past every ID
+ * that was drawn.
+ */
+class private_instr_ids
+{
+  std::vector<tracereader>& traces;
+  std::vector<uint64_t*> shared;
+  std::vector<uint64_t> counters;
+
+public:
+  explicit private_instr_ids(std::vector<tracereader>& traces_) : traces(traces_), counters(std::size(traces_))
+  {
+    for (std::size_t i = 0; i < std::size(traces); ++i) {
+      shared.push_back(&traces.at(i).instr_id_counter());
+      counters.at(i) = *shared.back();
+      traces.at(i).use_instr_ids(counters.at(i));
+    }
+  }
+
+  private_instr_ids(const private_instr_ids&) = delete;
+  private_instr_ids& operator=(const private_instr_ids&) = delete;
+
+  ~private_instr_ids()
+  {
+    for (std::size_t i = 0; i < std::size(traces); ++i) {
+      *shared.at(i) = std::max(*shared.at(i), counters.at(i));
+      traces.at(i).use_instr_ids(*shared.at(i));
+    }
+  }
+};
+} // namespace
+
 phase_stats do_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock)
 {
   auto operables = env.operable_view();
@@ -78,6 +150,8 @@ phase_stats do_phase(const phase_info& phase, environment& env, std::vector<trac
 
   const auto time_quantum = std::accumulate(std::cbegin(operables), std::cend(operables), champsim::chrono::clock::duration::max(),
                                             [](const auto acc, const operable& y) { return std::min(acc, y.clock_period); });
+  const auto slowest_period = std::accumulate(std::cbegin(operables), std::cend(operables), champsim::chrono::clock::duration::zero(),
+                                              [](const auto acc, const operable& y) { return std::max(acc, y.clock_period); });
 
   bool livelock_trigger{false};
   uint64_t livelock_period{10000000};
@@ -86,23 +160,58 @@ phase_stats do_phase(const phase_info& phase, environment& env, std::vector<trac
   std::vector<double> livelock_threshold{0.01, 0.02, 0.05};
   std::vector<uint64_t> livelock_instr(std::size(env.cpu_view()), 0);
 
+  // The private components of the cores may be operated on other threads
+  std::optional<parallel_engine> engine;
+  if (phase.num_threads > 1) {
+    engine.emplace(phase.num_threads);
+  }
+  operable_scheduler scheduler = engine.has_value() ? operable_scheduler{operables, core_partitions(env)} : operable_scheduler{operables};
+  const long quanta_per_iteration = engine.has_value() ? std::max(phase.parallel_slack, 1L) : 1L;
+  std::optional<private_instr_ids> run_ahead_instr_ids;
+  if (quanta_per_iteration > 1) {
+    run_ahead_instr_ids.emplace(traces);
+  }
+
+  auto cpus = env.cpu_view();
+  auto fill_partition_input = [&cpus, &traces, &trace_index](std::size_t partition) {
+    O3_CPU& cpu = cpus.at(partition);
+    fill_input_queue(cpu, traces.at(trace_index.at(cpu.cpu)));
+  };
+
   // Perform phase
   int stalled_cycle{0};
   std::vector<bool> phase_complete(std::size(env.cpu_view()), false);
   while (!std::accumulate(std::begin(phase_complete), std::end(phase_complete), true, std::logical_and{})) {
     auto next_phase_complete = phase_complete;
-    global_clock.tick(time_quantum);
 
-    auto progress = do_cycle(env, traces, trace_index, global_clock);
+    long progress{0};
+    if (quanta_per_iteration > 1) {
+      progress = engine->run_ahead(scheduler, global_clock, time_quantum, quanta_per_iteration, fill_partition_input);
+    } else {
+      global_clock.tick(time_quantum);
+      progress = do_cycle(env, scheduler, engine.has_value() ? &engine.value() : nullptr, traces, trace_index, global_clock);
+    }
 
     if (progress == 0) {
-      ++stalled_cycle;
+      stalled_cycle += static_cast<int>(quanta_per_iteration);
     } else {
       stalled_cycle = 0;
     }
 
     // Livelock detect, every livelock_period cycles, check progress and alert the user
-    livelock_timer++;
+    livelock_timer += static_cast<uint64_t>(quanta_per_iteration);
+
+    // If nothing has happened for long enough that every component has seen the last change, jump to the next cycle in which something can.
+    // The input queues have just been filled, so no trace is read in the meantime.
+    // Stop short of the deadlock and livelock checks, so that they are made on the same cycles as before.
+    if (progress == 0 && phase.skip_idle_cycles && quanta_per_iteration == 1 && stalled_cycle * time_quantum >= slowest_period
+        && livelock_timer < livelock_period) {
+      auto skipped = skip_idle_cycles(scheduler, global_clock, time_quantum,
+                                      std::min<long>(DEADLOCK_CYCLE - 1 - stalled_cycle, static_cast<long>(livelock_period - 1 - livelock_timer)));
+      stalled_cycle += static_cast<int>(skipped);
+      livelock_timer += static_cast<uint64_t>(skipped);
+    }
+
     if (livelock_timer >= livelock_period) {
       // for each cpu
       for (O3_CPU& cpu : env.cpu_view()) {
@@ -172,7 +281,6 @@ phase_stats do_phase(const phase_info& phase, environment& env, std::vector<trac
     stats.trace_names.push_back(trace_names.at(trace_index.at(i)));
   }
 
-  auto cpus = env.cpu_view();
   std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.sim_cpu_stats), [](const O3_CPU& cpu) { return cpu.sim_stats; });
   std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.roi_cpu_stats), [](const O3_CPU& cpu) { return cpu.roi_stats; });
 
@@ -212,7 +320,7 @@ std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases,
     auto stats = do_phase(phase, env, traces, global_clock);
 
     if (phase.cache_checkpoint_out) {
-      save_cache_checkpoint(env, *phase.cache_checkpoint_out);
+      save_cache_checkpoint(env, *phase.cache_checkpoint_out, phase.cache_checkpoint_format);
       checkpoint_written_this_run = true;
     }
 
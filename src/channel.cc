@@ -16,6 +16,7 @@
 
 #include "channel.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fmt/core.h>
 
@@ -29,16 +30,55 @@ champsim::channel::channel(std::size_t rq_size, std::size_t pq_size, std::size_t
 {
 }
 
+namespace
+{
+uint64_t collision_key(champsim::address addr, champsim::data::bits shamt) { return addr.slice_upper(shamt).to<uint64_t>(); }
+} // namespace
+
+void champsim::channel::collision_index::sync(const std::deque<request>& queue, std::size_t num_checked, champsim::data::bits shamt)
+{
+  // Blocks whose packets have all left the queue are only dropped when they are looked up again, so rebuild the index if they dominate it.
+  // Also rebuild if packets were checked without being indexed.
+  if (std::size(positions) > 2 * num_checked + 16 || num_checked > num_indexed) {
+    positions.clear();
+    num_indexed = 0;
+    std::for_each(std::begin(queue), std::next(std::begin(queue), static_cast<long>(num_checked)), [&](const auto& x) { this->insert(x.address, shamt); });
+  }
+
+  front = num_indexed - num_checked;
+}
+
+auto champsim::channel::collision_index::find(std::deque<request>& queue, champsim::address addr, champsim::data::bits shamt) -> std::deque<request>::iterator
+{
+  auto found = positions.find(collision_key(addr, shamt));
+  if (found == std::end(positions)) {
+    return std::end(queue);
+  }
+
+  // Forget the packets that have left the queue
+  auto& block_positions = found->second;
+  block_positions.erase(std::begin(block_positions), std::lower_bound(std::begin(block_positions), std::end(block_positions), front));
+  if (std::empty(block_positions)) {
+    positions.erase(found);
+    return std::end(queue);
+  }
+
+  return std::next(std::begin(queue), static_cast<long>(block_positions.front() - front));
+}
+
+void champsim::channel::collision_index::insert(champsim::address addr, champsim::data::bits shamt)
+{
+  positions[collision_key(addr, shamt)].push_back(num_indexed++);
+}
+
 template <typename Iter, typename F>
-bool do_collision_for(Iter begin, Iter end, champsim::channel::request_type& packet, champsim::data::bits shamt, F&& func)
+bool do_collision_for(Iter found, Iter end, champsim::channel::request_type& packet, F&& func)
 {
   // We make sure that both merge packet address have been translated. If
   // not this can happen: package with address virtual and physical X
   // (not translated) is inserted, package with physical address
   // (already translated) X.
-  if (auto found =
-          std::find_if(begin, end, [match = packet.address.slice_upper(shamt), shamt](const auto& x) { return x.address.slice_upper(shamt) == match; });
-      found != end && packet.is_translated == found->is_translated) {
+  if (found != end && packet.is_translated == found->is_translated) {
     func(packet, *found);
     return true;
   }
@@ -47,9 +87,9 @@ bool do_collision_for(Iter begin, Iter end, champsim::channel::request_type& pac
 }
 
 template <typename Iter>
-bool do_collision_for_merge(Iter begin, Iter end, champsim::channel::request_type& packet, champsim::data::bits shamt)
+bool do_collision_for_merge(Iter found, Iter end, champsim::channel::request_type& packet)
 {
-  return do_collision_for(begin, end, packet, shamt, [](champsim::channel::request_type& source, champsim::channel::request_type& destination) {
+  return do_collision_for(found, end, packet, [](champsim::channel::request_type& source, champsim::channel::request_type& destination) {
     destination.response_requested |= source.response_requested;
     auto instr_copy = std::move(destination.instr_depend_on_me);
 
@@ -59,59 +99,76 @@ bool do_collision_for_merge(Iter begin, Iter end, champsim::channel::request_typ
 }
 
 template <typename Iter>
-bool do_collision_for_return(Iter begin, Iter end, champsim::channel::request_type& packet, champsim::data::bits shamt,
-                             std::deque<champsim::channel::response_type>& returned)
+bool do_collision_for_return(Iter found, Iter end, champsim::channel::request_type& packet, std::deque<champsim::channel::response_type>& returned)
 {
-  return do_collision_for(begin, end, packet, shamt, [&](champsim::channel::request_type& source, champsim::channel::request_type& destination) {
+  return do_collision_for(found, end, packet, [&](champsim::channel::request_type& source, champsim::channel::request_type& destination) {
     if (source.response_requested) {
       returned.emplace_back(source.address, source.v_address, destination.data, destination.pf_metadata, source.instr_depend_on_me);
     }
   });
 }
 
+template <typename F>
+void champsim::channel::check_unchecked(std::deque<request>& queue, collision_index& index, champsim::data::bits shamt, F&& collides)
+{
+  // Packets are appended unchecked, so the unchecked packets follow all of the checked ones
+  auto first_unchecked = std::find_if(std::rbegin(queue), std::rend(queue), [](const auto& x) { return x.forward_checked; }).base();
+  index.sync(queue, static_cast<std::size_t>(std::distance(std::begin(queue), first_unchecked)), shamt);
+
+  // Remove the colliding packets by compacting the remainder, rather than erasing each from the middle of the queue
+  auto kept_end = first_unchecked;
+  for (auto it = first_unchecked; it != std::end(queue); ++it) {
+    if (!collides(*it)) {
+      it->forward_checked = true;
+      index.insert(it->address, shamt);
+      if (kept_end != it) {
+        *kept_end = std::move(*it);
+      }
+      ++kept_end;
+    }
+  }
+  queue.erase(kept_end, std::end(queue));
+}
+
 void champsim::channel::check_collision()
 {
   auto write_shamt = match_offset_bits ? champsim::data::bits{} : OFFSET_BITS;
   auto read_shamt = OFFSET_BITS;
 
   // Check WQ for duplicates, merging if they are found
-  for (auto wq_it = std::find_if(std::begin(WQ), std::end(WQ), std::not_fn(&request_type::forward_checked)); wq_it != std::end(WQ);) {
-    if (do_collision_for_merge(std::begin(WQ), wq_it, *wq_it, write_shamt)) {
+  check_unchecked(WQ, wq_index, write_shamt, [&](request_type& packet) {
+    if (do_collision_for_merge(wq_index.find(WQ, packet.address, write_shamt), std::end(WQ), packet)) {
       sim_stats.WQ_MERGED++;
-      wq_it = WQ.erase(wq_it);
-    } else {
-      wq_it->forward_checked = true;
-      ++wq_it;
+      return true;
     }
-  }
+    return false;
+  });
 
   // Check RQ for forwarding from WQ (return if found), then for duplicates (merge if found)
-  for (auto rq_it = std::find_if(std::begin(RQ), std::end(RQ), std::not_fn(&request_type::forward_checked)); rq_it != std::end(RQ);) {
-    if (do_collision_for_return(std::begin(WQ), std::end(WQ), *rq_it, write_shamt, returned)) {
+  check_unchecked(RQ, rq_index, read_shamt, [&](request_type& packet) {
+    if (do_collision_for_return(wq_index.find(WQ, packet.address, write_shamt), std::end(WQ), packet, returned)) {
       sim_stats.WQ_FORWARD++;
-      rq_it = RQ.erase(rq_it);
-    } else if (do_collision_for_merge(std::begin(RQ), rq_it, *rq_it, read_shamt)) {
+      return true;
+    }
+    if (do_collision_for_merge(rq_index.find(RQ, packet.address, read_shamt), std::end(RQ), packet)) {
       sim_stats.RQ_MERGED++;
-      rq_it = RQ.erase(rq_it);
-    } else {
-      rq_it->forward_checked = true;
-      ++rq_it;
+      return true;
     }
-  }
+    return false;
+  });
 
   // Check PQ for forwarding from WQ (return if found), then for duplicates (merge if found)
-  for (auto pq_it = std::find_if(std::begin(PQ), std::end(PQ), std::not_fn(&request_type::forward_checked)); pq_it != std::end(PQ);) {
-    if (do_collision_for_return(std::begin(WQ), std::end(WQ), *pq_it, write_shamt, returned)) {
+  check_unchecked(PQ, pq_index, read_shamt, [&](request_type& packet) {
+    if (do_collision_for_return(wq_index.find(WQ, packet.address, write_shamt), std::end(WQ), packet, returned)) {
       sim_stats.WQ_FORWARD++;
-      pq_it = PQ.erase(pq_it);
-    } else if (do_collision_for_merge(std::begin(PQ), pq_it, *pq_it, read_shamt)) {
+      return true;
+    }
+    if (do_collision_for_merge(pq_index.find(PQ, packet.address, read_shamt), std::end(PQ), packet)) {
       sim_stats.PQ_MERGED++;
-      pq_it = PQ.erase(pq_it);
-    } else {
-      pq_it->forward_checked = true;
-      ++pq_it;
+      return true;
     }
-  }
+    return false;
+  });
 }
 
 template <typename R>
@@ -201,3 +258,14 @@ std::size_t champsim::channel::rq_size() const { return RQ_SIZE; }
 std::size_t champsim::channel::wq_size() const { return WQ_SIZE; }
 
 std::size_t champsim::channel::pq_size() const { return PQ_SIZE; }
+
+void champsim::channel::clear()
+{
+  RQ.clear();
+  PQ.clear();
+  WQ.clear();
+  returned.clear();
+  rq_index = {};
+  pq_index = {};
+  wq_index = {};
+}
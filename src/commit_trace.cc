@@ -0,0 +1,340 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "commit_trace.h"
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <fmt/core.h>
+#include <fmt/format.h>
+
+#include "inf_stream.h"
+
+namespace
+{
+// The .npy header is written with a fixed length, so that it can be rewritten in place once the number of rows is known
+constexpr std::size_t npy_header_size = 128;
+
+std::string npy_header(uint64_t rows)
+{
+  constexpr std::string_view magic{"\x93NUMPY\x01\x00", 8};
+  constexpr std::size_t preamble_size = std::size(magic) + 2; // the magic string, the version, and a 2-byte little-endian length
+
+  // The rows are written as they are held in memory
+  constexpr char byte_order = (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__) ? '>' : '<';
+  auto dict = fmt::format("{{'descr': '{}u8', 'fortran_order': False, 'shape': ({}, {}), }}", byte_order, rows, champsim::commit_record_columns);
+  dict.resize(npy_header_size - preamble_size - 1, ' ');
+  dict.push_back('\n');
+
+  std::string header{magic};
+  header.push_back(static_cast<char>(std::size(dict) & 0xff));
+  header.push_back(static_cast<char>(std::size(dict) >> 8));
+  return header + dict;
+}
+} // namespace
+
+namespace champsim
+{
+std::string commit_trace_extension(commit_trace_format format, commit_trace_compression compression)
+{
+  std::string retval;
+  switch (format) {
+  case commit_trace_format::csv:
+    retval = ".csv";
+    break;
+  case commit_trace_format::bin:
+    retval = ".bin";
+    break;
+  case commit_trace_format::npy:
+    retval = ".npy";
+    break;
+  }
+
+  if (compression == commit_trace_compression::xz) {
+    retval += ".xz";
+  }
+  return retval;
+}
+
+struct commit_trace_writer::state_type {
+  std::string filename;
+  commit_trace_format format;
+  std::size_t batch_size;
+  std::size_t depth;
+
+  std::ofstream file;
+  decomp_tags::lzma_tag_t<>::deflate_state_type deflate_state{};
+  fmt::memory_buffer text{};
+
+  std::vector<commit_record> filling{};
+  uint64_t records = 0;
+  bool closed = false;
+
+  // Shared with the writer thread
+  std::mutex mutex{};
+  std::condition_variable work_ready{};
+  std::condition_variable work_taken{};
+  std::deque<std::vector<commit_record>> pending{};
+  std::vector<std::vector<commit_record>> spare{};
+  bool stop = false;
+  std::exception_ptr error{};
+
+  std::unique_ptr<std::thread> writer{};
+  pid_t owner = ::getpid();
+
+  state_type(std::string filename_, commit_trace_format format_, commit_trace_compression compression, std::size_t batch_size_, std::size_t depth_);
+
+  void write_bytes(const char* data, std::size_t size);
+  void encode(const std::vector<commit_record>& batch);
+  void consume();
+  void submit();
+  void finish();
+};
+
+commit_trace_writer::state_type::state_type(std::string filename_, commit_trace_format format_, commit_trace_compression compression,
+                                            std::size_t batch_size_, std::size_t depth_)
+    : filename(std::move(filename_)), format(format_), batch_size(batch_size_), depth(depth_), file(filename, std::ios::binary | std::ios::trunc)
+{
+  if (!file.is_open()) {
+    throw std::runtime_error{fmt::format("Failed to open commit trace output file: {}", filename)};
+  }
+
+  if (compression == commit_trace_compression::xz) {
+    deflate_state = decomp_tags::lzma_tag_t<>::new_deflate_state();
+  }
+
+  filling.reserve(batch_size);
+
+  if (format == commit_trace_format::csv) {
+    const auto header = std::string{commit_trace_header} + "\n";
+    write_bytes(std::data(header), std::size(header));
+  } else if (format == commit_trace_format::npy) {
+    const auto header = npy_header(0);
+    write_bytes(std::data(header), std::size(header));
+  }
+}
+
+void commit_trace_writer::state_type::write_bytes(const char* data, std::size_t size)
+{
+  if (!deflate_state) {
+    file.write(data, static_cast<std::streamsize>(size));
+  } else {
+    std::array<uint8_t, 1 << 16> out_buf;
+    deflate_state->next_in = reinterpret_cast<const uint8_t*>(data);
+    deflate_state->avail_in = size;
+    while (deflate_state->avail_in > 0) {
+      deflate_state->next_out = std::data(out_buf);
+      deflate_state->avail_out = std::size(out_buf);
+      if (::lzma_code(deflate_state.get(), LZMA_RUN) != LZMA_OK) {
+        throw std::runtime_error{fmt::format("Failed to compress commit trace: {}", filename)};
+      }
+      file.write(reinterpret_cast<const char*>(std::data(out_buf)), static_cast<std::streamsize>(std::size(out_buf) - deflate_state->avail_out));
+    }
+  }
+
+  if (!file) {
+    throw std::runtime_error{fmt::format("Failed to write commit trace: {}", filename)};
+  }
+}
+
+void commit_trace_writer::state_type::encode(const std::vector<commit_record>& batch)
+{
+  if (format == commit_trace_format::csv) {
+    text.clear();
+    for (const auto& rec : batch) {
+      fmt::format_to(std::back_inserter(text), "{},{},{},{},{},{},{},{}\n", rec.pc, rec.memory_address, rec.opcode, rec.source_register1,
+                     rec.source_register2, rec.destination_register1, rec.commit_cycle, rec.delta_cycles);
+    }
+    write_bytes(std::data(text), std::size(text));
+  } else {
+    write_bytes(reinterpret_cast<const char*>(std::data(batch)), std::size(batch) * sizeof(commit_record));
+  }
+}
+
+void commit_trace_writer::state_type::consume()
+{
+  std::unique_lock lock{mutex};
+  while (true) {
+    work_ready.wait(lock, [this] { return stop || !std::empty(pending); });
+    if (std::empty(pending)) {
+      return;
+    }
+
+    auto batch = std::move(pending.front());
+    pending.pop_front();
+    lock.unlock();
+
+    try {
+      encode(batch);
+    } catch (...) {
+      lock.lock();
+      error = std::current_exception();
+      pending.clear();
+      work_taken.notify_all();
+      return;
+    }
+
+    batch.clear();
+    lock.lock();
+    spare.push_back(std::move(batch));
+    work_taken.notify_all();
+  }
+}
+
+void commit_trace_writer::state_type::submit()
+{
+  if (!writer) {
+    writer = std::make_unique<std::thread>([this] { this->consume(); });
+  }
+
+  std::unique_lock lock{mutex};
+  work_taken.wait(lock, [this] { return error || std::size(pending) < depth; });
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  pending.push_back(std::move(filling));
+  if (!std::empty(spare)) {
+    filling = std::move(spare.back());
+    spare.pop_back();
+  } else {
+    filling = std::vector<commit_record>{};
+    filling.reserve(batch_size);
+  }
+  work_ready.notify_one();
+}
+
+void commit_trace_writer::state_type::finish()
+{
+  try {
+    if (!std::empty(filling)) {
+      submit();
+    }
+  } catch (...) {
+    // An error from the writer thread is rethrown below, once the thread has been joined
+    if (!error) {
+      throw;
+    }
+  }
+
+  if (writer) {
+    {
+      std::lock_guard lock{mutex};
+      stop = true;
+    }
+    work_ready.notify_one();
+    writer->join();
+    writer.reset();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  if (deflate_state) {
+    std::array<uint8_t, 1 << 16> out_buf;
+    auto ret = LZMA_OK;
+    while (ret == LZMA_OK) {
+      deflate_state->next_out = std::data(out_buf);
+      deflate_state->avail_out = std::size(out_buf);
+      ret = ::lzma_code(deflate_state.get(), LZMA_FINISH);
+      file.write(reinterpret_cast<const char*>(std::data(out_buf)), static_cast<std::streamsize>(std::size(out_buf) - deflate_state->avail_out));
+    }
+    if (ret != LZMA_STREAM_END) {
+      throw std::runtime_error{fmt::format("Failed to compress commit trace: {}", filename)};
+    }
+  }
+
+  if (format == commit_trace_format::npy) {
+    const auto header = npy_header(records);
+    file.seekp(0);
+    file.write(std::data(header), static_cast<std::streamsize>(std::size(header)));
+  }
+
+  file.close();
+  if (!file) {
+    throw std::runtime_error{fmt::format("Failed to write commit trace: {}", filename)};
+  }
+}
+
+commit_trace_writer::commit_trace_writer(std::string filename, commit_trace_format format, commit_trace_compression compression, std::size_t batch_size,
+                                         std::size_t depth)
+{
+  if (format == commit_trace_format::npy && compression != commit_trace_compression::none) {
+    throw std::invalid_argument{"A .npy commit trace cannot be compressed"};
+  }
+  if (batch_size == 0 || depth == 0) {
+    throw std::invalid_argument{"A commit trace writer needs room for at least one record"};
+  }
+
+  state = std::make_unique<state_type>(std::move(filename), format, compression, batch_size, depth);
+}
+
+commit_trace_writer::commit_trace_writer(commit_trace_writer&&) noexcept = default;
+
+commit_trace_writer::~commit_trace_writer()
+{
+  try {
+    close();
+  } catch (const std::exception& e) {
+    fmt::print(stderr, "ERROR: {}\n", e.what());
+  }
+}
+
+void commit_trace_writer::push(const commit_record& record)
+{
+  if (!state || state->closed) {
+    throw std::logic_error{"Pushed a record to a closed commit trace"};
+  }
+  if (state->owner != ::getpid()) {
+    // Waiting for the writer thread would never end, because it was not copied into this forked process
+    throw std::logic_error{"Pushed a record to a commit trace opened by another process"};
+  }
+
+  state->filling.push_back(record);
+  ++state->records;
+  if (std::size(state->filling) == state->batch_size) {
+    state->submit();
+  }
+}
+
+void commit_trace_writer::close()
+{
+  if (!state || state->closed) {
+    return;
+  }
+
+  if (state->owner != ::getpid()) {
+    // The thread was not copied into this forked process, and the file and its buffered bytes belong to the parent
+    static_cast<void>(state.release());
+    return;
+  }
+
+  state->closed = true;
+  state->finish();
+}
+
+uint64_t commit_trace_writer::size() const { return state->records; }
+} // namespace champsim
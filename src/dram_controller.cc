@@ -17,8 +17,13 @@
 #include "dram_controller.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cfenv>
 #include <cmath>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
 #include <fmt/core.h>
 
 #include "deadlock.h"
@@ -57,6 +62,9 @@ DRAM_CHANNEL::DRAM_CHANNEL(champsim::chrono::picoseconds dbus_period, champsim::
   request_array_type br(address_mapping.ranks() * address_mapping.banks() * address_mapping.bankgroups());
   bank_request = br;
   active_request = std::end(bank_request);
+
+  wq_index.candidates_by_bank.resize(std::size(bank_request));
+  rq_index.candidates_by_bank.resize(std::size(bank_request));
 }
 
 DRAM_ADDRESS_MAPPING::DRAM_ADDRESS_MAPPING(champsim::data::bytes channel_width_, std::size_t pref_size_, std::size_t channels_, std::size_t bankgroups_,
@@ -127,6 +135,9 @@ long DRAM_CHANNEL::operate()
       }
       entry.reset();
     }
+
+    rq_index.clear();
+    wq_index.clear();
   }
 
   check_write_collision();
@@ -140,6 +151,70 @@ long DRAM_CHANNEL::operate()
   return progress;
 }
 
+champsim::chrono::clock::time_point MEMORY_CONTROLLER::next_event_time() const
+{
+  auto has_requests = [](const auto* ul) {
+    return !std::empty(ul->RQ) || !std::empty(ul->WQ) || !std::empty(ul->PQ);
+  };
+  if (std::any_of(std::begin(queues), std::end(queues), has_requests)) {
+    return current_time + clock_period;
+  }
+
+  // The channels operate on the cycles of the controller, but keep their own time
+  return std::accumulate(std::begin(channels), std::end(channels), champsim::chrono::clock::time_point::max(), [this](auto acc, const auto& chan) {
+    return std::min(acc, chan.next_event_time() + (this->current_time - chan.current_time));
+  });
+}
+
+void MEMORY_CONTROLLER::idle_cycles(long cycles)
+{
+  for (auto& chan : channels) {
+    chan.current_time += cycles * chan.clock_period;
+  }
+}
+
+std::vector<const champsim::channel*> MEMORY_CONTROLLER::upper_channels() const { return {std::begin(queues), std::end(queues)}; }
+
+champsim::chrono::clock::time_point DRAM_CHANNEL::next_event_time() const
+{
+  const auto next_cycle = current_time + clock_period;
+
+  auto unchecked = [](const auto& entry) {
+    return entry.has_value() && !entry->forward_checked;
+  };
+  auto occupied = [](const auto& entry) {
+    return entry.has_value();
+  };
+  auto refreshing = [](const auto& bank) {
+    return bank.need_refresh || bank.under_refresh;
+  };
+  auto waiting_for_bus = [time = current_time](const auto& bank) {
+    return bank.valid && bank.ready_time <= time;
+  };
+  if ((warmup && (std::any_of(std::begin(RQ), std::end(RQ), occupied) || std::any_of(std::begin(WQ), std::end(WQ), occupied)))
+      || std::any_of(std::begin(RQ), std::end(RQ), unchecked) || std::any_of(std::begin(WQ), std::end(WQ), unchecked) || write_mode_swap_due()
+      || std::any_of(std::begin(bank_request), std::end(bank_request), refreshing)
+      || std::any_of(std::begin(bank_request), std::end(bank_request), waiting_for_bus)) {
+    return next_cycle;
+  }
+
+  auto next_event = std::max(last_refresh + tREF, next_cycle);
+  for (const auto& bank : bank_request) {
+    if (bank.valid) {
+      next_event = std::min(next_event, bank.ready_time);
+    }
+  }
+
+  // Requests that are ready, but whose bank is busy, wait for the bank
+  for (const auto& entry : (write_mode ? WQ : RQ)) {
+    if (entry.has_value() && !entry->scheduled && entry->ready_time > current_time) {
+      next_event = std::min(next_event, entry->ready_time);
+    }
+  }
+
+  return next_event;
+}
+
 long DRAM_CHANNEL::finish_dbus_request()
 {
   long progress{0};
@@ -153,6 +228,8 @@ long DRAM_CHANNEL::finish_dbus_request()
 
     active_request->valid = false;
 
+    auto [index, slot] = locate(active_request->pkt);
+    unindex_request(index, slot, active_request->pkt->value());
     active_request->pkt->reset();
     active_request = std::end(bank_request);
     ++progress;
@@ -201,7 +278,7 @@ long DRAM_CHANNEL::schedule_refresh()
   return (progress);
 }
 
-void DRAM_CHANNEL::swap_write_mode()
+bool DRAM_CHANNEL::write_mode_swap_due() const
 {
   // these values control when to send out a burst of writes
   const std::size_t DRAM_WRITE_HIGH_WM = ((std::size(WQ) * 7) >> 3); // 7/8th
@@ -213,8 +290,13 @@ void DRAM_CHANNEL::swap_write_mode()
   auto rq_occu = static_cast<std::size_t>(std::count_if(std::begin(RQ), std::end(RQ), [](const auto& x) { return x.has_value(); }));
 
   // Change modes if the queues are unbalanced
-  if ((!write_mode && (wq_occu >= DRAM_WRITE_HIGH_WM || (rq_occu == 0 && wq_occu > 0)))
-      || (write_mode && (wq_occu == 0 || (rq_occu > 0 && wq_occu < DRAM_WRITE_LOW_WM)))) {
+  return (!write_mode && (wq_occu >= DRAM_WRITE_HIGH_WM || (rq_occu == 0 && wq_occu > 0)))
+         || (write_mode && (wq_occu == 0 || (rq_occu > 0 && wq_occu < DRAM_WRITE_LOW_WM)));
+}
+
+void DRAM_CHANNEL::swap_write_mode()
+{
+  if (write_mode_swap_due()) {
     // Reset scheduled requests
     for (auto it = std::begin(bank_request); it != std::end(bank_request); ++it) {
       // Leave active request on the data bus
@@ -228,6 +310,9 @@ void DRAM_CHANNEL::swap_write_mode()
         it->valid = false;
         it->pkt->value().scheduled = false;
         it->pkt->value().ready_time = current_time;
+
+        auto [index, slot] = locate(it->pkt);
+        index.candidates_by_bank.at(bank_request_index(it->pkt->value().address)).emplace(it->pkt->value().ready_time, slot);
       }
     }
 
@@ -315,35 +400,36 @@ std::size_t DRAM_CHANNEL::bankgroup_request_index(champsim::address addr) const
 // Look for queued packets that have not been scheduled
 DRAM_CHANNEL::queue_type::iterator DRAM_CHANNEL::schedule_packet()
 {
-  // Look for queued packets that have not been scheduled
   // prioritize packets that are ready to execute, bank is free
-  auto next_schedule = [this](const auto& lhs, const auto& rhs) {
-    if (!(rhs.has_value() && !rhs.value().scheduled)) {
-      return true;
-    }
-    if (!(lhs.has_value() && !lhs.value().scheduled)) {
-      return false;
+  // Among equals, take the earliest ready, and then the latest slot. Each bank's candidates are kept in that order, so only the first of each is compared.
+  auto& queue = write_mode ? WQ : RQ;
+  const auto& index = write_mode ? wq_index : rq_index;
+  const queue_index::candidate_order order{};
+
+  std::optional<queue_index::candidate_type> next_schedule{};
+  bool next_bank_ready = false;
+  for (std::size_t bank = 0; bank < std::size(index.candidates_by_bank); ++bank) {
+    const auto& candidates = index.candidates_by_bank[bank];
+    if (!std::empty(candidates)) {
+      auto bank_ready = !bank_request[bank].valid;
+      const auto& candidate = *std::begin(candidates);
+      if (!next_schedule.has_value() || (bank_ready == next_bank_ready ? order(candidate, *next_schedule) : bank_ready)) {
+        next_schedule = candidate;
+        next_bank_ready = bank_ready;
+      }
     }
+  }
 
-    auto lop_idx = this->bank_request_index(lhs.value().address);
-    auto rop_idx = this->bank_request_index(rhs.value().address);
-    auto rready = !this->bank_request[rop_idx].valid;
-    auto lready = !this->bank_request[lop_idx].valid;
-    return (rready == lready) ? lhs.value().ready_time <= rhs.value().ready_time : lready;
-  };
-  queue_type::iterator iter_next_schedule;
-  if (write_mode) {
-    iter_next_schedule = std::min_element(std::begin(WQ), std::end(WQ), next_schedule);
-  } else {
-    iter_next_schedule = std::min_element(std::begin(RQ), std::end(RQ), next_schedule);
+  if (!next_schedule.has_value()) {
+    return std::end(queue);
   }
-  return (iter_next_schedule);
+  return std::next(std::begin(queue), static_cast<long>(next_schedule->second));
 }
 
 long DRAM_CHANNEL::service_packet(DRAM_CHANNEL::queue_type::iterator pkt)
 {
   long progress{0};
-  if (pkt->has_value() && pkt->value().ready_time <= current_time) {
+  if (pkt != std::end(RQ) && pkt != std::end(WQ) && pkt->has_value() && pkt->value().ready_time <= current_time) {
     auto op_row = address_mapping.get_row(pkt->value().address);
     auto op_idx = bank_request_index(pkt->value().address);
 
@@ -355,6 +441,8 @@ long DRAM_CHANNEL::service_packet(DRAM_CHANNEL::queue_type::iterator pkt)
       bank_request[op_idx] = {true,  row_buffer_hit,        false,
                               false, std::optional{op_row}, current_time + tCAS + (row_buffer_hit ? champsim::chrono::clock::duration{} : row_charge_delay),
                               pkt};
+      auto [index, slot] = locate(pkt);
+      index.candidates_by_bank.at(op_idx).erase({pkt->value().ready_time, slot});
       pkt->value().scheduled = true;
       pkt->value().ready_time = champsim::chrono::clock::time_point::max();
 
@@ -423,73 +511,144 @@ bool DRAM_ADDRESS_MAPPING::is_collision(champsim::address a, champsim::address b
   return (a.slice_upper(offset_bits) == b.slice_upper(offset_bits));
 }
 
-void DRAM_CHANNEL::check_write_collision()
+uint64_t DRAM_ADDRESS_MAPPING::collision_key(champsim::address address) const
 {
-  for (auto wq_it = std::begin(WQ); wq_it != std::end(WQ); ++wq_it) {
-    if (wq_it->has_value() && !wq_it->value().forward_checked) {
-      auto checker = [addr_map = address_mapping, check_val = wq_it->value().address](const auto& pkt) {
-        return pkt.has_value() && addr_map.is_collision(pkt.value().address, check_val);
-      };
+  champsim::data::bits offset_bits = champsim::data::bits{champsim::size(get<SLICER_OFFSET_IDX>(address_slicer))};
+  return address.slice_upper(offset_bits).to<uint64_t>();
+}
 
-      auto found = std::find_if(std::begin(WQ), wq_it, checker); // Forward check
-      if (found == wq_it) {
-        found = std::find_if(std::next(wq_it), std::end(WQ), checker); // Backward check
-      }
+void DRAM_CHANNEL::queue_index::clear()
+{
+  slots_by_block.clear();
+  for (auto& candidates : candidates_by_bank) {
+    candidates.clear();
+  }
+}
 
-      if (found != std::end(WQ)) {
-        wq_it->reset();
-      } else {
-        wq_it->value().forward_checked = true;
-      }
-    }
+void DRAM_CHANNEL::index_request(queue_index& index, std::size_t slot, const request_type& req)
+{
+  auto& slots = index.slots_by_block[address_mapping.collision_key(req.address)];
+  slots.insert(std::lower_bound(std::begin(slots), std::end(slots), slot), slot);
+  if (!req.scheduled) {
+    index.candidates_by_bank.at(bank_request_index(req.address)).emplace(req.ready_time, slot);
   }
 }
 
-void DRAM_CHANNEL::check_read_collision()
+void DRAM_CHANNEL::unindex_request(queue_index& index, std::size_t slot, const request_type& req)
 {
-  for (auto rq_it = std::begin(RQ); rq_it != std::end(RQ); ++rq_it) {
-    if (rq_it->has_value() && !rq_it->value().forward_checked) {
-      auto checker = [addr_map = address_mapping, check_val = rq_it->value().address](const auto& x) {
-        return x.has_value() && addr_map.is_collision(x.value().address, check_val);
-      };
-      // write forward
-      if (auto wq_it = std::find_if(std::begin(WQ), std::end(WQ), checker); wq_it != std::end(WQ)) {
-        response_type response{rq_it->value().address, rq_it->value().v_address, wq_it->value().data, rq_it->value().pf_metadata,
-                               rq_it->value().instr_depend_on_me};
-        for (auto* ret : rq_it->value().to_return) {
-          ret->push_back(response);
-        }
+  auto found = index.slots_by_block.find(address_mapping.collision_key(req.address));
+  assert(found != std::end(index.slots_by_block));
+  found->second.erase(std::lower_bound(std::begin(found->second), std::end(found->second), slot));
+  if (std::empty(found->second)) {
+    index.slots_by_block.erase(found);
+  }
+  if (!req.scheduled) {
+    index.candidates_by_bank.at(bank_request_index(req.address)).erase({req.ready_time, slot});
+  }
+}
 
-        rq_it->reset();
+std::pair<DRAM_CHANNEL::queue_index&, std::size_t> DRAM_CHANNEL::locate(queue_type::const_iterator pkt)
+{
+  const auto* entry = &*pkt;
+  std::less<const queue_type::value_type*> before{};
+  if (!std::empty(WQ) && !before(entry, std::data(WQ)) && before(entry, std::data(WQ) + std::size(WQ))) {
+    return {wq_index, static_cast<std::size_t>(entry - std::data(WQ))};
+  }
+  return {rq_index, static_cast<std::size_t>(entry - std::data(RQ))};
+}
 
-      }
-      // backwards check
-      else if (auto found = std::find_if(std::begin(RQ), rq_it, checker); found != rq_it) {
-        auto instr_copy = std::move(found->value().instr_depend_on_me);
-        auto ret_copy = std::move(found->value().to_return);
+namespace
+{
+std::vector<std::size_t> unchecked_slots(const DRAM_CHANNEL::queue_type& queue)
+{
+  std::vector<std::size_t> retval{};
+  for (std::size_t slot = 0; slot < std::size(queue); ++slot) {
+    if (queue[slot].has_value() && !queue[slot]->forward_checked) {
+      retval.push_back(slot);
+    }
+  }
+  return retval;
+}
+} // namespace
 
-        std::set_union(std::begin(instr_copy), std::end(instr_copy), std::begin(rq_it->value().instr_depend_on_me), std::end(rq_it->value().instr_depend_on_me),
-                       std::back_inserter(found->value().instr_depend_on_me));
-        std::set_union(std::begin(ret_copy), std::end(ret_copy), std::begin(rq_it->value().to_return), std::end(rq_it->value().to_return),
-                       std::back_inserter(found->value().to_return));
+void DRAM_CHANNEL::check_write_collision()
+{
+  auto unchecked = unchecked_slots(WQ);
+  std::unordered_map<uint64_t, std::size_t> unchecked_per_block{};
+  for (auto slot : unchecked) {
+    ++unchecked_per_block[address_mapping.collision_key(WQ[slot]->address)];
+  }
 
-        rq_it->reset();
+  // A write is dropped if any other write to its block is in the queue
+  for (auto slot : unchecked) {
+    auto& wq_entry = WQ[slot];
+    auto key = address_mapping.collision_key(wq_entry->address);
+    auto others_unchecked = --unchecked_per_block[key];
 
-      }
-      // forwards check
-      else if (found = std::find_if(std::next(rq_it), std::end(RQ), checker); found != std::end(RQ)) {
-        auto instr_copy = std::move(found->value().instr_depend_on_me);
-        auto ret_copy = std::move(found->value().to_return);
+    if (others_unchecked > 0 || wq_index.slots_by_block.count(key) > 0) {
+      wq_entry.reset();
+    } else {
+      wq_entry->forward_checked = true;
+      index_request(wq_index, slot, *wq_entry);
+    }
+  }
+}
 
-        std::set_union(std::begin(instr_copy), std::end(instr_copy), std::begin(rq_it->value().instr_depend_on_me), std::end(rq_it->value().instr_depend_on_me),
-                       std::back_inserter(found->value().instr_depend_on_me));
-        std::set_union(std::begin(ret_copy), std::end(ret_copy), std::begin(rq_it->value().to_return), std::end(rq_it->value().to_return),
-                       std::back_inserter(found->value().to_return));
+void DRAM_CHANNEL::check_read_collision()
+{
+  auto unchecked = unchecked_slots(RQ);
+  std::unordered_map<uint64_t, std::deque<std::size_t>> unchecked_by_block{};
+  for (auto slot : unchecked) {
+    unchecked_by_block[address_mapping.collision_key(RQ[slot]->address)].push_back(slot);
+  }
 
-        rq_it->reset();
-      } else {
-        rq_it->value().forward_checked = true;
+  for (auto slot : unchecked) {
+    auto& rq_entry = RQ[slot];
+    auto key = address_mapping.collision_key(rq_entry->address);
+    auto& pending = unchecked_by_block[key];
+    pending.pop_front();
+
+    auto merge_into = [&rq_entry](auto& found) {
+      auto instr_copy = std::move(found->instr_depend_on_me);
+      auto ret_copy = std::move(found->to_return);
+
+      std::set_union(std::begin(instr_copy), std::end(instr_copy), std::begin(rq_entry->instr_depend_on_me), std::end(rq_entry->instr_depend_on_me),
+                     std::back_inserter(found->instr_depend_on_me));
+      std::set_union(std::begin(ret_copy), std::end(ret_copy), std::begin(rq_entry->to_return), std::end(rq_entry->to_return),
+                     std::back_inserter(found->to_return));
+
+      rq_entry.reset();
+    };
+
+    // The checked reads to this block. The unchecked reads before this one have all been checked or dropped.
+    const std::vector<std::size_t> no_slots{};
+    auto checked = rq_index.slots_by_block.find(key);
+    const auto& checked_slots = (checked == std::end(rq_index.slots_by_block)) ? no_slots : checked->second;
+
+    // write forward
+    if (auto wq_found = wq_index.slots_by_block.find(key); wq_found != std::end(wq_index.slots_by_block)) {
+      const auto& wq_entry = WQ[wq_found->second.front()];
+      response_type response{rq_entry->address, rq_entry->v_address, wq_entry->data, rq_entry->pf_metadata, rq_entry->instr_depend_on_me};
+      for (auto* ret : rq_entry->to_return) {
+        ret->push_back(response);
       }
+
+      rq_entry.reset();
+    }
+    // backwards check
+    else if (!std::empty(checked_slots) && checked_slots.front() < slot) {
+      merge_into(RQ[checked_slots.front()]);
+    }
+    // forwards check
+    else if (auto later_checked = std::upper_bound(std::begin(checked_slots), std::end(checked_slots), slot);
+             later_checked != std::end(checked_slots) || !std::empty(pending)) {
+      auto found_slot = (later_checked == std::end(checked_slots)) ? pending.front()
+                        : std::empty(pending)                      ? *later_checked
+                                                                   : std::min(*later_checked, pending.front());
+      merge_into(RQ[found_slot]);
+    } else {
+      rq_entry->forward_checked = true;
+      index_request(rq_index, slot, *rq_entry);
     }
   }
 }
@@ -614,6 +773,53 @@ std::size_t DRAM_ADDRESS_MAPPING::channels() const { return std::size_t{1} << ch
 std::size_t DRAM_CHANNEL::bank_request_capacity() const { return std::size(bank_request); }
 std::size_t DRAM_CHANNEL::bankgroup_request_capacity() const { return std::size(bankgroup_readytime); };
 
+void MEMORY_CONTROLLER::save_state(champsim::serialization::output_archive& ar)
+{
+  ar(static_cast<uint64_t>(std::size(channels)));
+  for (auto& chan : channels) {
+    chan.save_state(ar);
+  }
+}
+
+void MEMORY_CONTROLLER::load_state(champsim::serialization::input_archive& ar)
+{
+  uint64_t count{};
+  ar(count);
+  if (count != std::size(channels)) {
+    throw std::runtime_error(fmt::format("[DRAM] snapshot holds {} channels, expected {}", count, std::size(channels)));
+  }
+  for (auto& chan : channels) {
+    chan.load_state(ar);
+  }
+}
+
+void DRAM_CHANNEL::save_state(champsim::serialization::output_archive& ar)
+{
+  std::vector<std::optional<std::size_t>> open_rows;
+  std::transform(std::begin(bank_request), std::end(bank_request), std::back_inserter(open_rows), [](const auto& bank) { return bank.open_row; });
+  ar(open_rows, write_mode, refresh_row);
+}
+
+void DRAM_CHANNEL::load_state(champsim::serialization::input_archive& ar)
+{
+  std::vector<std::optional<std::size_t>> open_rows;
+  ar(open_rows, write_mode, refresh_row);
+  if (std::size(open_rows) != std::size(bank_request)) {
+    throw std::runtime_error(fmt::format("[DRAM] snapshot holds {} banks, expected {}", std::size(open_rows), std::size(bank_request)));
+  }
+
+  // Requests in flight are discarded, but the row buffers stay open
+  std::fill(std::begin(RQ), std::end(RQ), std::nullopt);
+  std::fill(std::begin(WQ), std::end(WQ), std::nullopt);
+  rq_index.clear();
+  wq_index.clear();
+  for (std::size_t i = 0; i < std::size(bank_request); ++i) {
+    bank_request[i] = BANK_REQUEST{};
+    bank_request[i].open_row = open_rows[i];
+  }
+  active_request = std::end(bank_request);
+}
+
 // LCOV_EXCL_START Exclude the following function from LCOV
 void MEMORY_CONTROLLER::print_deadlock()
 {
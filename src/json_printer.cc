@@ -15,6 +15,7 @@
  */
 
 #include <algorithm>
+#include <numeric>
 #include <utility>
 #include <nlohmann/json.hpp>
 
@@ -71,6 +72,17 @@ void to_json(nlohmann::json& j, const CACHE::stats_type& stats)
     statsmap.emplace(access_type_names.at(champsim::to_underlying(type)), nlohmann::json{{"hit", hits}, {"miss", misses}, {"mshr_merge", mshr_merges}});
   }
 
+  if (!std::empty(stats.replacement_shadows)) {
+    const auto scale = std::ceil(stats.total_sets) / std::ceil(stats.replacement_shadow_sets);
+    std::map<std::string, nlohmann::json> policies;
+    for (const auto& shadow : stats.replacement_shadows) {
+      policies.emplace(shadow.name, nlohmann::json{{"hit", shadow.hits.total()},
+                                                   {"miss", shadow.misses.total()},
+                                                   {"estimated miss", std::ceil(shadow.misses.total()) * scale}});
+    }
+    statsmap.emplace("replacement shadows", nlohmann::json{{"sampled sets", stats.replacement_shadow_sets}, {"policies", policies}});
+  }
+
   j = statsmap;
 }
 
@@ -84,6 +96,21 @@ void to_json(nlohmann::json& j, const DRAM_CHANNEL::stats_type stats)
                      {"REFRESHES ISSUED", stats.refresh_cycles}};
 }
 
+namespace
+{
+// The MPKI of each shadowed replacement policy, over the instructions of every core
+nlohmann::json with_shadow_mpki(nlohmann::json cache, const std::vector<O3_CPU::stats_type>& cpu_stats)
+{
+  if (cache.contains("replacement shadows")) {
+    auto instrs = std::accumulate(std::begin(cpu_stats), std::end(cpu_stats), 0LL, [](auto acc, const auto& x) { return acc + x.instrs(); });
+    for (auto& policy : cache["replacement shadows"]["policies"]) {
+      policy["MPKI"] = (instrs > 0) ? 1000.0 * policy["estimated miss"].get<double>() / std::ceil(instrs) : 0.0;
+    }
+  }
+  return cache;
+}
+} // namespace
+
 namespace champsim
 {
 void to_json(nlohmann::json& j, const champsim::phase_stats stats)
@@ -92,14 +119,14 @@ void to_json(nlohmann::json& j, const champsim::phase_stats stats)
   roi_stats.emplace("cores", stats.roi_cpu_stats);
   roi_stats.emplace("DRAM", stats.roi_dram_stats);
   for (auto x : stats.roi_cache_stats) {
-    roi_stats.emplace(x.name, x);
+    roi_stats.emplace(x.name, with_shadow_mpki(x, stats.roi_cpu_stats));
   }
 
   std::map<std::string, nlohmann::json> sim_stats;
   sim_stats.emplace("cores", stats.sim_cpu_stats);
   sim_stats.emplace("DRAM", stats.sim_dram_stats);
   for (auto x : stats.sim_cache_stats) {
-    sim_stats.emplace(x.name, x);
+    sim_stats.emplace(x.name, with_shadow_mpki(x, stats.sim_cpu_stats));
   }
 
   std::map<std::string, nlohmann::json> statsmap{{"name", stats.name}, {"traces", stats.trace_names}};
@@ -109,4 +136,15 @@ void to_json(nlohmann::json& j, const champsim::phase_stats stats)
 }
 } // namespace champsim
 
+void champsim::json_printer::print(phase_stats& stats) { stream << nlohmann::json(stats); }
+
 void champsim::json_printer::print(std::vector<phase_stats>& stats) { stream << nlohmann::json::array_t{std::begin(stats), std::end(stats)}; }
+
+void champsim::json_printer::print(std::vector<std::pair<std::string, std::vector<phase_stats>>>& variants)
+{
+  nlohmann::json::array_t retval;
+  for (auto& [name, stats] : variants) {
+    retval.push_back(nlohmann::json{{"variant", name}, {"stats", nlohmann::json::array_t{std::begin(stats), std::end(stats)}}});
+  }
+  stream << retval;
+}
@@ -15,12 +15,21 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <exception>
 #include <fstream>
+#include <memory>
 #include <numeric>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 #include <CLI/CLI.hpp>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <fmt/core.h>
 #include <fmt/format.h>
 
@@ -31,8 +40,11 @@
 #endif
 #include "defaults.hpp"
 #include "environment.h"
+#include "module_registry.h"
 #include "ooo_cpu.h" // for O3_CPU
 #include "phase_info.h"
+#include "shared_trace.h"
+#include "sim_server.h"
 #include "stats_printer.h"
 #include "tracereader.h"
 #include "vmem.h"
@@ -67,9 +79,23 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
   long subtrace_count = 1;
   std::string json_file_name;
   std::string checkpoint_path;
+  std::string checkpoint_format_name{"bin"};
   std::string commit_trace_prefix;
+  std::string commit_trace_format_name{"csv"};
+  std::string commit_trace_compression_name{"none"};
   bool commit_trace_warmup = false;
   long long skip_instructions = 0;
+  bool knob_no_idle_skip = false;
+  std::size_t num_threads = 1;
+  long parallel_slack = 1;
+  bool knob_check_determinism = false;
+  std::size_t trace_read_ahead = 8;
+  std::vector<std::string> prefetcher_overrides;
+  std::vector<std::string> replacement_overrides;
+  std::vector<std::string> replacement_shadow_specs;
+  std::size_t replacement_shadow_sets = 64;
+  std::vector<std::string> variant_specs;
+  std::string server_socket;
   std::vector<std::string> trace_names;
 
   auto set_heartbeat_callback = [&](auto) {
@@ -92,15 +118,61 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
   auto* json_option =
       app.add_option("--json", json_file_name, "The name of the file to receive JSON output. If no name is specified, stdout will be used")->expected(0, 1);
   app.add_option("--subtrace-count", subtrace_count, "Number of simulation subtraces to run sequentially after warmup")->check(CLI::PositiveNumber);
-  app.add_option("--cache-checkpoint", checkpoint_path, "Path to cache checkpoint log file used to persist cache contents between phases")
+  auto* checkpoint_option = app.add_option("--cache-checkpoint", checkpoint_path, "Path to cache checkpoint log file used to persist cache contents between phases")
       ->expected(0, 1);
+  app.add_option("--cache-checkpoint-format", checkpoint_format_name,
+                 "Encoding used when writing the cache checkpoint. 'text' is a human-readable export that only keeps block addresses.")
+      ->check(CLI::IsMember({"bin", "text"}));
   auto* commit_trace_option =
       app.add_option("--commit-trace", commit_trace_prefix,
-                     "Write per-CPU commit traces as CSV. If no argument is given, defaults to 'commit_trace'.")
+                     "Write per-CPU commit traces. If no argument is given, defaults to 'commit_trace'.")
           ->expected(0, 1);
-  app.add_flag("--commit-trace-warmup", commit_trace_warmup, "Also dump warmup-phase commits to the commit trace CSV");
+  app.add_option("--commit-trace-format", commit_trace_format_name,
+                 "Encoding of the commit traces. 'bin' is headerless rows of eight 64-bit integers, and 'npy' is the same rows as a NumPy array.")
+      ->check(CLI::IsMember({"csv", "bin", "npy"}));
+  app.add_option("--commit-trace-compression", commit_trace_compression_name, "Compression of the commit traces. A 'npy' trace cannot be compressed.")
+      ->check(CLI::IsMember({"none", "xz"}));
+  app.add_flag("--commit-trace-warmup", commit_trace_warmup, "Also dump warmup-phase commits to the commit trace");
   app.add_option("--skip-instructions", skip_instructions, "Number of instructions to fast-forward before warmup")
       ->check(CLI::NonNegativeNumber);
+  app.add_flag("--no-idle-skip", knob_no_idle_skip, "Operate every component on every cycle, even when none of them has work to do");
+  app.add_option("--threads", num_threads, "The number of host threads that operate the private caches of the cores")->check(CLI::PositiveNumber);
+  app.add_option("--parallel-slack", parallel_slack,
+                 "The number of cycles that the cores may run ahead of the shared components when using more than one thread. "
+                 "Values greater than 1 make the result approximate.")
+      ->check(CLI::PositiveNumber);
+  app.add_option("--prefetcher", prefetcher_overrides,
+                 "Replace the configured prefetchers of a cache with those compiled into this binary, as CACHE=name[,name...]. May be repeated.");
+  app.add_option("--replacement", replacement_overrides,
+                 "Replace the configured replacement policy of a cache with one compiled into this binary, as CACHE=name[,name...]. May be repeated.");
+  app.add_option("--replacement-shadow", replacement_shadow_specs,
+                 "Evaluate replacement policies compiled into this binary on shadow tags alongside the policy of a cache, as CACHE=name[,name...]. "
+                 "Their estimated misses and MPKI are reported in the JSON output. May be repeated.");
+  app.add_option("--replacement-shadow-sets", replacement_shadow_sets, "The number of sets of each cache that the replacement shadows sample")
+      ->check(CLI::PositiveNumber);
+
+  auto* server_option =
+      app.add_option("--server", server_socket,
+                     "Keep the simulation alive and take commands, one per line. If a path is given, listen on that Unix socket, otherwise use stdin.")
+          ->expected(0, 1);
+
+  app.add_option("--trace-read-ahead", trace_read_ahead,
+                 "The number of batches of instructions that each trace may decompress ahead of the simulation, on its own thread. "
+                 "If 0, traces are read on the simulation thread.");
+  auto* determinism_option =
+      app.add_flag("--check-determinism", knob_check_determinism,
+                   "Also run the simulation serially in a child process, and fail if its statistics differ from those of the parallel run")
+          ->excludes(server_option)
+          ->excludes(commit_trace_option)
+          ->excludes(checkpoint_option);
+  app.add_option("--variant", variant_specs,
+                 "Simulate the traces with these module selections, alongside any other variants, each in its own environment on its own thread. "
+                 "The traces are decoded once and shared. A variant is a list of kind:CACHE=name[,name...] separated by ';', where the kind is "
+                 "'prefetcher' or 'replacement', and is applied after --prefetcher and --replacement. May be repeated.")
+      ->excludes(server_option)
+      ->excludes(commit_trace_option)
+      ->excludes(checkpoint_option)
+      ->excludes(determinism_option);
 
   app.add_option("traces", trace_names, "The paths to the traces")->required()->expected(NUM_CPUS)->check(CLI::ExistingFile);
 
@@ -138,17 +210,131 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
     return 1;
   }
 
+  auto apply_module_overrides = [](configured_environment& env, const std::vector<std::string>& overrides, auto select) {
+    for (const auto& spec : overrides) {
+      const auto split = spec.find('=');
+      if (split == std::string::npos) {
+        throw std::invalid_argument(fmt::format("Module selection '{}' is not of the form CACHE=name[,name...]", spec));
+      }
+
+      const auto cache_name = spec.substr(0, split);
+      auto caches = env.cache_view();
+      auto cache = std::find_if(std::begin(caches), std::end(caches), [&](const CACHE& c) { return c.NAME == cache_name; });
+      if (cache == std::end(caches)) {
+        throw std::invalid_argument(fmt::format("Module selection '{}' names an unknown cache", spec));
+      }
+
+      std::vector<std::string> names;
+      std::string_view remaining{spec};
+      remaining.remove_prefix(split + 1);
+      while (!remaining.empty()) {
+        const auto comma = std::min(remaining.find(','), std::size(remaining));
+        names.emplace_back(remaining.substr(0, comma));
+        remaining.remove_prefix(std::min(comma + 1, std::size(remaining)));
+      }
+      select(cache->get(), names);
+    }
+  };
+
+  const auto& registry = champsim::modules::registry::compiled();
+  auto select_prefetchers = [&](CACHE& cache, const auto& names) { registry.select_prefetcher(cache, names); };
+  auto select_replacement = [&](CACHE& cache, const auto& names) { registry.select_replacement(cache, names); };
+  auto apply_global_overrides = [&](configured_environment& env) {
+    apply_module_overrides(env, prefetcher_overrides, select_prefetchers);
+    apply_module_overrides(env, replacement_overrides, select_replacement);
+    apply_module_overrides(env, replacement_shadow_specs, [&](CACHE& cache, const auto& names) {
+      cache.set_replacement_shadow_sets(replacement_shadow_sets);
+      registry.add_replacement_shadows(cache, names);
+    });
+  };
+
+  auto apply_variant = [&](configured_environment& env, const std::string& variant) {
+    std::vector<std::string> prefetcher_selections;
+    std::vector<std::string> replacement_selections;
+    std::string_view remaining{variant};
+    while (!remaining.empty()) {
+      const auto semicolon = std::min(remaining.find(';'), std::size(remaining));
+      const auto selection = remaining.substr(0, semicolon);
+      remaining.remove_prefix(std::min(semicolon + 1, std::size(remaining)));
+
+      const auto colon = selection.find(':');
+      const auto kind = selection.substr(0, colon);
+      if (colon == std::string_view::npos || (kind != "prefetcher" && kind != "replacement")) {
+        throw std::invalid_argument(
+            fmt::format("Variant selection '{}' is not of the form prefetcher:CACHE=name[,name...] or replacement:CACHE=name", selection));
+      }
+      auto& selections = (kind == "prefetcher") ? prefetcher_selections : replacement_selections;
+      selections.emplace_back(selection.substr(colon + 1));
+    }
+    apply_module_overrides(env, prefetcher_selections, select_prefetchers);
+    apply_module_overrides(env, replacement_selections, select_replacement);
+  };
+
+  // Each variant is simulated in an environment of its own
+  std::vector<std::unique_ptr<configured_environment>> variant_environments;
+  try {
+    apply_global_overrides(gen_environment);
+    for (const auto& variant : variant_specs) {
+      auto& env = *variant_environments.emplace_back(std::make_unique<configured_environment>());
+      auto base_cpus = gen_environment.cpu_view();
+      auto cpus = env.cpu_view();
+      for (std::size_t i = 0; i < std::size(cpus); ++i) {
+        cpus.at(i).get().show_heartbeat = base_cpus.at(i).get().show_heartbeat;
+      }
+      env.dram_view().set_verbose(knob_verbose);
+      apply_global_overrides(env);
+      apply_variant(env, variant);
+    }
+  } catch (const std::exception& e) {
+    fmt::print("ERROR: {}\n", e.what());
+    return 1;
+  }
+
   std::vector<champsim::tracereader> traces;
   std::transform(
       std::begin(trace_names), std::end(trace_names), std::back_inserter(traces),
-      [knob_cloudsuite, repeat = simulation_given, i = uint8_t(0)](auto name) mutable { return get_tracereader(name, i++, knob_cloudsuite, repeat); });
+      [knob_cloudsuite, repeat = simulation_given, trace_read_ahead, i = uint8_t(0)](auto name) mutable {
+        return get_tracereader(name, i++, knob_cloudsuite, repeat, trace_read_ahead);
+      });
 
+  uint64_t skipped_instructions = 0;
   if (skip_instructions > 0) {
     for (auto& trace : traces) {
-      for (long long skipped = 0; skipped < skip_instructions && !trace.eof(); ++skipped) {
-        static_cast<void>(trace());
+      skipped_instructions += trace.skip(static_cast<uint64_t>(skip_instructions));
+    }
+  }
+
+  // The variants read each trace through a single shared decode. Each draws instruction IDs from its own counter, starting where a lone
+  // simulation would, so that the variants do not depend on each other.
+  std::vector<std::vector<champsim::tracereader>> variant_traces(std::size(variant_environments));
+  std::vector<uint64_t> variant_instr_ids(std::size(variant_environments), skipped_instructions);
+  if (!std::empty(variant_environments)) {
+    for (auto& trace : traces) {
+      champsim::shared_trace shared{std::move(trace), std::size(variant_environments), std::max<std::size_t>(trace_read_ahead, 1)};
+      for (std::size_t i = 0; i < std::size(variant_environments); ++i) {
+        auto& reader = variant_traces.at(i).emplace_back(shared.reader(i));
+        reader.use_instr_ids(variant_instr_ids.at(i));
       }
     }
+    traces.clear();
+  }
+
+  if (server_option->count() > 0) {
+    auto open_trace = [&trace_names, knob_cloudsuite, repeat = simulation_given, trace_read_ahead](std::size_t i) {
+      return get_tracereader(trace_names.at(i), static_cast<uint8_t>(i), knob_cloudsuite, repeat, trace_read_ahead);
+    };
+    champsim::simulation_server server{gen_environment, traces, trace_names, open_trace};
+    try {
+      if (server_socket.empty()) {
+        server.serve(std::cin, std::cout);
+      } else {
+        server.serve_unix_socket(server_socket);
+      }
+    } catch (const std::exception& e) {
+      fmt::print(stderr, "ERROR: {}\n", e.what());
+      return 1;
+    }
+    return 0;
   }
 
   if (commit_trace_option->count() > 0) {
@@ -156,20 +342,28 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
       commit_trace_prefix = "commit_trace";
     }
 
+    auto format = champsim::commit_trace_format::csv;
+    if (commit_trace_format_name == "bin") {
+      format = champsim::commit_trace_format::bin;
+    } else if (commit_trace_format_name == "npy") {
+      format = champsim::commit_trace_format::npy;
+    }
+    const auto compression = (commit_trace_compression_name == "xz") ? champsim::commit_trace_compression::xz : champsim::commit_trace_compression::none;
+
     const auto make_trace_name = [&](const std::string& base, std::size_t cpu) -> std::string {
-      constexpr std::string_view ext{".csv"};
-      const bool has_csv_ext = (base.size() >= ext.size()) && (base.compare(base.size() - ext.size(), ext.size(), ext) == 0);
-      const auto stem = has_csv_ext ? base.substr(0, base.size() - ext.size()) : base;
+      const auto ext = champsim::commit_trace_extension(format, compression);
+      const bool has_ext = (base.size() >= ext.size()) && (base.compare(base.size() - ext.size(), ext.size(), ext) == 0);
+      const auto stem = has_ext ? base.substr(0, base.size() - ext.size()) : base;
 
       if (NUM_CPUS == 1) {
-        return has_csv_ext ? base : (stem + std::string(ext));
+        return stem + ext;
       }
-      return stem + ".cpu" + std::to_string(cpu) + std::string(ext);
+      return stem + ".cpu" + std::to_string(cpu) + ext;
     };
 
     for (O3_CPU& cpu : gen_environment.cpu_view()) {
       try {
-        cpu.open_commit_trace(make_trace_name(commit_trace_prefix, cpu.cpu), commit_trace_warmup);
+        cpu.open_commit_trace(make_trace_name(commit_trace_prefix, cpu.cpu), commit_trace_warmup, format, compression);
       } catch (const std::exception& e) {
         fmt::print("ERROR: failed to open commit trace: {}\n", e.what());
         return 1;
@@ -183,6 +377,8 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
   std::vector<champsim::phase_info> phases;
   phases.reserve(static_cast<std::size_t>(subtrace_count) + 1);
 
+  const auto checkpoint_format = (checkpoint_format_name == "text") ? champsim::checkpoint_format::text : champsim::checkpoint_format::binary;
+
   auto make_phase = [&](std::string name, bool is_warmup_phase, long long length) {
     champsim::phase_info phase;
     phase.name = std::move(name);
@@ -190,6 +386,10 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
     phase.length = length;
     phase.trace_index = default_trace_index;
     phase.trace_names = trace_names;
+    phase.cache_checkpoint_format = checkpoint_format;
+    phase.skip_idle_cycles = !knob_no_idle_skip;
+    phase.num_threads = num_threads;
+    phase.parallel_slack = parallel_slack;
     return phase;
   };
 
@@ -218,38 +418,201 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
         phases.at(0).length, phases.at(1).length, subtrace_count, std::size(gen_environment.cpu_view()), PAGE_SIZE);
   }
 
-  auto phase_stats = champsim::main(gen_environment, phases, traces);
+  auto print_ipc = [](const std::vector<champsim::phase_stats>& stats, std::size_t num_cpus) {
+    std::vector<long long> total_instrs(num_cpus, 0);
+    std::vector<long long> total_cycles(num_cpus, 0);
 
-  if (knob_verbose) {
-    fmt::print("\nChampSim completed all CPUs\n\n");
+    for (const auto& phase_stat : stats) {
+      for (std::size_t cpu = 0; cpu < std::size(phase_stat.sim_cpu_stats); ++cpu) {
+        const auto instrs = phase_stat.sim_cpu_stats.at(cpu).instrs();
+        const auto cycles = phase_stat.sim_cpu_stats.at(cpu).cycles();
+        total_instrs.at(cpu) += instrs;
+        total_cycles.at(cpu) += cycles;
+      }
+    }
+
+    for (std::size_t cpu = 0; cpu < std::size(total_instrs); ++cpu) {
+      const auto cycles = total_cycles.at(cpu);
+      const double ipc = (cycles > 0) ? static_cast<double>(total_instrs.at(cpu)) / static_cast<double>(cycles) : 0.0;
+      fmt::print("CPU {} IPC: {:.6f}\n", cpu, ipc);
+    }
+  };
+
+  auto print_final_stats = [](configured_environment& env) {
+    for (CACHE& cache : env.cache_view()) {
+      cache.impl_prefetcher_final_stats();
+    }
+
+    for (CACHE& cache : env.cache_view()) {
+      cache.impl_replacement_final_stats();
+    }
+  };
+
+  if (!std::empty(variant_environments)) {
+    std::vector<std::pair<std::string, std::vector<champsim::phase_stats>>> variant_stats;
+    std::vector<std::exception_ptr> errors(std::size(variant_environments));
+    for (const auto& variant : variant_specs) {
+      variant_stats.emplace_back(variant, std::vector<champsim::phase_stats>{});
+    }
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < std::size(variant_environments); ++i) {
+      workers.emplace_back([&, i, variant_phases = phases]() mutable {
+        try {
+          variant_stats.at(i).second = champsim::main(*variant_environments.at(i), variant_phases, variant_traces.at(i));
+        } catch (...) {
+          errors.at(i) = std::current_exception();
+        }
+        // Stop reading the shared traces, so that they do not wait for this variant
+        variant_traces.at(i).clear();
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+
+    for (std::size_t i = 0; i < std::size(errors); ++i) {
+      if (errors.at(i)) {
+        try {
+          std::rethrow_exception(errors.at(i));
+        } catch (const champsim::deadlock& e) {
+          fmt::print("ERROR: variant '{}' deadlocked on CPU {}\n", variant_specs.at(i), e.which);
+        } catch (const std::exception& e) {
+          fmt::print("ERROR: variant '{}' failed: {}\n", variant_specs.at(i), e.what());
+        }
+        return 1;
+      }
+    }
+
+    if (knob_verbose) {
+      fmt::print("\nChampSim completed all CPUs of all variants\n\n");
+    }
+
+    for (std::size_t i = 0; i < std::size(variant_environments); ++i) {
+      fmt::print("Variant {}\n", variant_specs.at(i));
+      print_ipc(variant_stats.at(i).second, std::size(variant_environments.at(i)->cpu_view()));
+      print_final_stats(*variant_environments.at(i));
+    }
+
+    if (json_option->count() > 0) {
+      if (json_file_name.empty()) {
+        champsim::json_printer{std::cout}.print(variant_stats);
+      } else {
+        std::ofstream json_file{json_file_name};
+        champsim::json_printer{json_file}.print(variant_stats);
+      }
+    }
+
+    return 0;
   }
 
-  std::vector<long long> total_instrs(std::size(gen_environment.cpu_view()), 0);
-  std::vector<long long> total_cycles(std::size(gen_environment.cpu_view()), 0);
+  // The serial reference runs in a child process, from the same state as this one
+  int reference_pid = -1;
+  int reference_fd = -1;
+  if (knob_check_determinism) {
+    std::vector<champsim::tracereader> fresh_traces;
+    for (std::size_t i = 0; i < std::size(trace_names); ++i) {
+      fresh_traces.push_back(get_tracereader(trace_names.at(i), static_cast<uint8_t>(i), knob_cloudsuite, simulation_given, trace_read_ahead));
+    }
+
+    std::array<int, 2> pipe_fds{};
+    if (::pipe(std::data(pipe_fds)) != 0) {
+      fmt::print("ERROR: unable to create a pipe for the determinism check\n");
+      return 1;
+    }
 
-  for (const auto& phase_stat : phase_stats) {
-    for (std::size_t cpu = 0; cpu < std::size(phase_stat.sim_cpu_stats); ++cpu) {
-      const auto instrs = phase_stat.sim_cpu_stats.at(cpu).instrs();
-      const auto cycles = phase_stat.sim_cpu_stats.at(cpu).cycles();
-      total_instrs.at(cpu) += instrs;
-      total_cycles.at(cpu) += cycles;
+    std::fflush(nullptr);
+    reference_pid = ::fork();
+    if (reference_pid < 0) {
+      fmt::print("ERROR: unable to fork for the determinism check\n");
+      return 1;
     }
+
+    if (reference_pid == 0) {
+      ::close(pipe_fds[0]);
+      int null_fd = ::open("/dev/null", O_WRONLY);
+      ::dup2(null_fd, STDOUT_FILENO);
+
+      int status = 0;
+      try {
+        // The file offsets of the parent's traces are shared with the child, so the child must read its own copies
+        for (std::size_t i = 0; i < std::size(traces); ++i) {
+          traces.at(i).reopen(std::move(fresh_traces.at(i)));
+        }
+        for (auto& phase : phases) {
+          phase.num_threads = 1;
+        }
+        auto reference_stats = champsim::main(gen_environment, phases, traces);
+
+        std::ostringstream reference_json;
+        champsim::json_printer{reference_json}.print(reference_stats);
+        const auto text = reference_json.str();
+        for (std::size_t written = 0; written < std::size(text);) {
+          auto result = ::write(pipe_fds[1], std::data(text) + written, std::size(text) - written);
+          if (result <= 0) {
+            status = 1;
+            break;
+          }
+          written += static_cast<std::size_t>(result);
+        }
+      } catch (const std::exception& e) {
+        fmt::print(stderr, "ERROR: {}\n", e.what());
+        status = 1;
+      }
+      ::close(pipe_fds[1]);
+      std::_Exit(status);
+    }
+
+    ::close(pipe_fds[1]);
+    reference_fd = pipe_fds[0];
   }
 
-  for (std::size_t cpu = 0; cpu < std::size(total_instrs); ++cpu) {
-    const auto cycles = total_cycles.at(cpu);
-    const double ipc = (cycles > 0) ? static_cast<double>(total_instrs.at(cpu)) / static_cast<double>(cycles) : 0.0;
-    fmt::print("CPU {} IPC: {:.6f}\n", cpu, ipc);
+  auto phase_stats = champsim::main(gen_environment, phases, traces);
+
+  for (O3_CPU& cpu : gen_environment.cpu_view()) {
+    try {
+      cpu.close_commit_trace();
+    } catch (const std::exception& e) {
+      fmt::print("ERROR: failed to write commit trace: {}\n", e.what());
+      return 1;
+    }
   }
 
-  for (CACHE& cache : gen_environment.cache_view()) {
-    cache.impl_prefetcher_final_stats();
+  if (knob_check_determinism) {
+    std::string reference_text;
+    std::array<char, 4096> buffer{};
+    for (auto received = ::read(reference_fd, std::data(buffer), std::size(buffer)); received > 0;
+         received = ::read(reference_fd, std::data(buffer), std::size(buffer))) {
+      reference_text.append(std::data(buffer), static_cast<std::size_t>(received));
+    }
+    ::close(reference_fd);
+
+    int reference_status = -1;
+    ::waitpid(reference_pid, &reference_status, 0);
+    if (!WIFEXITED(reference_status) || WEXITSTATUS(reference_status) != 0) {
+      fmt::print("ERROR: the serial reference simulation failed\n");
+      return 1;
+    }
+
+    std::ostringstream parallel_json;
+    champsim::json_printer{parallel_json}.print(phase_stats);
+    const auto parallel_text = parallel_json.str();
+    if (parallel_text != reference_text) {
+      auto [first_diff, ignored] = std::mismatch(std::begin(parallel_text), std::end(parallel_text), std::begin(reference_text), std::end(reference_text));
+      fmt::print("ERROR: the statistics differ from those of the serial simulation, first at offset {} of the JSON output\n",
+                 std::distance(std::begin(parallel_text), first_diff));
+      return 1;
+    }
+    fmt::print("Determinism check: the statistics match those of the serial simulation\n");
   }
 
-  for (CACHE& cache : gen_environment.cache_view()) {
-    cache.impl_replacement_final_stats();
+  if (knob_verbose) {
+    fmt::print("\nChampSim completed all CPUs\n\n");
   }
 
+  print_ipc(phase_stats, std::size(gen_environment.cpu_view()));
+  print_final_stats(gen_environment);
+
   if (json_option->count() > 0) {
     if (json_file_name.empty()) {
       champsim::json_printer{std::cout}.print(phase_stats);
@@ -0,0 +1,247 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "module_registry.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#if __has_include("legacy_bridge.h")
+#include "legacy_bridge.h"
+#endif
+
+#if __has_include("module_registry.inc")
+#include "module_registry.inc"
+#endif
+
+namespace
+{
+/**
+ * Several prefetchers selected at runtime. Results are combined as in CACHE::prefetcher_module_model.
+ */
+struct prefetcher_list final : CACHE::prefetcher_module_concept {
+  std::vector<std::unique_ptr<CACHE::prefetcher_module_concept>> intern_;
+
+  explicit prefetcher_list(std::vector<std::unique_ptr<CACHE::prefetcher_module_concept>>&& modules) : intern_(std::move(modules)) {}
+
+  template <typename F>
+  void for_each(F&& func)
+  {
+    std::for_each(std::begin(intern_), std::end(intern_), [&](auto& p) { func(*p); });
+  }
+
+  template <typename F>
+  uint32_t xor_each(F&& func)
+  {
+    return std::accumulate(std::begin(intern_), std::end(intern_), uint32_t{}, [&](uint32_t acc, auto& p) { return acc ^ func(*p); });
+  }
+
+  void bind(CACHE* cache) final
+  {
+    for_each([cache](auto& p) { p.bind(cache); });
+  }
+
+  void impl_prefetcher_initialize() final
+  {
+    for_each([](auto& p) { p.impl_prefetcher_initialize(); });
+  }
+
+  uint32_t impl_prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint64_t instr_id, bool wrong_path, bool cache_hit,
+                                         bool useful_prefetch, access_type type, uint32_t metadata_in) final
+  {
+    return xor_each([&](auto& p) { return p.impl_prefetcher_cache_operate(addr, ip, instr_id, wrong_path, cache_hit, useful_prefetch, type, metadata_in); });
+  }
+
+  uint32_t impl_prefetcher_cache_fill(champsim::address addr, long set, long way, bool prefetch, champsim::address evicted_addr, uint32_t metadata_in) final
+  {
+    return xor_each([&](auto& p) { return p.impl_prefetcher_cache_fill(addr, set, way, prefetch, evicted_addr, metadata_in); });
+  }
+
+  void impl_prefetcher_cycle_operate() final
+  {
+    for_each([](auto& p) { p.impl_prefetcher_cycle_operate(); });
+  }
+
+  bool impl_prefetcher_cycle_idle() final
+  {
+    return std::all_of(std::begin(intern_), std::end(intern_), [](auto& p) { return p->impl_prefetcher_cycle_idle(); });
+  }
+
+  void impl_prefetcher_final_stats() final
+  {
+    for_each([](auto& p) { p.impl_prefetcher_final_stats(); });
+  }
+
+  void impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target) final
+  {
+    for_each([&](auto& p) { p.impl_prefetcher_branch_operate(ip, branch_type, branch_target); });
+  }
+
+  void impl_prefetcher_squash(champsim::address ip, uint64_t instr_id) final
+  {
+    for_each([&](auto& p) { p.impl_prefetcher_squash(ip, instr_id); });
+  }
+
+  void impl_save_state(champsim::serialization::output_archive& ar) final
+  {
+    for_each([&](auto& p) { p.impl_save_state(ar); });
+  }
+
+  void impl_load_state(champsim::serialization::input_archive& ar) final
+  {
+    for_each([&](auto& p) { p.impl_load_state(ar); });
+  }
+};
+
+/**
+ * Several replacement policies selected at runtime. As in CACHE::replacement_module_model, the last policy chooses the victim.
+ */
+struct replacement_list final : CACHE::replacement_module_concept {
+  std::vector<std::unique_ptr<CACHE::replacement_module_concept>> intern_;
+
+  explicit replacement_list(std::vector<std::unique_ptr<CACHE::replacement_module_concept>>&& modules) : intern_(std::move(modules)) {}
+
+  template <typename F>
+  void for_each(F&& func)
+  {
+    std::for_each(std::begin(intern_), std::end(intern_), [&](auto& r) { func(*r); });
+  }
+
+  void bind(CACHE* cache) final
+  {
+    for_each([cache](auto& r) { r.bind(cache); });
+  }
+
+  void impl_initialize_replacement() final
+  {
+    for_each([](auto& r) { r.impl_initialize_replacement(); });
+  }
+
+  long impl_find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, const CACHE::BLOCK* current_set, champsim::address ip,
+                        champsim::address full_addr, access_type type) final
+  {
+    long victim{};
+    for_each([&](auto& r) { victim = r.impl_find_victim(triggering_cpu, instr_id, set, current_set, ip, full_addr, type); });
+    return victim;
+  }
+
+  void impl_update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
+                                     champsim::address victim_addr, access_type type, bool hit) final
+  {
+    for_each([&](auto& r) { r.impl_update_replacement_state(triggering_cpu, set, way, full_addr, ip, victim_addr, type, hit); });
+  }
+
+  void impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
+                                   champsim::address victim_addr, access_type type) final
+  {
+    for_each([&](auto& r) { r.impl_replacement_cache_fill(triggering_cpu, set, way, full_addr, ip, victim_addr, type); });
+  }
+
+  void impl_replacement_final_stats() final
+  {
+    for_each([](auto& r) { r.impl_replacement_final_stats(); });
+  }
+
+  void impl_save_state(champsim::serialization::output_archive& ar) final
+  {
+    for_each([&](auto& r) { r.impl_save_state(ar); });
+  }
+
+  void impl_load_state(champsim::serialization::input_archive& ar) final
+  {
+    for_each([&](auto& r) { r.impl_load_state(ar); });
+  }
+};
+
+template <typename Map>
+std::vector<std::string> keys_of(const Map& map)
+{
+  std::vector<std::string> retval;
+  std::transform(std::begin(map), std::end(map), std::back_inserter(retval), [](const auto& kv) { return kv.first; });
+  return retval;
+}
+
+template <typename Concept, typename List, typename Map>
+std::unique_ptr<Concept> make_modules(const Map& factories, const std::vector<std::string>& names, CACHE* cache, std::string_view kind)
+{
+  if (std::empty(names)) {
+    throw std::invalid_argument(fmt::format("No {} was named", kind));
+  }
+
+  std::vector<std::unique_ptr<Concept>> modules;
+  for (const auto& name : names) {
+    auto found = factories.find(name);
+    if (found == std::end(factories)) {
+      throw std::runtime_error(fmt::format("Unknown {} '{}'. Available: {}", kind, name, fmt::join(keys_of(factories), ", ")));
+    }
+    modules.push_back(found->second(cache));
+  }
+
+  if (std::size(modules) == 1) {
+    return std::move(modules.front());
+  }
+  return std::make_unique<List>(std::move(modules));
+}
+} // namespace
+
+std::vector<std::string> champsim::modules::registry::prefetcher_names() const { return keys_of(prefetchers); }
+
+std::vector<std::string> champsim::modules::registry::replacement_names() const { return keys_of(replacements); }
+
+auto champsim::modules::registry::make_prefetcher(const std::vector<std::string>& names, CACHE* cache) const
+    -> std::unique_ptr<CACHE::prefetcher_module_concept>
+{
+  return make_modules<CACHE::prefetcher_module_concept, prefetcher_list>(prefetchers, names, cache, "prefetcher");
+}
+
+auto champsim::modules::registry::make_replacement(const std::vector<std::string>& names, CACHE* cache) const
+    -> std::unique_ptr<CACHE::replacement_module_concept>
+{
+  return make_modules<CACHE::replacement_module_concept, replacement_list>(replacements, names, cache, "replacement policy");
+}
+
+void champsim::modules::registry::select_prefetcher(CACHE& cache, const std::vector<std::string>& names) const
+{
+  cache.pref_module_pimpl = make_prefetcher(names, &cache);
+}
+
+void champsim::modules::registry::select_replacement(CACHE& cache, const std::vector<std::string>& names) const
+{
+  cache.repl_module_pimpl = make_replacement(names, &cache);
+}
+
+void champsim::modules::registry::add_replacement_shadows(CACHE& cache, const std::vector<std::string>& names) const
+{
+  for (const auto& name : names) {
+    cache.add_replacement_shadow(name, make_replacement({name}, &cache));
+  }
+}
+
+const champsim::modules::registry& champsim::modules::registry::compiled()
+{
+  static const registry instance = [] {
+    [[maybe_unused]] registry reg;
+#if __has_include("module_registry.cc.inc")
+#include "module_registry.cc.inc"
+#endif
+    return reg;
+  }();
+  return instance;
+}
@@ -71,6 +71,72 @@ long O3_CPU::operate()
   return progress;
 }
 
+champsim::chrono::clock::time_point O3_CPU::next_event_time() const
+{
+  const auto next_cycle = current_time + clock_period;
+
+  // Work that would be done on the next cycle. Requests refused by the caches are retried every cycle.
+  auto unfetched = [](const ooo_model_instr& x) {
+    return !x.dib_checked || !x.fetch_issued;
+  };
+  auto load_waiting_to_issue = [time = current_time, this](std::size_t slot) {
+    return LQ.at(slot)->ready_time < time;
+  };
+  auto store_waiting_to_complete = [time = current_time, finished = LSQ_ENTRY::precedes(std::empty(ROB) ? std::numeric_limits<uint64_t>::max()
+                                                                                                             : ROB.front().instr_id)](const auto& sq_entry) {
+    return sq_entry.fetch_issued && finished(sq_entry) && sq_entry.ready_time <= time;
+  };
+  const bool can_fill_ifetch = !std::empty(input_queue) && std::size(IFETCH_BUFFER) < IFETCH_BUFFER_SIZE;
+  if ((!std::empty(ROB) && ROB.front().completed) || !std::empty(L1I_bus.lower_level->returned) || !std::empty(L1D_bus.lower_level->returned)
+      || (can_fill_ifetch && fetch_resume_time <= next_cycle) || std::any_of(std::begin(IFETCH_BUFFER), std::end(IFETCH_BUFFER), unfetched)
+      || std::any_of(std::begin(lq_unissued_slots), std::end(lq_unissued_slots), load_waiting_to_issue) || std::any_of(std::begin(SQ), std::end(SQ), store_waiting_to_complete)) {
+    return next_cycle;
+  }
+
+  // Otherwise, instructions that are already due are waiting on a resource that only progress can free, so only later times matter
+  auto next_event = champsim::chrono::clock::time_point::max();
+  auto consider = [&next_event, time = current_time](champsim::chrono::clock::time_point event) {
+    if (event > time) {
+      next_event = std::min(next_event, event);
+    }
+  };
+
+  if (can_fill_ifetch) {
+    consider(fetch_resume_time);
+  }
+  for (const auto& instr : IFETCH_BUFFER) {
+    if (instr.fetch_completed) {
+      consider(instr.ready_time);
+    }
+  }
+  for (const auto& buffer : {std::cref(DIB_HIT_BUFFER), std::cref(DECODE_BUFFER)}) {
+    for (const auto& instr : buffer.get()) {
+      consider(instr.ready_time);
+    }
+  }
+  if (!std::empty(DISPATCH_BUFFER)) {
+    consider(DISPATCH_BUFFER.front().ready_time);
+  }
+  for (const auto& instr : ROB) {
+    if (!instr.completed && (!instr.executed || instr.completed_mem_ops == instr.num_mem_ops())) {
+      consider(instr.ready_time);
+    }
+  }
+  for (const auto& lq_entry : LQ) {
+    // Loads issue on the cycle after they become ready
+    if (lq_entry.has_value() && !lq_entry->fetch_issued && lq_entry->ready_time != champsim::chrono::clock::time_point::max()) {
+      consider(lq_entry->ready_time + champsim::chrono::picoseconds{1});
+    }
+  }
+  for (const auto& sq_entry : SQ) {
+    consider(sq_entry.ready_time);
+  }
+
+  return next_event;
+}
+
+std::vector<const champsim::channel*> O3_CPU::lower_channels() const { return {L1I_bus.lower_level, L1D_bus.lower_level}; }
+
 void O3_CPU::initialize()
 {
   // BRANCH PREDICTOR & BTB
@@ -78,20 +144,20 @@ void O3_CPU::initialize()
   impl_initialize_btb();
 }
 
-void O3_CPU::open_commit_trace(std::string filename, bool dump_warmup)
+void O3_CPU::open_commit_trace(std::string filename, bool dump_warmup, champsim::commit_trace_format format,
+                               champsim::commit_trace_compression compression)
 {
   commit_trace_dump_warmup = dump_warmup;
   commit_trace_last_cycle.reset();
+  commit_trace = std::make_unique<champsim::commit_trace_writer>(std::move(filename), format, compression);
+}
 
-  auto path = std::move(filename);
-  commit_trace_stream = std::make_unique<std::ofstream>(path);
-  if (!commit_trace_stream->is_open()) {
-    throw std::runtime_error{fmt::format("Failed to open commit trace output file: {}", path)};
+void O3_CPU::close_commit_trace()
+{
+  if (commit_trace) {
+    commit_trace->close();
+    commit_trace.reset();
   }
-
-  // Header for downstream parsing. Values are decimal integers.
-  (*commit_trace_stream) << "pc,memory_address,opcode,source_register1,source_register2,destination_register1,commit_cycle,delta_cycles\n";
-  commit_trace_stream->flush();
 }
 
 void O3_CPU::begin_phase()
@@ -107,7 +173,7 @@ void O3_CPU::begin_phase()
   sim_stats = stats;
 
   // Treat each phase as a new segment for commit-trace deltas.
-  if (commit_trace_stream) {
+  if (commit_trace) {
     commit_trace_last_cycle.reset();
   }
 }
@@ -138,7 +204,7 @@ void O3_CPU::initialize_instruction()
     stop_fetch = do_init_instruction(input_queue.front());
 
     // Add to IFETCH_BUFFER
-    IFETCH_BUFFER.push_back(input_queue.front());
+    IFETCH_BUFFER.push_back(std::move(input_queue.front()));
     input_queue.pop_front();
 
     IFETCH_BUFFER.back().ready_time = current_time;
@@ -297,7 +363,7 @@ long O3_CPU::fetch_instruction()
   return progress;
 }
 
-bool O3_CPU::do_fetch_instruction(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end)
+bool O3_CPU::do_fetch_instruction(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end)
 {
   CacheBus::request_type fetch_packet;
   fetch_packet.v_address = begin->ip;
@@ -427,8 +493,8 @@ long O3_CPU::decode_instruction()
 
   long progress{std::distance(dib_hit_buffer_begin, dib_hit_buffer_end) + std::distance(decode_buffer_begin, decode_buffer_end)};
 
-  std::merge(dib_hit_buffer_begin, dib_hit_buffer_end, decode_buffer_begin, decode_buffer_end, std::back_inserter(DISPATCH_BUFFER),
-             ooo_model_instr::program_order);
+  std::merge(std::make_move_iterator(dib_hit_buffer_begin), std::make_move_iterator(dib_hit_buffer_end), std::make_move_iterator(decode_buffer_begin),
+             std::make_move_iterator(decode_buffer_end), std::back_inserter(DISPATCH_BUFFER), ooo_model_instr::program_order);
   DECODE_BUFFER.erase(decode_buffer_begin, decode_buffer_end);
   DIB_HIT_BUFFER.erase(dib_hit_buffer_begin, dib_hit_buffer_end);
 
@@ -444,8 +510,7 @@ long O3_CPU::dispatch_instruction()
   // dispatch DISPATCH_WIDTH instructions into the ROB
   while (available_dispatch_bandwidth.has_remaining() && !std::empty(DISPATCH_BUFFER) && DISPATCH_BUFFER.front().ready_time <= current_time
          && std::size(ROB) != ROB_SIZE
-         && ((std::size_t)std::count_if(std::begin(LQ), std::end(LQ), [](const auto& lq_entry) { return !lq_entry.has_value(); })
-             >= std::size(DISPATCH_BUFFER.front().source_memory))
+         && std::size(lq_free_slots) >= std::size(DISPATCH_BUFFER.front().source_memory)
          && ((std::size(DISPATCH_BUFFER.front().destination_memory) + std::size(SQ)) <= SQ_SIZE)) {
     ROB.push_back(std::move(DISPATCH_BUFFER.front()));
     DISPATCH_BUFFER.pop_front();
@@ -461,8 +526,17 @@ long O3_CPU::dispatch_instruction()
 long O3_CPU::schedule_instruction()
 {
   champsim::bandwidth search_bw{SCHEDULER_SIZE};
+  auto rob_it = std::begin(ROB);
+
+  // The instructions at the head of the ROB that are already scheduled can only stop the search if the register file is nearly full.
+  // Otherwise, skip over them, charging the search for each one that has not yet executed.
+  if (reg_allocator.count_free_registers() >= max_scheduled_register_demand) {
+    std::advance(rob_it, static_cast<long>(scheduled_prefix));
+    search_bw.consume(std::min(static_cast<long>(scheduled_prefix_waiting), search_bw.amount_remaining()));
+  }
+
   int progress{0};
-  for (auto rob_it = std::begin(ROB); rob_it != std::end(ROB) && search_bw.has_remaining(); ++rob_it) {
+  for (; rob_it != std::end(ROB) && search_bw.has_remaining(); ++rob_it) {
     // if there aren't enough physical registers available for the next instruction, stop scheduling
     unsigned long sources_to_allocate = std::count_if(rob_it->source_registers.begin(), rob_it->source_registers.end(),
                                                       [&alloc = std::as_const(reg_allocator)](auto srcreg) { return !alloc.isAllocated(srcreg); });
@@ -479,6 +553,13 @@ long O3_CPU::schedule_instruction()
     }
   }
 
+  while (scheduled_prefix < std::size(ROB) && ROB[scheduled_prefix].scheduled) {
+    if (!ROB[scheduled_prefix].executed) {
+      ++scheduled_prefix_waiting;
+    }
+    ++scheduled_prefix;
+  }
+
   return progress;
 }
 
@@ -495,23 +576,58 @@ void O3_CPU::do_scheduling(ooo_model_instr& instr)
     dreg = reg_allocator.rename_dest_register(dreg, instr.instr_id);
   }
 
+  // wait for the sources that have not yet been produced
+  instr.num_reg_dependent = 0;
+  for (auto src_reg : instr.source_registers) {
+    if (!reg_allocator.isValid(src_reg)) {
+      reg_allocator.wait_for_register(src_reg, instr.instr_id);
+      ++instr.num_reg_dependent;
+    }
+  }
+  if (instr.num_reg_dependent == 0) {
+    ready_to_execute.push(instr.instr_id);
+  }
+
+  max_scheduled_register_demand = std::max(max_scheduled_register_demand, std::size(instr.source_registers) + std::size(instr.destination_registers));
   instr.scheduled = true;
 }
 
+champsim::circular_buffer<ooo_model_instr>::iterator O3_CPU::find_unexecuted(champsim::program_ordered<ooo_model_instr>::id_type id)
+{
+  // The ROB is in program order, but instructions that were placed there directly may share an ID
+  auto rob_it = std::partition_point(std::begin(ROB), std::end(ROB), ooo_model_instr::precedes(id));
+  rob_it = std::find_if(rob_it, std::end(ROB), [id](const auto& x) { return x.instr_id != id || !x.executed; });
+  if (rob_it != std::end(ROB) && rob_it->instr_id != id) {
+    return std::end(ROB);
+  }
+  return rob_it;
+}
+
 long O3_CPU::execute_instruction()
 {
   champsim::bandwidth exec_bw{EXEC_WIDTH};
-  for (auto rob_it = std::begin(ROB); rob_it != std::end(ROB) && exec_bw.has_remaining(); ++rob_it) {
-    if (rob_it->scheduled && !rob_it->executed && rob_it->ready_time <= current_time) {
-      bool ready = std::all_of(std::begin(rob_it->source_registers), std::end(rob_it->source_registers),
-                               [&alloc = std::as_const(reg_allocator)](auto srcreg) { return alloc.isValid(srcreg); });
-      if (ready) {
+  std::vector<champsim::program_ordered<ooo_model_instr>::id_type> not_yet_ready;
+  while (exec_bw.has_remaining() && !std::empty(ready_to_execute)) {
+    auto rob_it = find_unexecuted(ready_to_execute.top());
+    ready_to_execute.pop();
+
+    if (rob_it != std::end(ROB) && rob_it->scheduled) {
+      if (rob_it->ready_time <= current_time) {
+        if (std::distance(std::begin(ROB), rob_it) < static_cast<long>(scheduled_prefix)) {
+          --scheduled_prefix_waiting;
+        }
         do_execution(*rob_it);
         exec_bw.consume();
+      } else {
+        not_yet_ready.push_back(rob_it->instr_id);
       }
     }
   }
 
+  for (auto id : not_yet_ready) {
+    ready_to_execute.push(id);
+  }
+
   return exec_bw.amount_consumed();
 }
 
@@ -521,17 +637,15 @@ void O3_CPU::do_execution(ooo_model_instr& instr)
   instr.ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
 
   // Mark LQ entries as ready to translate
-  for (auto& lq_entry : LQ) {
-    if (lq_entry.has_value() && lq_entry->instr_id == instr.instr_id) {
-      lq_entry->ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
-    }
+  auto [lq_begin, lq_end] = lq_slots_by_instr.equal_range(instr.instr_id);
+  for (auto slot_it = lq_begin; slot_it != lq_end; ++slot_it) {
+    LQ.at(slot_it->second)->ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
   }
 
-  // Mark SQ entries as ready to translate
-  for (auto& sq_entry : SQ) {
-    if (sq_entry.instr_id == instr.instr_id) {
-      sq_entry.ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
-    }
+  // Mark SQ entries as ready to translate. The SQ is in program order.
+  for (auto sq_it = std::partition_point(std::begin(SQ), std::end(SQ), LSQ_ENTRY::precedes(instr.instr_id));
+       sq_it != std::end(SQ) && sq_it->instr_id == instr.instr_id; ++sq_it) {
+    sq_it->ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
   }
 
   if constexpr (champsim::debug_print) {
@@ -543,18 +657,22 @@ void O3_CPU::do_memory_scheduling(ooo_model_instr& instr)
 {
   // load
   for (auto& smem : instr.source_memory) {
-    auto q_entry = std::find_if_not(std::begin(LQ), std::end(LQ), [](const auto& lq_entry) { return lq_entry.has_value(); });
-    assert(q_entry != std::end(LQ));
+    // take the lowest free slot
+    assert(!std::empty(lq_free_slots));
+    auto slot = lq_free_slots.top();
+    lq_free_slots.pop();
+    auto q_entry = std::next(std::begin(LQ), static_cast<long>(slot));
     q_entry->emplace(smem, instr.instr_id, instr.ip, instr.asid); // add it to the load queue
+    lq_slots_by_instr.emplace(instr.instr_id, slot);
 
     // Check for forwarding
-    auto sq_it = std::max_element(std::begin(SQ), std::end(SQ), [smem](const auto& lhs, const auto& rhs) {
-      return lhs.virtual_address != smem || (rhs.virtual_address == smem && LSQ_ENTRY::program_order(lhs, rhs));
-    });
-    if (sq_it != std::end(SQ) && sq_it->virtual_address == smem) {
+    auto sq_it = find_forwarding_store(smem);
+    if (sq_it == nullptr) {
+      lq_unissued_slots.insert(slot);
+    } else {
       if (sq_it->fetch_issued) { // Store already executed
         (*q_entry)->finish(instr);
-        q_entry->reset();
+        release_lq_entry(*q_entry);
       } else {
         assert(sq_it->instr_id < instr.instr_id);      // The found SQ entry is a prior store
         sq_it->lq_depend_on_me.emplace_back(*q_entry); // Forward the load when the store finishes
@@ -569,7 +687,8 @@ void O3_CPU::do_memory_scheduling(ooo_model_instr& instr)
 
   // store
   for (auto& dmem : instr.destination_memory) {
-    SQ.emplace_back(dmem, instr.instr_id, instr.ip, instr.asid); // add it to the store queue
+    auto& sq_entry = SQ.emplace_back(dmem, instr.instr_id, instr.ip, instr.asid); // add it to the store queue
+    sq_entries_by_address[dmem.to<uint64_t>()].push_back(&sq_entry);
   }
 
   if constexpr (champsim::debug_print) {
@@ -599,18 +718,28 @@ long O3_CPU::operate_lsq()
 
   auto [complete_begin, complete_end] = champsim::get_span_p(std::cbegin(SQ), std::cend(SQ), store_bw, do_complete);
   store_bw.consume(std::distance(complete_begin, complete_end));
+  std::for_each(complete_begin, complete_end, [this](const auto& sq_entry) {
+    // stores leave the SQ in program order, so each is the oldest to its address
+    auto found = sq_entries_by_address.find(sq_entry.virtual_address.template to<uint64_t>());
+    assert(found != std::end(sq_entries_by_address) && found->second.front() == &sq_entry);
+    found->second.pop_front();
+    if (std::empty(found->second)) {
+      sq_entries_by_address.erase(found);
+    }
+  });
   SQ.erase(complete_begin, complete_end);
 
   champsim::bandwidth load_bw{LQ_WIDTH};
 
-  for (auto& lq_entry : LQ) {
-    if (load_bw.has_remaining() && lq_entry.has_value() && lq_entry->producer_id == std::numeric_limits<uint64_t>::max() && !lq_entry->fetch_issued
-        && lq_entry->ready_time < current_time) {
-      auto success = execute_load(*lq_entry);
-      if (success) {
-        load_bw.consume();
-        lq_entry->fetch_issued = true;
-      }
+  for (auto slot_it = std::begin(lq_unissued_slots); slot_it != std::end(lq_unissued_slots) && load_bw.has_remaining();) {
+    auto& lq_entry = LQ.at(*slot_it);
+    if (lq_entry->ready_time < current_time && execute_load(*lq_entry)) {
+      load_bw.consume();
+      lq_entry->fetch_issued = true;
+      lq_issued_slots_by_block.emplace(champsim::block_number{lq_entry->virtual_address}.to<uint64_t>(), *slot_it);
+      slot_it = lq_unissued_slots.erase(slot_it);
+    } else {
+      ++slot_it;
     }
   }
 
@@ -631,8 +760,41 @@ void O3_CPU::do_finish_store(const LSQ_ENTRY& sq_entry)
     assert(dependent->producer_id == sq_entry.instr_id);
 
     dependent->finish(std::begin(ROB), std::end(ROB));
-    dependent.reset();
+    release_lq_entry(dependent);
+  }
+}
+
+LSQ_ENTRY* O3_CPU::find_forwarding_store(champsim::address addr)
+{
+  auto found = sq_entries_by_address.find(addr.to<uint64_t>());
+  if (found == std::end(sq_entries_by_address)) {
+    return nullptr;
   }
+
+  // The youngest store to the address. If one instruction stores to it more than once, take the first of those.
+  const auto& stores = found->second;
+  auto youngest = std::prev(std::end(stores));
+  while (youngest != std::begin(stores) && (*std::prev(youngest))->instr_id == (*youngest)->instr_id) {
+    --youngest;
+  }
+  return *youngest;
+}
+
+void O3_CPU::release_lq_entry(std::optional<LSQ_ENTRY>& lq_entry)
+{
+  assert(lq_entry.has_value());
+  auto slot = static_cast<std::size_t>(std::distance(std::data(LQ), &lq_entry));
+
+  auto [instr_begin, instr_end] = lq_slots_by_instr.equal_range(lq_entry->instr_id);
+  lq_slots_by_instr.erase(std::find_if(instr_begin, instr_end, [slot](const auto& x) { return x.second == slot; }));
+  if (lq_entry->fetch_issued) {
+    auto [block_begin, block_end] = lq_issued_slots_by_block.equal_range(champsim::block_number{lq_entry->virtual_address}.to<uint64_t>());
+    lq_issued_slots_by_block.erase(std::find_if(block_begin, block_end, [slot](const auto& x) { return x.second == slot; }));
+  }
+  lq_unissued_slots.erase(slot);
+
+  lq_entry.reset();
+  lq_free_slots.push(slot);
 }
 
 bool O3_CPU::do_complete_store(const LSQ_ENTRY& sq_entry)
@@ -666,8 +828,13 @@ bool O3_CPU::execute_load(const LSQ_ENTRY& lq_entry)
 void O3_CPU::do_complete_execution(ooo_model_instr& instr)
 {
   for (auto dreg : instr.destination_registers) {
-    // mark physical register's data as valid
-    reg_allocator.complete_dest_register(dreg);
+    // mark physical register's data as valid, and wake the instructions that read it
+    reg_allocator.complete_dest_register(dreg, [this](auto waiter_id) {
+      auto waiter = find_unexecuted(waiter_id);
+      if (waiter != std::end(ROB) && --waiter->num_reg_dependent == 0) {
+        ready_to_execute.push(waiter_id);
+      }
+    });
   }
 
   instr.completed = true;
@@ -724,12 +891,14 @@ long O3_CPU::handle_memory_return()
 
   auto l1d_it = std::begin(L1D_bus.lower_level->returned);
   for (champsim::bandwidth l1d_bw{L1D_BANDWIDTH}; l1d_bw.has_remaining() && l1d_it != std::end(L1D_bus.lower_level->returned); l1d_bw.consume(), ++l1d_it) {
-    for (auto& lq_entry : LQ) {
-      if (lq_entry.has_value() && lq_entry->fetch_issued && champsim::block_number{lq_entry->virtual_address} == champsim::block_number{l1d_it->v_address}) {
-        lq_entry->finish(std::begin(ROB), std::end(ROB));
-        lq_entry.reset();
-        ++progress;
-      }
+    auto [block_begin, block_end] = lq_issued_slots_by_block.equal_range(champsim::block_number{l1d_it->v_address}.to<uint64_t>());
+    std::vector<std::size_t> returned_slots{};
+    std::transform(block_begin, block_end, std::back_inserter(returned_slots), [](const auto& x) { return x.second; });
+    for (auto slot : returned_slots) {
+      auto& lq_entry = LQ.at(slot);
+      lq_entry->finish(std::begin(ROB), std::end(ROB));
+      release_lq_entry(lq_entry);
+      ++progress;
     }
     ++progress;
   }
@@ -749,12 +918,12 @@ long O3_CPU::retire_rob()
     });
   }
 
-  if (commit_trace_stream && (commit_trace_dump_warmup || !warmup)) {
+  if (commit_trace && (commit_trace_dump_warmup || !warmup)) {
     const uint64_t commit_cycle = static_cast<uint64_t>(current_time.time_since_epoch() / clock_period);
     for (auto rob_it = retire_begin; rob_it != retire_end; ++rob_it) {
       const uint64_t delta_cycles = commit_trace_last_cycle ? (commit_cycle - *commit_trace_last_cycle) : 0ULL;
       commit_trace_last_cycle = commit_cycle;
-      rob_it->dump_neuroscalar_csv(*commit_trace_stream, commit_cycle, delta_cycles);
+      commit_trace->push(rob_it->commit_trace_record(commit_cycle, delta_cycles));
     }
   }
 
@@ -767,6 +936,10 @@ long O3_CPU::retire_rob()
   }
 
   auto retire_count = std::distance(retire_begin, retire_end);
+  auto retired_from_prefix = std::min(static_cast<std::size_t>(retire_count), scheduled_prefix);
+  scheduled_prefix_waiting -= static_cast<std::size_t>(
+      std::count_if(retire_begin, std::next(retire_begin, static_cast<long>(retired_from_prefix)), [](const auto& x) { return !x.executed; }));
+  scheduled_prefix -= retired_from_prefix;
   num_retired += retire_count;
   ROB.erase(retire_begin, retire_end);
 
@@ -797,6 +970,49 @@ std::pair<champsim::address, bool> O3_CPU::impl_btb_prediction(champsim::address
   return btb_module_pimpl->impl_btb_prediction(ip, branch_type);
 }
 
+void O3_CPU::save_state(champsim::serialization::output_archive& ar)
+{
+  ar(DIB);
+  branch_module_pimpl->impl_save_state(ar);
+  btb_module_pimpl->impl_save_state(ar);
+}
+
+void O3_CPU::load_state(champsim::serialization::input_archive& ar)
+{
+  ar(DIB);
+  branch_module_pimpl->impl_load_state(ar);
+  btb_module_pimpl->impl_load_state(ar);
+
+  // Instructions in the pipeline are discarded, along with their requests to the caches
+  input_queue.clear();
+  IFETCH_BUFFER.clear();
+  DECODE_BUFFER.clear();
+  DISPATCH_BUFFER.clear();
+  DIB_HIT_BUFFER.clear();
+  ROB.clear();
+
+  std::fill(std::begin(LQ), std::end(LQ), std::nullopt);
+  SQ.clear();
+  lq_free_slots = {};
+  for (std::size_t slot = 0; slot < std::size(LQ); ++slot) {
+    lq_free_slots.push(slot);
+  }
+  lq_slots_by_instr.clear();
+  lq_unissued_slots.clear();
+  lq_issued_slots_by_block.clear();
+  sq_entries_by_address.clear();
+
+  reg_allocator = RegisterAllocator{REGISTER_FILE_SIZE};
+  ready_to_execute = {};
+  scheduled_prefix = 0;
+  scheduled_prefix_waiting = 0;
+  max_scheduled_register_demand = 0;
+  fetch_resume_time = {};
+
+  L1I_bus.lower_level->clear();
+  L1D_bus.lower_level->clear();
+}
+
 // LCOV_EXCL_START Exclude the following function from LCOV
 void O3_CPU::print_deadlock()
 {
@@ -850,7 +1066,7 @@ LSQ_ENTRY::LSQ_ENTRY(champsim::address addr, champsim::program_ordered<LSQ_ENTRY
 {
 }
 
-void LSQ_ENTRY::finish(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end) const
+void LSQ_ENTRY::finish(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end) const
 {
   auto rob_entry = std::partition_point(begin, end, ooo_model_instr::precedes(this->instr_id));
   assert(rob_entry != end);
@@ -30,6 +30,20 @@ long champsim::operable::operate_on(const champsim::chrono::clock& clock)
   return progress;
 }
 
+long champsim::operable::idle_on(const champsim::chrono::clock& clock)
+{
+  long cycles{0};
+  while (current_time < clock.now()) {
+    current_time += clock_period;
+    ++cycles;
+  }
+
+  if (cycles > 0) {
+    idle_cycles(cycles);
+  }
+  return cycles;
+}
+
 long champsim::operable::_operate()
 {
   current_time += clock_period;
@@ -0,0 +1,133 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "operable_scheduler.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+
+champsim::operable_scheduler::operable_scheduler(std::vector<value_type> operables)
+    : operable_scheduler(operables, std::vector<std::size_t>(std::size(operables), shared_partition))
+{
+}
+
+champsim::operable_scheduler::operable_scheduler(std::vector<value_type> operables, std::vector<std::size_t> partitions)
+    : m_operables(std::move(operables)), m_partitions(std::move(partitions))
+{
+  if (std::size(m_partitions) != std::size(m_operables)) {
+    throw std::invalid_argument{"Every operable must be given a partition"};
+  }
+
+  for (auto part : m_partitions) {
+    if (part != shared_partition) {
+      m_num_partitions = std::max(m_num_partitions, part + 1);
+    }
+  }
+
+  for (std::size_t i = 0; i < std::size(m_operables); ++i) {
+    const operable& op = m_operables.at(i);
+    auto same_domain = [&op, this](std::size_t leader_idx) {
+      const operable& leader = m_operables.at(leader_idx);
+      return leader.clock_period == op.clock_period && leader.current_time == op.current_time;
+    };
+    if (std::none_of(std::cbegin(m_domain_leaders), std::cend(m_domain_leaders), same_domain)) {
+      m_domain_leaders.push_back(i);
+    }
+  }
+
+  m_domain_ranks.resize(std::size(m_domain_leaders));
+}
+
+auto champsim::operable_scheduler::make_plan() const -> plan_type
+{
+  std::vector<std::size_t> order(std::size(m_operables));
+  std::iota(std::begin(order), std::end(order), std::size_t{0});
+  std::sort(std::begin(order), std::end(order),
+            [this](std::size_t lhs, std::size_t rhs) { return m_operables[lhs].get().current_time < m_operables[rhs].get().current_time; });
+
+  plan_type plan;
+  plan.private_members.resize(m_num_partitions);
+  bool stage_is_shared = false;
+  for (auto idx : order) {
+    const auto part = m_partitions[idx];
+    if (part == shared_partition) {
+      // Consecutive shared components are operated in turn
+      if (std::empty(plan.stages) || !stage_is_shared) {
+        plan.stages.push_back(stage_type{partition_type{}});
+      }
+      plan.stages.back().front().push_back(m_operables[idx]);
+      plan.shared_members.push_back(m_operables[idx]);
+      stage_is_shared = true;
+    } else {
+      if (std::empty(plan.stages) || stage_is_shared) {
+        plan.stages.push_back(stage_type(m_num_partitions));
+      }
+      plan.stages.back().at(part).push_back(m_operables[idx]);
+      plan.private_members.at(part).push_back(m_operables[idx]);
+      stage_is_shared = false;
+    }
+  }
+
+  for (auto& stage : plan.stages) {
+    stage.erase(std::remove_if(std::begin(stage), std::end(stage), [](const auto& part) { return std::empty(part); }), std::end(stage));
+  }
+
+  return plan;
+}
+
+auto champsim::operable_scheduler::current_plan() -> const plan_type&
+{
+  std::transform(std::cbegin(m_domain_leaders), std::cend(m_domain_leaders), std::begin(m_domain_ranks), [this](std::size_t idx) {
+    const auto time = m_operables[idx].get().current_time;
+    return std::count_if(std::cbegin(m_domain_leaders), std::cend(m_domain_leaders),
+                         [time, this](std::size_t other_idx) { return m_operables[other_idx].get().current_time < time; });
+  });
+
+  // Most cycles keep the relative order of the previous one
+  if (m_last_plan < std::size(m_plans) && m_plans[m_last_plan].first == m_domain_ranks) {
+    return m_plans[m_last_plan].second;
+  }
+
+  auto found = std::find_if(std::begin(m_plans), std::end(m_plans), [this](const auto& entry) { return entry.first == m_domain_ranks; });
+  if (found == std::end(m_plans)) {
+    found = m_plans.insert(std::end(m_plans), {m_domain_ranks, make_plan()});
+  }
+
+  m_last_plan = static_cast<std::size_t>(std::distance(std::begin(m_plans), found));
+  return found->second;
+}
+
+long champsim::operable_scheduler::operate_on(const champsim::chrono::clock& clock)
+{
+  long progress{0};
+  for (const auto& stage : current_plan().stages) {
+    for (const auto& part : stage) {
+      for (champsim::operable& op : part) {
+        progress += op.operate_on(clock);
+      }
+    }
+  }
+
+  return progress;
+}
+
+auto champsim::operable_scheduler::operables() const -> const std::vector<value_type>& { return m_operables; }
+
+std::size_t champsim::operable_scheduler::num_domains() const { return std::size(m_domain_leaders); }
+
+std::size_t champsim::operable_scheduler::num_partitions() const { return m_num_partitions; }
@@ -0,0 +1,211 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "parallel_engine.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include "environment.h"
+#include "ptw.h"
+
+std::vector<std::size_t> champsim::core_partitions(environment& env)
+{
+  auto operables = env.operable_view();
+
+  // The component that takes requests from each channel
+  std::map<const champsim::channel*, const champsim::operable*> consumer;
+  for (const champsim::operable& op : operables) {
+    for (const auto* ul : op.upper_channels()) {
+      consumer[ul] = &op;
+    }
+  }
+
+  // Walk down the hierarchy from each core
+  std::map<const champsim::operable*, std::vector<std::size_t>> reached_from;
+  auto cpus = env.cpu_view();
+  for (std::size_t cpu_idx = 0; cpu_idx < std::size(cpus); ++cpu_idx) {
+    std::vector<const champsim::operable*> to_visit{&cpus.at(cpu_idx).get()};
+    while (!std::empty(to_visit)) {
+      const auto* op = to_visit.back();
+      to_visit.pop_back();
+
+      auto& reachers = reached_from[op];
+      if (std::find(std::begin(reachers), std::end(reachers), cpu_idx) != std::end(reachers)) {
+        continue;
+      }
+      reachers.push_back(cpu_idx);
+
+      for (const auto* ll : op->lower_channels()) {
+        if (auto found = consumer.find(ll); found != std::end(consumer)) {
+          to_visit.push_back(found->second);
+        }
+      }
+    }
+  }
+
+  // Walkers allocate pages from the virtual memory, which is shared by every core
+  auto ptws = env.ptw_view();
+  auto is_ptw = [&ptws](const champsim::operable& op) {
+    return std::any_of(std::begin(ptws), std::end(ptws), [&op](const PageTableWalker& ptw) { return &op == &ptw; });
+  };
+
+  std::vector<std::size_t> retval;
+  for (const champsim::operable& op : operables) {
+    const auto& reachers = reached_from[&op];
+    if (std::size(reachers) == 1 && !is_ptw(op)) {
+      retval.push_back(reachers.front());
+    } else {
+      retval.push_back(operable_scheduler::shared_partition);
+    }
+  }
+
+  return retval;
+}
+
+champsim::parallel_engine::parallel_engine(std::size_t num_threads)
+{
+  if (num_threads == 0) {
+    throw std::invalid_argument{"A parallel engine needs at least one thread"};
+  }
+
+  for (std::size_t i = 1; i < num_threads; ++i) {
+    m_workers.emplace_back([this] { this->worker_loop(); });
+  }
+}
+
+champsim::parallel_engine::~parallel_engine()
+{
+  m_stop.store(true, std::memory_order_release);
+  m_generation.fetch_add(1, std::memory_order_acq_rel);
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+std::size_t champsim::parallel_engine::num_threads() const { return std::size(m_workers) + 1; }
+
+void champsim::parallel_engine::work()
+{
+  for (auto idx = m_next_task.fetch_add(1, std::memory_order_acq_rel); idx < m_num_tasks; idx = m_next_task.fetch_add(1, std::memory_order_acq_rel)) {
+    try {
+      m_progress.fetch_add((*m_task)(idx), std::memory_order_relaxed);
+    } catch (...) {
+      std::lock_guard lock{m_error_mutex};
+      if (!m_error) {
+        m_error = std::current_exception();
+      }
+    }
+  }
+}
+
+void champsim::parallel_engine::worker_loop()
+{
+  uint64_t seen_generation = 0;
+  while (true) {
+    // The stages of a cycle are short, so wait without sleeping
+    uint64_t generation = m_generation.load(std::memory_order_acquire);
+    while (generation == seen_generation) {
+      std::this_thread::yield();
+      generation = m_generation.load(std::memory_order_acquire);
+    }
+    seen_generation = generation;
+
+    if (m_stop.load(std::memory_order_acquire)) {
+      return;
+    }
+
+    work();
+    m_workers_done.fetch_add(1, std::memory_order_acq_rel);
+  }
+}
+
+long champsim::parallel_engine::run_concurrently(std::size_t count, const std::function<long(std::size_t)>& task)
+{
+  // Every worker has finished the previous generation, so none can take a task before the new one is set up
+  m_task = &task;
+  m_num_tasks = count;
+  m_progress.store(0, std::memory_order_relaxed);
+  m_workers_done.store(0, std::memory_order_relaxed);
+  m_next_task.store(0, std::memory_order_relaxed);
+  m_generation.fetch_add(1, std::memory_order_acq_rel);
+
+  work();
+  while (m_workers_done.load(std::memory_order_acquire) < std::size(m_workers)) {
+    std::this_thread::yield();
+  }
+
+  if (m_error) {
+    std::rethrow_exception(std::exchange(m_error, nullptr));
+  }
+  return m_progress.load(std::memory_order_relaxed);
+}
+
+long champsim::parallel_engine::operate_on(operable_scheduler& scheduler, const champsim::chrono::clock& clock)
+{
+  long progress{0};
+  for (const auto& stage : scheduler.current_plan().stages) {
+    auto operate_partition = [&stage, &clock](std::size_t idx) {
+      long part_progress{0};
+      for (champsim::operable& op : stage.at(idx)) {
+        part_progress += op.operate_on(clock);
+      }
+      return part_progress;
+    };
+
+    if (std::size(stage) == 1 || std::empty(m_workers)) {
+      for (std::size_t idx = 0; idx < std::size(stage); ++idx) {
+        progress += operate_partition(idx);
+      }
+    } else {
+      progress += run_concurrently(std::size(stage), operate_partition);
+    }
+  }
+
+  return progress;
+}
+
+long champsim::parallel_engine::run_ahead(operable_scheduler& scheduler, champsim::chrono::clock& clock, champsim::chrono::clock::duration time_quantum,
+                                          long quanta, const std::function<void(std::size_t)>& after_tick)
+{
+  const auto& plan = scheduler.current_plan();
+
+  auto run_partition = [&plan, &after_tick, start = clock, time_quantum, quanta](std::size_t idx) {
+    auto local_clock = start;
+    long part_progress{0};
+    for (long i = 0; i < quanta; ++i) {
+      local_clock.tick(time_quantum);
+      for (champsim::operable& op : plan.private_members.at(idx)) {
+        part_progress += op.operate_on(local_clock);
+      }
+      after_tick(idx);
+    }
+    return part_progress;
+  };
+  long progress = run_concurrently(std::size(plan.private_members), run_partition);
+
+  for (long i = 0; i < quanta; ++i) {
+    clock.tick(time_quantum);
+    for (champsim::operable& op : plan.shared_members) {
+      progress += op.operate_on(clock);
+    }
+  }
+
+  return progress;
+}
@@ -16,8 +16,10 @@
 
 #include "ptw.h"
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <stdexcept>
 #include <fmt/chrono.h>
 #include <fmt/core.h>
 
@@ -180,6 +182,35 @@ long PageTableWalker::operate()
   return progress;
 }
 
+champsim::chrono::clock::time_point PageTableWalker::next_event_time() const
+{
+  const auto next_cycle = current_time + clock_period;
+
+  auto has_requests = [](const auto* ul) {
+    return !std::empty(ul->RQ);
+  };
+  if (!std::empty(lower_level->returned) || std::any_of(std::begin(upper_levels), std::end(upper_levels), has_requests)) {
+    return next_cycle;
+  }
+
+  // Walks are taken in order from the front of each queue
+  auto next_event = champsim::chrono::clock::time_point::max();
+  for (const auto& queue : {std::cref(completed), std::cref(finished)}) {
+    if (!std::empty(queue.get())) {
+      if (queue.get().front().data.is_ready_at(current_time)) {
+        return next_cycle;
+      }
+      next_event = std::min(next_event, queue.get().front().data.ready_time().value_or(next_event));
+    }
+  }
+
+  return std::max(next_event, next_cycle);
+}
+
+std::vector<const champsim::channel*> PageTableWalker::upper_channels() const { return {std::begin(upper_levels), std::end(upper_levels)}; }
+
+std::vector<const champsim::channel*> PageTableWalker::lower_channels() const { return {lower_level}; }
+
 void PageTableWalker::finish_packet(const response_type& packet)
 {
   auto finish_step = [this](auto mshr_entry) {
@@ -232,6 +263,32 @@ void PageTableWalker::begin_phase()
   }
 }
 
+void PageTableWalker::save_state(champsim::serialization::output_archive& ar)
+{
+  ar(static_cast<uint64_t>(std::size(pscl)));
+  for (auto& table : pscl) {
+    ar(table);
+  }
+}
+
+void PageTableWalker::load_state(champsim::serialization::input_archive& ar)
+{
+  uint64_t count{};
+  ar(count);
+  if (count != std::size(pscl)) {
+    throw std::runtime_error(fmt::format("[{}] snapshot holds {} PSCLs, expected {}", NAME, count, std::size(pscl)));
+  }
+  for (auto& table : pscl) {
+    ar(table);
+  }
+
+  // Walks in progress are discarded
+  MSHR.clear();
+  finished.clear();
+  completed.clear();
+  lower_level->clear();
+}
+
 // LCOV_EXCL_START Exclude the following function from LCOV
 void PageTableWalker::print_deadlock()
 {
@@ -9,6 +9,7 @@ RegisterAllocator::RegisterAllocator(size_t num_physical_registers)
     free_registers.push(static_cast<PHYSICAL_REGISTER_ID>(i));
   }
   physical_register_file = std::vector<physical_register>(num_physical_registers, {0, 0, false, false});
+  register_waiters.resize(num_physical_registers);
   frontend_RAT.fill(-1); // default value for no mapping
   backend_RAT.fill(-1);
 }
@@ -44,8 +45,12 @@ PHYSICAL_REGISTER_ID RegisterAllocator::rename_src_register(int16_t reg)
 
 void RegisterAllocator::complete_dest_register(PHYSICAL_REGISTER_ID physreg)
 {
-  // mark the physical register as valid
-  physical_register_file.at(physreg).valid = true;
+  complete_dest_register(physreg, [](auto) {});
+}
+
+void RegisterAllocator::wait_for_register(PHYSICAL_REGISTER_ID physreg, champsim::program_ordered<ooo_model_instr>::id_type waiter)
+{
+  register_waiters.at(physreg).push_back(waiter);
 }
 
 void RegisterAllocator::retire_dest_register(PHYSICAL_REGISTER_ID physreg)
@@ -66,6 +71,7 @@ void RegisterAllocator::retire_dest_register(PHYSICAL_REGISTER_ID physreg)
 void RegisterAllocator::free_register(PHYSICAL_REGISTER_ID physreg)
 {
   physical_register_file.at(physreg) = {255, 0, false, false}; // arch_reg_index, producing_inst_id, valid, busy
+  register_waiters.at(physreg).clear();
   free_registers.push(physreg);
 }
 
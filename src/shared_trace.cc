@@ -0,0 +1,231 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shared_trace.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace champsim
+{
+struct shared_trace::state_type {
+  tracereader source;
+  uint64_t source_instr_ids = 0;
+  std::size_t depth;
+  std::size_t batch_size;
+
+  std::mutex mutex{};
+  std::condition_variable published{}; // a batch was published, or the trace ended
+  std::condition_variable released{};  // a consumer finished with a batch, left, or began to wait
+  std::deque<std::shared_ptr<const std::vector<ooo_model_instr>>> batches; // the batches not yet read by every consumer
+  uint64_t base = 0;                                                       // the index of the first of the batches
+  uint64_t tail = 0;                                                       // the next batch to be produced
+  std::vector<uint64_t> heads; // the next batch to be consumed by each consumer, written only by that consumer
+  std::size_t waiting = 0;     // the number of consumers waiting for the next batch
+  std::vector<bool> attached;
+  std::vector<bool> taken;
+  bool finished = false;
+  bool stop = false;
+  std::exception_ptr error{};
+  std::thread producer{};
+
+  state_type(tracereader&& source_, std::size_t consumers, std::size_t depth_, std::size_t batch_size_)
+      : source(std::move(source_)), depth(depth_), batch_size(batch_size_), heads(consumers, 0), attached(consumers, true), taken(consumers, false)
+  {
+    source.use_instr_ids(source_instr_ids);
+  }
+
+  state_type(const state_type&) = delete;
+  state_type& operator=(const state_type&) = delete;
+
+  ~state_type()
+  {
+    {
+      std::lock_guard lock{mutex};
+      stop = true;
+    }
+    released.notify_one();
+    if (producer.joinable()) {
+      producer.join();
+    }
+  }
+
+  // Must be called with the mutex held
+  [[nodiscard]] uint64_t slowest_head() const
+  {
+    auto slowest = tail;
+    for (std::size_t i = 0; i < std::size(heads); ++i) {
+      if (attached[i]) {
+        slowest = std::min(slowest, heads[i]);
+      }
+    }
+    return slowest;
+  }
+
+  // Must be called with the mutex held
+  [[nodiscard]] bool has_room() const { return tail - slowest_head() < depth; }
+
+  // Drop the batches that every consumer has read. Must be called with the mutex held
+  void release_read()
+  {
+    for (const auto slowest = slowest_head(); base < slowest; ++base) {
+      batches.pop_front();
+    }
+  }
+
+  // Must be called with the mutex held
+  [[nodiscard]] bool any_attached() const { return std::any_of(std::begin(attached), std::end(attached), [](bool x) { return x; }); }
+
+  // Must be called with the mutex held
+  void start()
+  {
+    if (!producer.joinable() && !finished) {
+      producer = std::thread{[this] { this->produce(); }};
+    }
+  }
+
+  void produce();
+};
+
+void shared_trace::state_type::produce()
+{
+  try {
+    while (true) {
+      {
+        std::unique_lock lock{mutex};
+        // A waiting consumer is served even if the others are too far behind. Otherwise, a consumer that reads several traces could wait
+        // on one of them for a consumer that waits on another for it.
+        released.wait(lock, [this] { return stop || !any_attached() || has_room() || waiting > 0; });
+        if (stop || !any_attached()) {
+          return;
+        }
+      }
+
+      std::vector<ooo_model_instr> batch;
+      batch.reserve(batch_size);
+      while (std::size(batch) < batch_size && !source.eof()) {
+        batch.push_back(source());
+      }
+
+      const bool ended = source.eof();
+      {
+        std::lock_guard lock{mutex};
+        if (!std::empty(batch)) {
+          batches.push_back(std::make_shared<const std::vector<ooo_model_instr>>(std::move(batch)));
+          ++tail;
+        }
+        finished = ended;
+      }
+      published.notify_all();
+
+      if (ended) {
+        return;
+      }
+    }
+  } catch (...) {
+    {
+      std::lock_guard lock{mutex};
+      error = std::current_exception();
+      finished = true;
+    }
+    published.notify_all();
+  }
+}
+
+shared_trace::shared_trace(tracereader&& source, std::size_t consumers, std::size_t depth, std::size_t batch_size)
+    : state(std::make_shared<state_type>(std::move(source), consumers, depth, batch_size))
+{
+  if (consumers == 0 || depth == 0 || batch_size == 0) {
+    throw std::invalid_argument{"A shared trace needs at least one consumer and room for at least one instruction"};
+  }
+}
+
+tracereader shared_trace::reader(std::size_t consumer)
+{
+  std::lock_guard lock{state->mutex};
+  if (consumer >= std::size(state->taken) || state->taken[consumer]) {
+    throw std::invalid_argument{"Each consumer of a shared trace takes exactly one reader"};
+  }
+  state->taken[consumer] = true;
+  return tracereader{cursor{state, consumer}};
+}
+
+shared_trace::cursor::cursor(std::shared_ptr<state_type> state_, std::size_t consumer_) : state(std::move(state_)), consumer(consumer_) {}
+
+shared_trace::cursor::~cursor()
+{
+  if (state) {
+    {
+      std::lock_guard lock{state->mutex};
+      state->attached[consumer] = false;
+      state->release_read();
+    }
+    state->released.notify_one();
+  }
+}
+
+bool shared_trace::cursor::wait_for_batch() const
+{
+  if (batch) {
+    return true;
+  }
+
+  std::unique_lock lock{state->mutex};
+  state->start();
+  auto ready = [this] { return state->heads[consumer] != state->tail || state->finished; };
+  if (!ready()) {
+    ++state->waiting;
+    state->released.notify_one();
+    state->published.wait(lock, ready);
+    --state->waiting;
+  }
+  if (state->heads[consumer] != state->tail) {
+    batch = state->batches.at(state->heads[consumer] - state->base);
+    return true;
+  }
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+  return false;
+}
+
+ooo_model_instr shared_trace::cursor::operator()()
+{
+  if (!wait_for_batch()) {
+    throw std::runtime_error{"Read past the end of a trace"};
+  }
+
+  auto retval = (*batch)[consumed++];
+  if (consumed == std::size(*batch)) {
+    consumed = 0;
+    batch.reset();
+    {
+      std::lock_guard lock{state->mutex};
+      ++state->heads[consumer];
+      state->release_read();
+    }
+    state->released.notify_one();
+  }
+  return retval;
+}
+} // namespace champsim
@@ -0,0 +1,374 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sim_server.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "cache_checkpoint.h"
+#include "module_registry.h"
+#include "sim_snapshot.h"
+#include "stats_printer.h"
+
+namespace champsim
+{
+phase_stats do_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock);
+}
+
+namespace
+{
+std::vector<std::string> split_words(std::string_view line)
+{
+  std::vector<std::string> words;
+  std::istringstream stream{std::string{line}};
+  for (std::string word; stream >> word;) {
+    words.push_back(word);
+  }
+  return words;
+}
+
+long long parse_count(const std::string& word)
+{
+  std::size_t used = 0;
+  long long value = -1;
+  try {
+    value = std::stoll(word, &used);
+  } catch (const std::logic_error&) {
+    used = 0;
+  }
+  if (used != std::size(word) || value < 0) {
+    throw std::invalid_argument(fmt::format("'{}' is not an instruction count", word));
+  }
+  return value;
+}
+
+std::string ok_response(nlohmann::json fields = nlohmann::json::object())
+{
+  fields["status"] = "ok";
+  return fields.dump();
+}
+
+std::string error_response(std::string_view message) { return nlohmann::json{{"status", "error"}, {"message", std::string{message}}}.dump(); }
+
+class socket_fd
+{
+  int fd;
+
+public:
+  explicit socket_fd(int descriptor) : fd(descriptor)
+  {
+    if (fd < 0) {
+      throw std::runtime_error(fmt::format("Socket error: {}", std::strerror(errno)));
+    }
+  }
+  socket_fd(const socket_fd&) = delete;
+  socket_fd& operator=(const socket_fd&) = delete;
+  ~socket_fd() { ::close(fd); }
+
+  [[nodiscard]] int get() const { return fd; }
+};
+
+bool write_all(int fd, std::string_view data)
+{
+  while (!data.empty()) {
+    auto written = ::write(fd, std::data(data), std::size(data));
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    data.remove_prefix(static_cast<std::size_t>(written));
+  }
+  return true;
+}
+} // namespace
+
+champsim::simulation_server::simulation_server(environment& env_, std::vector<tracereader>& traces_, std::vector<std::string> trace_names_,
+                                               trace_opener open_trace_)
+    : env(env_), traces(traces_), trace_names(std::move(trace_names_)), trace_index(std::size(trace_names)), open_trace(std::move(open_trace_))
+{
+  std::iota(std::begin(trace_index), std::end(trace_index), 0);
+  for (champsim::operable& op : env.operable_view()) {
+    op.initialize();
+  }
+}
+
+std::string champsim::simulation_server::run_window(std::string_view name, bool is_warmup, long long length)
+{
+  phase_info phase;
+  phase.name = fmt::format("{}-{}", name, window_count++);
+  phase.is_warmup = is_warmup;
+  phase.length = length;
+  phase.trace_index = trace_index;
+  phase.trace_names = trace_names;
+
+  auto stats = do_phase(phase, env, traces, global_clock);
+
+  std::ostringstream stats_text;
+  champsim::json_printer{stats_text}.print(stats);
+
+  const bool eof = std::any_of(std::begin(traces), std::end(traces), [](const auto& tr) { return tr.eof(); });
+  return ok_response({{"eof", eof}, {"stats", nlohmann::json::parse(stats_text.str())}});
+}
+
+std::string champsim::simulation_server::skip(uint64_t count)
+{
+  std::vector<uint64_t> skipped;
+  std::transform(std::begin(traces), std::end(traces), std::back_inserter(skipped), [count](auto& tr) { return tr.skip(count); });
+  return ok_response({{"skipped", skipped}});
+}
+
+std::string champsim::simulation_server::select_module(std::string_view kind, std::string_view cache_name, std::string_view module_names)
+{
+  auto caches = env.cache_view();
+  auto cache = std::find_if(std::begin(caches), std::end(caches), [cache_name](const CACHE& c) { return c.NAME == cache_name; });
+  if (cache == std::end(caches)) {
+    throw std::invalid_argument(fmt::format("Unknown cache '{}'", cache_name));
+  }
+
+  std::vector<std::string> names;
+  std::istringstream name_stream{std::string{module_names}};
+  for (std::string name; std::getline(name_stream, name, ',');) {
+    names.push_back(name);
+  }
+
+  // The new modules replace ones that are already running, so they are initialized here
+  const auto& registry = champsim::modules::registry::compiled();
+  if (kind == "prefetcher") {
+    registry.select_prefetcher(*cache, names);
+    cache->get().impl_prefetcher_initialize();
+  } else {
+    registry.select_replacement(*cache, names);
+    cache->get().impl_initialize_replacement();
+  }
+
+  return ok_response();
+}
+
+std::string champsim::simulation_server::save(std::string_view path, std::string_view format)
+{
+  if (format != "bin" && format != "text") {
+    throw std::invalid_argument(fmt::format("Unknown checkpoint format '{}'", format));
+  }
+  save_cache_checkpoint(env, std::string{path}, (format == "text") ? checkpoint_format::text : checkpoint_format::binary);
+  return ok_response();
+}
+
+std::string champsim::simulation_server::load(std::string_view path)
+{
+  load_cache_checkpoint(env, std::string{path});
+  return ok_response();
+}
+
+std::string champsim::simulation_server::snapshot(std::string_view path)
+{
+  save_snapshot(env, std::filesystem::path{path});
+  return ok_response();
+}
+
+std::string champsim::simulation_server::restore(std::string_view path)
+{
+  load_snapshot(env, std::filesystem::path{path});
+  return ok_response();
+}
+
+std::string champsim::simulation_server::branch(std::string_view socket_path)
+{
+  if (!open_trace) {
+    throw std::invalid_argument("This server cannot reopen its traces, so it cannot branch");
+  }
+
+  // Open the traces before forking, so that a failure is reported here rather than in the child
+  std::vector<tracereader> fresh_traces;
+  for (std::size_t i = 0; i < std::size(traces); ++i) {
+    fresh_traces.push_back(open_trace(i));
+  }
+
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+
+  auto pid = ::fork();
+  if (pid < 0) {
+    throw std::runtime_error(fmt::format("Unable to fork: {}", std::strerror(errno)));
+  }
+
+  if (pid == 0) {
+    // The child does not speak to the parent's clients
+    for (int fd : open_sockets) {
+      ::close(fd);
+    }
+    open_sockets.clear();
+    branches.clear();
+
+    // The commit traces, and the threads that write them, belong to the parent
+    for (O3_CPU& cpu : env.cpu_view()) {
+      cpu.close_commit_trace();
+    }
+
+    int status = 0;
+    try {
+      // The file offsets of the parent's traces are shared with the child, so the child must read its own copies
+      for (std::size_t i = 0; i < std::size(traces); ++i) {
+        traces.at(i).reopen(std::move(fresh_traces.at(i)));
+      }
+      done = false;
+      serve_unix_socket(std::string{socket_path});
+    } catch (const std::exception& err) {
+      fmt::print(stderr, "ERROR: {}\n", err.what());
+      status = 1;
+    }
+    std::fflush(nullptr);
+    std::_Exit(status);
+  }
+
+  branches.push_back(pid);
+  return ok_response({{"pid", pid}, {"socket", std::string{socket_path}}});
+}
+
+void champsim::simulation_server::reap_children()
+{
+  // Only wait on branches, since the trace readers may have children of their own
+  auto finished = [](int pid) { return ::waitpid(pid, nullptr, WNOHANG) != 0; };
+  branches.erase(std::remove_if(std::begin(branches), std::end(branches), finished), std::end(branches));
+}
+
+std::string champsim::simulation_server::execute(std::string_view command)
+{
+  reap_children();
+
+  const auto words = split_words(command);
+  if (words.empty()) {
+    return error_response("Empty command");
+  }
+
+  const auto& verb = words.front();
+  auto require_args = [&](std::size_t min_count, std::size_t max_count, std::string_view usage) {
+    if (std::size(words) < min_count + 1 || std::size(words) > max_count + 1) {
+      throw std::invalid_argument(fmt::format("Usage: {}", usage));
+    }
+  };
+
+  try {
+    if (verb == "run" || verb == "warmup") {
+      require_args(1, 1, fmt::format("{} N", verb));
+      return run_window(verb == "run" ? "Simulation" : "Warmup", verb == "warmup", parse_count(words.at(1)));
+    }
+    if (verb == "skip") {
+      require_args(1, 1, "skip N");
+      return skip(static_cast<uint64_t>(parse_count(words.at(1))));
+    }
+    if (verb == "prefetcher" || verb == "replacement") {
+      require_args(2, 2, fmt::format("{} CACHE NAME[,NAME...]", verb));
+      return select_module(verb, words.at(1), words.at(2));
+    }
+    if (verb == "save") {
+      require_args(1, 2, "save PATH [bin|text]");
+      return save(words.at(1), std::size(words) > 2 ? words.at(2) : "bin");
+    }
+    if (verb == "load") {
+      require_args(1, 1, "load PATH");
+      return load(words.at(1));
+    }
+    if (verb == "snapshot") {
+      require_args(1, 1, "snapshot PATH");
+      return snapshot(words.at(1));
+    }
+    if (verb == "restore") {
+      require_args(1, 1, "restore PATH");
+      return restore(words.at(1));
+    }
+    if (verb == "branch") {
+      require_args(1, 1, "branch SOCKET");
+      return branch(words.at(1));
+    }
+    if (verb == "quit") {
+      done = true;
+      return ok_response();
+    }
+  } catch (const std::exception& err) {
+    return error_response(err.what());
+  }
+
+  return error_response(fmt::format("Unknown command '{}'", verb));
+}
+
+void champsim::simulation_server::serve(std::istream& input, std::ostream& output)
+{
+  for (std::string line; !done && std::getline(input, line);) {
+    output << execute(line) << std::endl;
+  }
+}
+
+void champsim::simulation_server::serve_unix_socket(const std::string& socket_path)
+{
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (std::size(socket_path) >= sizeof(address.sun_path)) {
+    throw std::invalid_argument(fmt::format("Socket path '{}' is too long", socket_path));
+  }
+  std::copy(std::begin(socket_path), std::end(socket_path), std::begin(address.sun_path));
+
+  socket_fd listener{::socket(AF_UNIX, SOCK_STREAM, 0)};
+  open_sockets.push_back(listener.get());
+  ::unlink(socket_path.c_str());
+  if (::bind(listener.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener.get(), 1) != 0) {
+    throw std::runtime_error(fmt::format("Unable to listen on '{}': {}", socket_path, std::strerror(errno)));
+  }
+
+  while (!done) {
+    socket_fd client{::accept(listener.get(), nullptr, nullptr)};
+    open_sockets.push_back(client.get());
+
+    std::string pending;
+    std::array<char, 4096> buffer;
+    bool connected = true;
+    while (connected && !done) {
+      auto received = ::read(client.get(), std::data(buffer), std::size(buffer));
+      if (received < 0 && errno == EINTR) {
+        continue;
+      }
+      connected = (received > 0);
+      pending.append(std::data(buffer), static_cast<std::size_t>(std::max<decltype(received)>(received, 0)));
+
+      for (auto newline = pending.find('\n'); connected && !done && newline != std::string::npos; newline = pending.find('\n')) {
+        auto response = execute(std::string_view{pending}.substr(0, newline));
+        pending.erase(0, newline + 1);
+        connected = write_all(client.get(), response + "\n");
+      }
+    }
+    open_sockets.pop_back();
+  }
+
+  open_sockets.pop_back();
+  ::unlink(socket_path.c_str());
+}
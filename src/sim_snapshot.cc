@@ -0,0 +1,138 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sim_snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+
+#include "environment.h"
+#include "ptw.h"
+#include "serialization.h"
+#include "vmem.h"
+
+namespace
+{
+std::vector<VirtualMemory*> distinct_vmems(champsim::environment& env)
+{
+  std::vector<VirtualMemory*> retval;
+  for (PageTableWalker& ptw : env.ptw_view()) {
+    if (ptw.vmem != nullptr && std::find(std::begin(retval), std::end(retval), ptw.vmem) == std::end(retval)) {
+      retval.push_back(ptw.vmem);
+    }
+  }
+  return retval;
+}
+
+template <typename F>
+std::string write_section(F&& func)
+{
+  std::ostringstream section;
+  champsim::serialization::output_archive ar{section};
+  func(ar);
+  return section.str();
+}
+
+template <typename F>
+void read_section(const std::string& data, std::size_t index, F&& func)
+{
+  std::istringstream section{data};
+  champsim::serialization::input_archive ar{section};
+  func(ar);
+  if (section.peek() != std::istringstream::traits_type::eof()) {
+    throw std::runtime_error(fmt::format("Snapshot section {} was not fully consumed. The snapshot was written by a different configuration.", index));
+  }
+}
+} // namespace
+
+void champsim::save_snapshot(environment& env, std::ostream& stream)
+{
+  std::vector<std::string> sections;
+  for (champsim::operable& op : env.operable_view()) {
+    sections.push_back(write_section([&](auto& ar) { op.save_state(ar); }));
+  }
+  for (VirtualMemory* vmem : distinct_vmems(env)) {
+    sections.push_back(write_section([&](auto& ar) { vmem->save_state(ar); }));
+  }
+
+  champsim::serialization::output_archive ar{stream};
+  ar(snapshot::magic, snapshot::version, static_cast<uint64_t>(std::size(sections)));
+  for (const auto& section : sections) {
+    ar(section);
+  }
+
+  if (!stream) {
+    throw std::runtime_error("Failed while writing snapshot");
+  }
+}
+
+void champsim::save_snapshot(environment& env, const std::filesystem::path& file_path)
+{
+  std::ofstream out_file{file_path, std::ios::binary | std::ios::trunc};
+  if (!out_file.is_open()) {
+    throw std::runtime_error(fmt::format("Unable to open '{}' for writing snapshot", file_path.string()));
+  }
+  save_snapshot(env, out_file);
+}
+
+void champsim::load_snapshot(environment& env, std::istream& stream)
+{
+  champsim::serialization::input_archive ar{stream};
+
+  char file_magic[sizeof(snapshot::magic)] = {};
+  uint32_t file_version{};
+  ar(file_magic, file_version);
+  if (std::memcmp(file_magic, snapshot::magic, sizeof(file_magic)) != 0) {
+    throw std::runtime_error("Not a simulator snapshot");
+  }
+  if (file_version != snapshot::version) {
+    throw std::runtime_error(fmt::format("Snapshot has version {}, expected {}", file_version, snapshot::version));
+  }
+
+  auto operables = env.operable_view();
+  auto vmems = distinct_vmems(env);
+  std::vector<std::string> sections;
+  ar(sections);
+  if (std::size(sections) != std::size(operables) + std::size(vmems)) {
+    throw std::runtime_error(
+        fmt::format("Snapshot holds {} sections, but the configuration has {}", std::size(sections), std::size(operables) + std::size(vmems)));
+  }
+
+  auto section = std::cbegin(sections);
+  for (champsim::operable& op : operables) {
+    read_section(*section, static_cast<std::size_t>(std::distance(std::cbegin(sections), section)), [&](auto& sec_ar) { op.load_state(sec_ar); });
+    ++section;
+  }
+  for (VirtualMemory* vmem : vmems) {
+    read_section(*section, static_cast<std::size_t>(std::distance(std::cbegin(sections), section)), [&](auto& sec_ar) { vmem->load_state(sec_ar); });
+    ++section;
+  }
+}
+
+void champsim::load_snapshot(environment& env, const std::filesystem::path& file_path)
+{
+  std::ifstream in_file{file_path, std::ios::binary};
+  if (!in_file.is_open()) {
+    throw std::runtime_error(fmt::format("Unable to open '{}' for reading snapshot", file_path.string()));
+  }
+  load_snapshot(env, in_file);
+}
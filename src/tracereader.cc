@@ -19,8 +19,10 @@
 #include <fstream>
 #include <string>
 
+#include "background_reader.h"
 #include "inf_stream.h"
 #include "repeatable.h"
+#include "xz_stream.h"
 
 namespace champsim
 {
@@ -32,22 +34,34 @@ ooo_model_instr apply_branch_target(ooo_model_instr branch, const ooo_model_inst
   return branch;
 }
 
+/**
+ * Wrap a reader so that it decompresses on its own thread, if any batches may be read ahead.
+ */
+template <typename R>
+champsim::tracereader make_tracereader(R&& reader, std::size_t read_ahead)
+{
+  if (read_ahead > 0) {
+    return champsim::tracereader{champsim::background_reader<R>{std::forward<R>(reader), read_ahead}};
+  }
+  return champsim::tracereader{std::forward<R>(reader)};
+}
+
 template <template <class, class> typename R, typename T>
-champsim::tracereader get_tracereader_for_type(std::string fname, uint8_t cpu)
+champsim::tracereader get_tracereader_for_type(std::string fname, uint8_t cpu, std::size_t read_ahead)
 {
   if (bool is_gzip_compressed = (fname.substr(std::size(fname) - 2) == "gz"); is_gzip_compressed) {
-    return champsim::tracereader{R<T, champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>>(cpu, fname)};
+    return make_tracereader(R<T, champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>>(cpu, fname), read_ahead);
   }
 
   if (bool is_lzma_compressed = (fname.substr(std::size(fname) - 2) == "xz"); is_lzma_compressed) {
-    return champsim::tracereader{R<T, champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>>(cpu, fname)};
+    return make_tracereader(R<T, champsim::seekable_xz_istream>(cpu, fname), read_ahead);
   }
 
   if (bool is_bzip2_compressed = (fname.substr(std::size(fname) - 3) == "bz2"); is_bzip2_compressed) {
-    return champsim::tracereader{R<T, champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>>(cpu, fname)};
+    return make_tracereader(R<T, champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>>(cpu, fname), read_ahead);
   }
 
-  return champsim::tracereader{R<T, std::ifstream>(cpu, fname)};
+  return make_tracereader(R<T, std::ifstream>(cpu, fname), read_ahead);
 }
 } // namespace champsim
 
@@ -55,18 +69,23 @@ template <typename T, typename S>
 using repeatable_reader_t = champsim::repeatable<champsim::bulk_tracereader<T, S>, uint8_t, std::string>;
 
 champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool repeat)
+{
+  return get_tracereader(fname, cpu, is_cloudsuite, repeat, 0);
+}
+
+champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool repeat, std::size_t read_ahead)
 {
   if (is_cloudsuite && repeat) {
-    return champsim::get_tracereader_for_type<repeatable_reader_t, cloudsuite_instr>(fname, cpu);
+    return champsim::get_tracereader_for_type<repeatable_reader_t, cloudsuite_instr>(fname, cpu, read_ahead);
   }
 
   if (is_cloudsuite && !repeat) {
-    return champsim::get_tracereader_for_type<champsim::bulk_tracereader, cloudsuite_instr>(fname, cpu);
+    return champsim::get_tracereader_for_type<champsim::bulk_tracereader, cloudsuite_instr>(fname, cpu, read_ahead);
   }
 
   if (!is_cloudsuite && repeat) {
-    return champsim::get_tracereader_for_type<repeatable_reader_t, input_instr>(fname, cpu);
+    return champsim::get_tracereader_for_type<repeatable_reader_t, input_instr>(fname, cpu, read_ahead);
   }
 
-  return champsim::get_tracereader_for_type<champsim::bulk_tracereader, input_instr>(fname, cpu);
+  return champsim::get_tracereader_for_type<champsim::bulk_tracereader, input_instr>(fname, cpu, read_ahead);
 }
@@ -16,7 +16,12 @@
 
 #include "vmem.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
 #include <fmt/core.h>
 
 #include "champsim.h"
@@ -49,7 +54,6 @@ VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::si
     }
   }
   populate_pages();
-  shuffle_pages();
 }
 
 VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::size_t page_table_levels, champsim::chrono::clock::duration minor_penalty,
@@ -61,20 +65,38 @@ VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::si
 void VirtualMemory::populate_pages()
 {
   assert(dram.size() > 1_MiB);
-  ppage_free_list.resize(((dram.size() - 1_MiB) / PAGE_SIZE).count());
-  assert(ppage_free_list.size() != 0);
-  champsim::page_number base_address =
-      champsim::page_number{champsim::lowest_address_for_size(std::max<champsim::data::mebibytes>(champsim::data::bytes{PAGE_SIZE}, 1_MiB))};
-  for (auto it = ppage_free_list.begin(); it != ppage_free_list.end(); it++) {
-    *it = base_address;
-    base_address++;
+  num_ppages = static_cast<std::size_t>(((dram.size() - 1_MiB) / PAGE_SIZE).count());
+  assert(num_ppages != 0);
+  first_ppage = champsim::page_number{champsim::lowest_address_for_size(std::max<champsim::data::mebibytes>(champsim::data::bytes{PAGE_SIZE}, 1_MiB))};
+
+  // Each refill hands out the pages in the same order
+  num_allocated_ppages = 0;
+  ppage_swaps.clear();
+  if (randomization_seed.has_value()) {
+    ppage_rng.seed(randomization_seed.value());
   }
+  draw_ppage();
 }
 
-void VirtualMemory::shuffle_pages()
+void VirtualMemory::draw_ppage()
 {
-  if (randomization_seed.has_value())
-    std::shuffle(ppage_free_list.begin(), ppage_free_list.end(), std::mt19937_64{randomization_seed.value()});
+  auto position = num_allocated_ppages;
+  if (randomization_seed.has_value()) {
+    // Swap a random later position into this one. A position that has not been swapped holds its own index.
+    auto chosen = std::uniform_int_distribution<std::size_t>{num_allocated_ppages, num_ppages - 1}(ppage_rng);
+    auto value_at = [this](std::size_t pos) {
+      auto found = ppage_swaps.find(pos);
+      return found == std::end(ppage_swaps) ? pos : found->second;
+    };
+
+    position = value_at(chosen);
+    if (chosen != num_allocated_ppages) {
+      ppage_swaps.insert_or_assign(chosen, value_at(num_allocated_ppages));
+    }
+    ppage_swaps.erase(num_allocated_ppages);
+  }
+
+  next_ppage = first_ppage + static_cast<champsim::page_number::difference_type>(position);
 }
 
 champsim::dynamic_extent VirtualMemory::extent(std::size_t level) const
@@ -93,22 +115,23 @@ uint64_t VirtualMemory::get_offset(champsim::page_number vaddr, std::size_t leve
 champsim::page_number VirtualMemory::ppage_front() const
 {
   assert(available_ppages() > 0);
-  return ppage_free_list.front();
+  return next_ppage;
 }
 
 void VirtualMemory::ppage_pop()
 {
-  ppage_free_list.pop_front();
+  ++num_allocated_ppages;
   if (available_ppages() == 0) {
     if (dram.is_verbose()) {
       fmt::print("[VMEM] WARNING: Out of physical memory, freeing ppages\n");
     }
     populate_pages();
-    shuffle_pages();
+  } else {
+    draw_ppage();
   }
 }
 
-std::size_t VirtualMemory::available_ppages() const { return (ppage_free_list.size()); }
+std::size_t VirtualMemory::available_ppages() const { return num_ppages - num_allocated_ppages; }
 
 std::pair<champsim::page_number, champsim::chrono::clock::duration> VirtualMemory::va_to_pa(uint32_t cpu_num, champsim::page_number vaddr)
 {
@@ -138,8 +161,8 @@ std::pair<champsim::address, champsim::chrono::clock::duration> VirtualMemory::g
   }
 
   champsim::dynamic_extent pte_table_entry_extent{champsim::address::bits, shamt(level)};
-  auto [ppage, fault] =
-      page_table.try_emplace({cpu_num, level, champsim::address_slice{pte_table_entry_extent, vaddr}}, champsim::splice(active_pte_page, next_pte_page));
+  pte_key_type key{cpu_num, static_cast<uint32_t>(level), champsim::address_slice{pte_table_entry_extent, vaddr}.to<uint64_t>()};
+  auto [ppage, fault] = page_table.try_emplace(key, champsim::splice(active_pte_page, next_pte_page));
 
   // this PTE doesn't yet have a mapping
   if (fault) {
@@ -164,3 +187,26 @@ std::pair<champsim::address, champsim::chrono::clock::duration> VirtualMemory::g
 
   return {paddr, penalty};
 }
+
+void VirtualMemory::save_state(champsim::serialization::output_archive& ar) const
+{
+  // The allocation order is drawn from the seed, so only the number of pages left in it is needed to rebuild it
+  ar(vpage_to_ppage_map, page_table, active_pte_page, next_pte_page.to<uint64_t>(), static_cast<uint64_t>(available_ppages()));
+}
+
+void VirtualMemory::load_state(champsim::serialization::input_archive& ar)
+{
+  uint64_t next_pte_offset{};
+  uint64_t free_pages{};
+  ar(vpage_to_ppage_map, page_table, active_pte_page, next_pte_offset, free_pages);
+
+  next_pte_page = champsim::address_slice{champsim::dynamic_extent{next_pte_page.upper_extent(), next_pte_page.lower_extent()}, next_pte_offset};
+
+  populate_pages();
+  if (free_pages == 0 || free_pages > available_ppages()) {
+    throw std::runtime_error(fmt::format("[VMEM] snapshot holds {} free pages, but the physical memory has {}", free_pages, available_ppages()));
+  }
+  while (available_ppages() > free_pages) {
+    ppage_pop();
+  }
+}
@@ -0,0 +1,219 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "xz_stream.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <fmt/core.h>
+
+namespace champsim
+{
+std::optional<std::vector<xz_block_info>> read_xz_index(const std::string& fname)
+{
+  std::ifstream file{fname, std::ios::binary};
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+
+  file.seekg(0, std::ios::end);
+  const auto file_size = static_cast<uint64_t>(file.tellg());
+  file.seekg(0, std::ios::beg);
+
+  decomp_tags::lzma_tag_t<>::inflate_state_type strm{new lzma_stream{}};
+  lzma_index* idx = nullptr;
+  if (::lzma_file_info_decoder(strm.get(), &idx, std::numeric_limits<uint64_t>::max(), file_size) != LZMA_OK) {
+    return std::nullopt;
+  }
+
+  // The decoder jumps from the end of the file backwards through the stream footers and indices
+  std::array<char, 1 << 16> in_buf;
+  auto ret = LZMA_OK;
+  while (ret == LZMA_OK) {
+    if (strm->avail_in == 0) {
+      file.read(std::data(in_buf), std::size(in_buf));
+      strm->next_in = reinterpret_cast<const uint8_t*>(std::data(in_buf));
+      strm->avail_in = static_cast<std::size_t>(file.gcount());
+    }
+
+    ret = ::lzma_code(strm.get(), LZMA_RUN);
+    if (ret == LZMA_SEEK_NEEDED) {
+      file.clear();
+      file.seekg(static_cast<std::streamoff>(strm->seek_pos));
+      strm->avail_in = 0;
+      ret = LZMA_OK;
+    }
+  }
+
+  if (ret != LZMA_STREAM_END) {
+    return std::nullopt;
+  }
+
+  std::vector<xz_block_info> blocks;
+  bool flags_known = true;
+  lzma_index_iter iter;
+  ::lzma_index_iter_init(&iter, idx);
+  while (!::lzma_index_iter_next(&iter, LZMA_INDEX_ITER_NONEMPTY_BLOCK)) {
+    flags_known = flags_known && (iter.stream.flags != nullptr);
+    if (flags_known) {
+      blocks.push_back({iter.block.compressed_file_offset, iter.block.uncompressed_file_offset, iter.stream.flags->check});
+    }
+  }
+  ::lzma_index_end(idx, nullptr);
+
+  if (!flags_known) {
+    return std::nullopt;
+  }
+
+  return blocks;
+}
+
+xz_block_istream::xz_block_istream(const std::string& fname, std::vector<xz_block_info> blocks_, std::size_t first_block)
+    : file(fname, std::ios::binary), blocks(std::move(blocks_)), next_block(first_block)
+{
+}
+
+bool xz_block_istream::open_next_block()
+{
+  if (next_block >= std::size(blocks)) {
+    return false;
+  }
+
+  const auto& info = blocks.at(next_block++);
+  file.clear();
+  file.seekg(static_cast<std::streamoff>(info.compressed_offset));
+
+  std::array<uint8_t, LZMA_BLOCK_HEADER_SIZE_MAX> header;
+  file.read(reinterpret_cast<char*>(std::data(header)), 1);
+
+  *block = lzma_block{};
+  block->version = 1;
+  block->check = info.check;
+  block->header_size = lzma_block_header_size_decode(header.front());
+  file.read(reinterpret_cast<char*>(std::next(std::data(header))), static_cast<std::streamsize>(block->header_size) - 1);
+  if (!file) {
+    throw std::runtime_error(fmt::format("Truncated block header at offset {}", info.compressed_offset));
+  }
+
+  std::array<lzma_filter, LZMA_FILTERS_MAX + 1> filters;
+  block->filters = std::data(filters);
+  if (::lzma_block_header_decode(block.get(), nullptr, std::data(header)) != LZMA_OK) {
+    throw std::runtime_error(fmt::format("Corrupt block header at offset {}", info.compressed_offset));
+  }
+
+  // The decoder keeps its own copy of the filter chain
+  auto ret = ::lzma_block_decoder(strm.get(), block.get());
+  ::lzma_filters_free(std::data(filters), nullptr);
+  block->filters = nullptr;
+  if (ret != LZMA_OK) {
+    throw std::runtime_error(fmt::format("Unable to decode block at offset {}", info.compressed_offset));
+  }
+
+  strm->avail_in = 0;
+  block_open = true;
+  return true;
+}
+
+xz_block_istream& xz_block_istream::read(char* s, std::streamsize count)
+{
+  strm->next_out = reinterpret_cast<uint8_t*>(s);
+  strm->avail_out = static_cast<std::size_t>(count);
+
+  while (strm->avail_out > 0 && !eof_) {
+    if (!block_open && !open_next_block()) {
+      eof_ = true;
+      break;
+    }
+
+    if (strm->avail_in == 0) {
+      file.read(reinterpret_cast<char*>(std::data(in_buf)), static_cast<std::streamsize>(std::size(in_buf)));
+      strm->next_in = std::data(in_buf);
+      strm->avail_in = static_cast<std::size_t>(file.gcount());
+    }
+
+    auto ret = ::lzma_code(strm.get(), LZMA_RUN);
+    if (ret == LZMA_STREAM_END) {
+      block_open = false;
+    } else if (ret != LZMA_OK) {
+      throw std::runtime_error(fmt::format("Error {} while decoding block {}", ret, next_block - 1));
+    }
+  }
+
+  gcount_ = count - static_cast<std::streamsize>(strm->avail_out);
+  return *this;
+}
+
+seekable_xz_istream::seekable_xz_istream(std::string s) : fname(s), stream(std::in_place_index<0>, s) {}
+
+seekable_xz_istream& seekable_xz_istream::read(char* s, std::streamsize count)
+{
+  std::visit([s, count](auto& strm) { strm.read(s, count); }, stream);
+  position += static_cast<uint64_t>(gcount());
+  return *this;
+}
+
+bool seekable_xz_istream::eof() const
+{
+  return std::visit([](const auto& strm) { return strm.eof(); }, stream);
+}
+
+std::streamsize seekable_xz_istream::gcount() const
+{
+  return std::visit([](const auto& strm) { return strm.gcount(); }, stream);
+}
+
+uint64_t seekable_xz_istream::ignore_bytes(uint64_t count)
+{
+  const auto start = position;
+  const auto target = position + count;
+
+  if (!index.has_value()) {
+    index = read_xz_index(fname);
+  }
+
+  // Restart at the last block that begins at or before the target, if that is ahead of us
+  if (index->has_value()) {
+    const auto& blocks = index->value();
+    auto block_it = std::upper_bound(std::begin(blocks), std::end(blocks), target,
+                                     [](uint64_t offset, const xz_block_info& info) { return offset < info.uncompressed_offset; });
+    if (block_it != std::begin(blocks)) {
+      --block_it;
+      if (block_it->uncompressed_offset > position) {
+        stream.emplace<xz_block_istream>(fname, blocks, static_cast<std::size_t>(std::distance(std::begin(blocks), block_it)));
+        position = block_it->uncompressed_offset;
+      }
+    }
+  }
+
+  // Without a second block there is nowhere to restart, so the whole skip is decompressed
+  const bool seekable = index->has_value() && std::size(index->value()) > 1;
+  if (!seekable && !warned_unseekable && count > 0) {
+    fmt::print("WARNING: {} is not split into xz blocks, so skipping instructions decompresses all of them. "
+               "Recompress it with 'xz --block-size=16MiB' to skip by block.\n",
+               fname);
+    warned_unseekable = true;
+  }
+
+  // Decompress and drop the remainder
+  std::array<char, 1 << 16> scratch;
+  while (position < target && !eof()) {
+    read(std::data(scratch), static_cast<std::streamsize>(std::min<uint64_t>(std::size(scratch), target - position)));
+  }
+
+  return position - start;
+}
+} // namespace champsim
@@ -60,3 +60,27 @@ TEST_CASE("An operable with a scale greater than 2 skips multiple cycles")
 
   REQUIRE(uut.count == num_cycles / 4);
 }
+
+TEST_CASE("An operable that passes over idle cycles catches up to the global clock")
+{
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{150};
+  mock_operable uut{period};
+
+  global_clock.tick(champsim::chrono::picoseconds{1000});
+  auto cycles = uut.idle_on(global_clock);
+
+  REQUIRE(uut.count == 0);
+  REQUIRE(cycles == 7);
+  REQUIRE(uut.current_time >= global_clock.now());
+  REQUIRE(uut.current_time - global_clock.now() < period);
+}
+
+TEST_CASE("An operable that cannot tell when it has work is never idle")
+{
+  champsim::chrono::clock::duration period{150};
+  mock_operable uut{period};
+  uut.current_time += 10 * period;
+
+  REQUIRE(uut.next_event_time() == uut.current_time + period);
+}
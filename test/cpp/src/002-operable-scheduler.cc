@@ -0,0 +1,117 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "operable.h"
+#include "operable_scheduler.h"
+
+namespace
+{
+struct logging_operable : champsim::operable {
+  std::size_t id;
+  std::vector<std::size_t>* log;
+  logging_operable(champsim::chrono::picoseconds period, std::size_t id_, std::vector<std::size_t>* log_) : operable(period), id(id_), log(log_) {}
+  long operate()
+  {
+    log->push_back(id);
+    return 1;
+  }
+};
+
+/**
+ * A system of components, some on a faster clock than others, interleaved so that each clock domain is spread throughout the list.
+ */
+struct mixed_system {
+  std::vector<std::size_t> log{};
+  std::deque<logging_operable> elements{};
+
+  explicit mixed_system(std::size_t count)
+  {
+    for (std::size_t i = 0; i < count; ++i) {
+      champsim::chrono::picoseconds period{(i % 3 == 2) ? 625 : 250};
+      elements.emplace_back(period, i, &log);
+    }
+  }
+
+  std::vector<std::reference_wrapper<champsim::operable>> view()
+  {
+    return std::vector<std::reference_wrapper<champsim::operable>>{std::begin(elements), std::end(elements)};
+  }
+};
+
+/**
+ * The operation of a cycle as it would be done without a scheduler
+ */
+long sort_and_operate(std::vector<std::reference_wrapper<champsim::operable>> operables, const champsim::chrono::clock& clock)
+{
+  std::sort(std::begin(operables), std::end(operables),
+            [](const champsim::operable& lhs, const champsim::operable& rhs) { return lhs.current_time < rhs.current_time; });
+  long progress{0};
+  for (champsim::operable& op : operables) {
+    progress += op.operate_on(clock);
+  }
+  return progress;
+}
+} // namespace
+
+TEST_CASE("The operable scheduler groups components by clock domain")
+{
+  mixed_system system{24};
+  champsim::operable_scheduler uut{system.view()};
+
+  REQUIRE(uut.num_domains() == 2);
+  REQUIRE(std::size(uut.operables()) == 24);
+}
+
+TEST_CASE("The operable scheduler operates components in the same order as sorting them every cycle")
+{
+  auto count = GENERATE(as<std::size_t>{}, 5, 16, 17, 40);
+  constexpr int num_cycles = 1000;
+
+  mixed_system reference{count};
+  mixed_system scheduled{count};
+  champsim::operable_scheduler uut{scheduled.view()};
+
+  champsim::chrono::clock reference_clock{};
+  champsim::chrono::clock scheduled_clock{};
+  for (int i = 0; i < num_cycles; ++i) {
+    reference_clock.tick(champsim::chrono::picoseconds{250});
+    scheduled_clock.tick(champsim::chrono::picoseconds{250});
+    auto reference_progress = sort_and_operate(reference.view(), reference_clock);
+    auto scheduled_progress = uut.operate_on(scheduled_clock);
+    REQUIRE(scheduled_progress == reference_progress);
+  }
+
+  REQUIRE(scheduled.log == reference.log);
+}
+
+TEST_CASE("Operable scheduler benchmarks")
+{
+  constexpr std::size_t count = 40;
+
+  BENCHMARK_ADVANCED("Sorting the operables every cycle")(Catch::Benchmark::Chronometer meter)
+  {
+    mixed_system system{count};
+    auto view = system.view();
+    system.log.reserve(count * static_cast<std::size_t>(meter.runs()));
+    champsim::chrono::clock clock{};
+    meter.measure([&] {
+      clock.tick(champsim::chrono::picoseconds{250});
+      return sort_and_operate(view, clock);
+    });
+  };
+
+  BENCHMARK_ADVANCED("Scheduling the operables every cycle")(Catch::Benchmark::Chronometer meter)
+  {
+    mixed_system system{count};
+    champsim::operable_scheduler uut{system.view()};
+    system.log.reserve(count * static_cast<std::size_t>(meter.runs()));
+    champsim::chrono::clock clock{};
+    meter.measure([&] {
+      clock.tick(champsim::chrono::picoseconds{250});
+      return uut.operate_on(clock);
+    });
+  };
+}
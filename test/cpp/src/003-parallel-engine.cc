@@ -0,0 +1,191 @@
+#include <catch.hpp>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "dram_controller.h"
+#include "environment.h"
+#include "instr.h"
+#include "mocks.hpp"
+#include "ooo_cpu.h"
+#include "parallel_engine.h"
+#include "phase_info.h"
+#include "tracereader.h"
+
+namespace champsim
+{
+phase_stats do_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock);
+}
+
+namespace
+{
+struct two_core_environment final : champsim::environment {
+  do_nothing_MRC mock_L1I_0, mock_L1I_1, mock_DTLB_0, mock_DTLB_1, mock_ll{50};
+  champsim::channel cpu0_to_L1D{}, cpu1_to_L1D{}, L1D0_to_LLC{}, L1D1_to_LLC{};
+
+  O3_CPU cpu0{champsim::core_builder{}.index(0).fetch_queues(&mock_L1I_0.queues).data_queues(&cpu0_to_L1D)};
+  O3_CPU cpu1{champsim::core_builder{}.index(1).fetch_queues(&mock_L1I_1.queues).data_queues(&cpu1_to_L1D)};
+  CACHE l1d0{champsim::cache_builder{champsim::defaults::default_l1d}
+                 .name("003-L1D-0")
+                 .sets(4)
+                 .ways(2)
+                 .upper_levels({&cpu0_to_L1D})
+                 .lower_level(&L1D0_to_LLC)
+                 .lower_translate(&mock_DTLB_0.queues)};
+  CACHE l1d1{champsim::cache_builder{champsim::defaults::default_l1d}
+                 .name("003-L1D-1")
+                 .sets(4)
+                 .ways(2)
+                 .upper_levels({&cpu1_to_L1D})
+                 .lower_level(&L1D1_to_LLC)
+                 .lower_translate(&mock_DTLB_1.queues)};
+  CACHE llc{champsim::cache_builder{champsim::defaults::default_llc}
+                .name("003-LLC")
+                .sets(16)
+                .ways(4)
+                .upper_levels({&L1D0_to_LLC, &L1D1_to_LLC})
+                .lower_level(&mock_ll.queues)};
+  MEMORY_CONTROLLER dram{champsim::chrono::picoseconds{3200},
+                         champsim::chrono::picoseconds{6400},
+                         std::size_t{18},
+                         std::size_t{18},
+                         std::size_t{18},
+                         std::size_t{38},
+                         champsim::chrono::microseconds{64000},
+                         {},
+                         64,
+                         64,
+                         1,
+                         champsim::data::bytes{8},
+                         1024,
+                         1024,
+                         4,
+                         4,
+                         4,
+                         8192};
+
+  std::vector<std::reference_wrapper<O3_CPU>> cpu_view() final { return {std::ref(cpu0), std::ref(cpu1)}; }
+  std::vector<std::reference_wrapper<CACHE>> cache_view() final { return {std::ref(l1d0), std::ref(l1d1), std::ref(llc)}; }
+  std::vector<std::reference_wrapper<PageTableWalker>> ptw_view() final { return {}; }
+  MEMORY_CONTROLLER& dram_view() final { return dram; }
+  std::vector<std::reference_wrapper<champsim::operable>> operable_view() final
+  {
+    return {cpu0, cpu1, mock_L1I_0, mock_L1I_1, l1d0, l1d1, llc, mock_DTLB_0, mock_DTLB_1, mock_ll};
+  }
+};
+
+/**
+ * A trace of loads that revisit a footprint larger than the private caches, but not the shared one.
+ */
+champsim::tracereader make_load_reader(uint64_t base)
+{
+  return champsim::tracereader{[ip = uint64_t{0x400000}, base, step = uint64_t{0}]() mutable {
+    ip += 4;
+    step = (step + 7) % 48;
+    return champsim::test::instruction_with_ip_and_source_memory(champsim::address{ip}, champsim::address{base + step * BLOCK_SIZE});
+  }};
+}
+
+std::vector<champsim::tracereader> make_traces()
+{
+  std::vector<champsim::tracereader> traces;
+  traces.push_back(make_load_reader(0x10000000));
+  traces.push_back(make_load_reader(0x20000000));
+  return traces;
+}
+
+std::vector<champsim::phase_stats> run(two_core_environment& env, std::size_t num_threads, long slack)
+{
+  for (champsim::operable& op : env.operable_view()) {
+    op.initialize();
+  }
+
+  auto traces = make_traces();
+  champsim::phase_info phase;
+  phase.name = "003-phase";
+  phase.is_warmup = false;
+  phase.length = 2000;
+  phase.trace_index = {0, 1};
+  phase.trace_names = {"003-trace-0", "003-trace-1"};
+  phase.num_threads = num_threads;
+  phase.parallel_slack = slack;
+
+  champsim::chrono::clock global_clock;
+  return {champsim::do_phase(phase, env, traces, global_clock)};
+}
+} // namespace
+
+TEST_CASE("The private hierarchy of each core is its own partition")
+{
+  two_core_environment env;
+  auto partitions = champsim::core_partitions(env);
+
+  // cpu0, cpu1, mock_L1I_0, mock_L1I_1, l1d0, l1d1, llc, mock_DTLB_0, mock_DTLB_1, mock_ll
+  constexpr auto shared = champsim::operable_scheduler::shared_partition;
+  CHECK(partitions == std::vector<std::size_t>{0, 1, shared, shared, 0, 1, shared, shared, shared, shared});
+}
+
+SCENARIO("The parallel engine reproduces the serial simulation")
+{
+  GIVEN("Two cores that share a last-level cache")
+  {
+    two_core_environment serial_env;
+    auto serial_stats = run(serial_env, 1, 1);
+
+    WHEN("The same simulation is run on two threads")
+    {
+      two_core_environment parallel_env;
+      auto parallel_stats = run(parallel_env, 2, 1);
+
+      THEN("Every statistic is identical")
+      {
+        REQUIRE(std::size(parallel_stats) == std::size(serial_stats));
+        for (std::size_t cpu = 0; cpu < 2; ++cpu) {
+          CHECK(parallel_stats.front().sim_cpu_stats.at(cpu).instrs() == serial_stats.front().sim_cpu_stats.at(cpu).instrs());
+          CHECK(parallel_stats.front().sim_cpu_stats.at(cpu).cycles() == serial_stats.front().sim_cpu_stats.at(cpu).cycles());
+        }
+        for (std::size_t cache = 0; cache < 3; ++cache) {
+          const auto& parallel_cache = parallel_stats.front().sim_cache_stats.at(cache);
+          const auto& serial_cache = serial_stats.front().sim_cache_stats.at(cache);
+          CHECK(parallel_cache.hits.total() == serial_cache.hits.total());
+          CHECK(parallel_cache.misses.total() == serial_cache.misses.total());
+          CHECK(parallel_cache.total_miss_latency_cycles == serial_cache.total_miss_latency_cycles);
+        }
+        CHECK(parallel_env.llc.current_time == serial_env.llc.current_time);
+      }
+    }
+
+    WHEN("The cores may run ahead of the shared cache")
+    {
+      two_core_environment parallel_env;
+      auto parallel_stats = run(parallel_env, 2, 8);
+
+      THEN("Both cores complete the phase")
+      {
+        REQUIRE(std::size(parallel_stats) == 1);
+        for (std::size_t cpu = 0; cpu < 2; ++cpu) {
+          CHECK(parallel_stats.front().sim_cpu_stats.at(cpu).instrs() >= 2000);
+        }
+        CHECK(parallel_stats.front().sim_cache_stats.at(2).misses.total() > 0);
+      }
+
+      AND_WHEN("The same simulation is run ahead again")
+      {
+        two_core_environment repeat_env;
+        auto repeat_stats = run(repeat_env, 2, 8);
+
+        THEN("Every statistic is identical")
+        {
+          REQUIRE(std::size(repeat_stats) == std::size(parallel_stats));
+          for (std::size_t cpu = 0; cpu < 2; ++cpu) {
+            CHECK(repeat_stats.front().sim_cpu_stats.at(cpu).instrs() == parallel_stats.front().sim_cpu_stats.at(cpu).instrs());
+            CHECK(repeat_stats.front().sim_cpu_stats.at(cpu).cycles() == parallel_stats.front().sim_cpu_stats.at(cpu).cycles());
+          }
+          for (std::size_t cache = 0; cache < 3; ++cache) {
+            CHECK(repeat_stats.front().sim_cache_stats.at(cache).hits.total() == parallel_stats.front().sim_cache_stats.at(cache).hits.total());
+            CHECK(repeat_stats.front().sim_cache_stats.at(cache).misses.total() == parallel_stats.front().sim_cache_stats.at(cache).misses.total());
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,152 @@
+#include <catch.hpp>
+#include <deque>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "instr.h"
+#include "instruction.h"
+#include "util/circular_buffer.h"
+
+namespace
+{
+/**
+ * Move a window of instructions from one pipeline buffer to the next and back, as the stages of a core do.
+ */
+template <typename Buffer>
+std::size_t move_through(Buffer& from, Buffer& to)
+{
+  while (!std::empty(from)) {
+    to.push_back(std::move(from.front()));
+    from.pop_front();
+  }
+  while (!std::empty(to)) {
+    from.push_back(std::move(to.front()));
+    to.pop_front();
+  }
+  return std::size(from);
+}
+
+template <typename Buffer>
+void fill_with_instructions(Buffer& buffer, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    buffer.push_back(champsim::test::instruction_with_ip_and_source_memory(champsim::address{0x400000 + 4 * i}, champsim::address{0x10000000 + 64 * i}));
+  }
+}
+} // namespace
+
+TEST_CASE("A circular buffer is a first-in, first-out queue")
+{
+  champsim::circular_buffer<int> uut{4};
+  REQUIRE(std::empty(uut));
+  REQUIRE(uut.capacity() == 4);
+
+  // Wrap around the end of the storage several times
+  int next_in = 0;
+  int next_out = 0;
+  uut.push_back(next_in++);
+  for (int round = 0; round < 10; ++round) {
+    uut.push_back(next_in++);
+    uut.push_back(next_in++);
+    REQUIRE(uut.front() == next_out);
+    REQUIRE(uut.back() == next_in - 1);
+    uut.pop_front();
+    uut.pop_front();
+    next_out += 2;
+  }
+
+  std::vector<int> contents{std::begin(uut), std::end(uut)};
+  std::vector<int> expected(static_cast<std::size_t>(next_in - next_out));
+  std::iota(std::begin(expected), std::end(expected), next_out);
+  REQUIRE(contents == expected);
+  REQUIRE(uut.capacity() == 4);
+}
+
+TEST_CASE("A circular buffer rounds its capacity up to a power of two")
+{
+  champsim::circular_buffer<int> uut{5};
+  REQUIRE(uut.capacity() == 8);
+}
+
+TEST_CASE("A circular buffer grows when it is filled past its capacity")
+{
+  champsim::circular_buffer<int> uut{2};
+  uut.push_back(0);
+  uut.pop_front();
+  for (int i = 0; i < 5; ++i) {
+    uut.push_back(i);
+  }
+
+  REQUIRE(uut.capacity() >= 5);
+  REQUIRE(std::vector<int>(std::begin(uut), std::end(uut)) == std::vector<int>{0, 1, 2, 3, 4});
+}
+
+TEST_CASE("A circular buffer erases from the front and the middle")
+{
+  champsim::circular_buffer<int> uut{8};
+  for (int i = 0; i < 6; ++i) {
+    uut.push_back(i);
+  }
+
+  SECTION("From the front")
+  {
+    auto it = uut.erase(std::cbegin(uut), std::next(std::cbegin(uut), 2));
+    REQUIRE(it == std::begin(uut));
+    REQUIRE(std::vector<int>(std::begin(uut), std::end(uut)) == std::vector<int>{2, 3, 4, 5});
+  }
+
+  SECTION("From the middle")
+  {
+    auto it = uut.erase(std::next(std::cbegin(uut), 1), std::next(std::cbegin(uut), 3));
+    REQUIRE(*it == 3);
+    REQUIRE(std::vector<int>(std::begin(uut), std::end(uut)) == std::vector<int>{0, 3, 4, 5});
+  }
+}
+
+TEST_CASE("A circular buffer inserts a range")
+{
+  champsim::circular_buffer<int> uut{8};
+  uut.push_back(0);
+  uut.push_back(3);
+  std::vector<int> middle{1, 2};
+  uut.insert(std::next(std::cbegin(uut)), std::begin(middle), std::end(middle));
+  REQUIRE(std::vector<int>(std::begin(uut), std::end(uut)) == std::vector<int>{0, 1, 2, 3});
+}
+
+TEST_CASE("A circular buffer constructs and destroys its elements in place")
+{
+  auto counter = std::make_shared<int>(0);
+  {
+    champsim::circular_buffer<std::shared_ptr<int>> uut{4};
+    uut.emplace_back(counter);
+    uut.push_back(counter);
+    REQUIRE(counter.use_count() == 3);
+
+    uut.pop_front();
+    REQUIRE(counter.use_count() == 2);
+
+    auto moved = std::move(uut);
+    REQUIRE(counter.use_count() == 2);
+  }
+  REQUIRE(counter.use_count() == 1);
+}
+
+TEST_CASE("Pipeline buffer benchmarks")
+{
+  constexpr std::size_t count = 256;
+
+  BENCHMARK_ADVANCED("Moving instructions between std::deque buffers")(Catch::Benchmark::Chronometer meter)
+  {
+    std::deque<ooo_model_instr> first, second;
+    fill_with_instructions(first, count);
+    meter.measure([&] { return move_through(first, second); });
+  };
+
+  BENCHMARK_ADVANCED("Moving instructions between circular buffers")(Catch::Benchmark::Chronometer meter)
+  {
+    champsim::circular_buffer<ooo_model_instr> first{count}, second{count};
+    fill_with_instructions(first, count);
+    meter.measure([&] { return move_through(first, second); });
+  };
+}
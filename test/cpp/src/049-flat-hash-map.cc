@@ -0,0 +1,75 @@
+#include <catch.hpp>
+#include <sstream>
+#include <vector>
+
+#include "serialization.h"
+#include "util/flat_hash_map.h"
+
+TEST_CASE("A flat hash map finds each key that was inserted")
+{
+  champsim::flat_hash_map<uint64_t, uint64_t> uut;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    auto [it, inserted] = uut.try_emplace(i << 32, i);
+    REQUIRE(inserted);
+    REQUIRE(it->second == i);
+  }
+
+  REQUIRE(std::size(uut) == 1000);
+  for (uint64_t i = 0; i < 1000; ++i) {
+    auto found = uut.find(i << 32);
+    REQUIRE(found != std::end(uut));
+    REQUIRE(found->second == i);
+  }
+  REQUIRE(uut.find(1) == std::end(uut));
+}
+
+TEST_CASE("A flat hash map does not replace a key that is already present")
+{
+  champsim::flat_hash_map<uint64_t, uint64_t> uut;
+  uut.try_emplace(5, 10);
+  auto [it, inserted] = uut.try_emplace(5, 20);
+
+  REQUIRE_FALSE(inserted);
+  REQUIRE(it->second == 10);
+  REQUIRE(std::size(uut) == 1);
+}
+
+TEST_CASE("A flat hash map visits its entries in the order they were inserted")
+{
+  champsim::flat_hash_map<uint64_t, uint64_t> uut;
+  std::vector<uint64_t> keys{42, 7, 1000000, 3, 99};
+  for (auto key : keys) {
+    uut.try_emplace(key, key + 1);
+  }
+
+  std::vector<uint64_t> visited{};
+  for (const auto& [key, value] : uut) {
+    visited.push_back(key);
+  }
+  REQUIRE(visited == keys);
+}
+
+TEST_CASE("A flat hash map is restored from a checkpoint")
+{
+  champsim::flat_hash_map<uint64_t, uint64_t> original;
+  for (uint64_t i = 0; i < 100; ++i) {
+    original.try_emplace(i * 17, i);
+  }
+
+  std::stringstream stream;
+  champsim::serialization::output_archive out{stream};
+  out(original);
+
+  champsim::flat_hash_map<uint64_t, uint64_t> restored;
+  restored.try_emplace(1, 1);
+  champsim::serialization::input_archive in{stream};
+  in(restored);
+
+  REQUIRE(std::size(restored) == 100);
+  REQUIRE(restored.find(1) == std::end(restored));
+  for (uint64_t i = 0; i < 100; ++i) {
+    auto found = restored.find(i * 17);
+    REQUIRE(found != std::end(restored));
+    REQUIRE(found->second == i);
+  }
+}
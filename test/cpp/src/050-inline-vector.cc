@@ -0,0 +1,39 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <stdexcept>
+
+#include "util/inline_vector.h"
+
+TEST_CASE("An inline vector holds the elements pushed into it, in order")
+{
+  champsim::inline_vector<int, 4> uut;
+  uut.push_back(1);
+  uut.push_back(2);
+  uut.push_back(3);
+
+  REQUIRE(std::size(uut) == 3);
+  REQUIRE(uut == champsim::inline_vector<int, 4>{1, 2, 3});
+  REQUIRE(uut.front() == 1);
+  REQUIRE(uut.back() == 3);
+}
+
+TEST_CASE("An inline vector removes elements with the erase-remove idiom")
+{
+  champsim::inline_vector<int, 4> uut{6, 1, 6, 2};
+  uut.erase(std::remove(std::begin(uut), std::end(uut), 6), std::end(uut));
+
+  REQUIRE(uut == champsim::inline_vector<int, 4>{1, 2});
+}
+
+TEST_CASE("An inline vector cannot be pushed past its capacity")
+{
+  champsim::inline_vector<int, 2> uut{1, 2};
+
+  REQUIRE_THROWS_AS(uut.push_back(3), std::length_error);
+  REQUIRE(std::size(uut) == 2);
+}
+
+TEST_CASE("An inline vector of a trivially copyable type is trivially copyable")
+{
+  STATIC_REQUIRE(std::is_trivially_copyable_v<champsim::inline_vector<int, 4>>);
+}
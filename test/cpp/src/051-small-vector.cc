@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cstdint>
+#include <utility>
+
+#include "util/small_vector.h"
+
+TEST_CASE("A small vector holds the elements pushed into it, in order")
+{
+  champsim::small_vector<uint64_t, 2> uut;
+  for (uint64_t i = 0; i < 5; ++i) {
+    uut.push_back(i);
+  }
+
+  REQUIRE(std::size(uut) == 5);
+  REQUIRE(uut == champsim::small_vector<uint64_t, 2>{0, 1, 2, 3, 4});
+}
+
+TEST_CASE("A small vector is copied and moved whether or not it has grown")
+{
+  auto count = GENERATE(as<uint64_t>{}, 1, 2, 3, 10);
+  champsim::small_vector<uint64_t, 2> original;
+  for (uint64_t i = 0; i < count; ++i) {
+    original.push_back(i);
+  }
+
+  champsim::small_vector<uint64_t, 2> copied{original};
+  REQUIRE(copied == original);
+
+  champsim::small_vector<uint64_t, 2> assigned{7, 8, 9, 10};
+  assigned = original;
+  REQUIRE(assigned == original);
+
+  champsim::small_vector<uint64_t, 2> moved{std::move(copied)};
+  REQUIRE(moved == original);
+  REQUIRE(std::empty(copied)); // NOLINT(bugprone-use-after-move,clang-analyzer-cplusplus.Move)
+
+  champsim::small_vector<uint64_t, 2> move_assigned{7, 8, 9, 10};
+  move_assigned = std::move(moved);
+  REQUIRE(move_assigned == original);
+}
+
+TEST_CASE("A small vector removes elements from its front")
+{
+  champsim::small_vector<uint64_t, 2> uut{1, 2, 3};
+  uut.erase(std::begin(uut));
+
+  REQUIRE(uut == champsim::small_vector<uint64_t, 2>{2, 3});
+}
+
+TEST_CASE("A small vector is the output of a set union")
+{
+  champsim::small_vector<uint64_t, 4> lhs{1, 3, 5};
+  champsim::small_vector<uint64_t, 4> rhs{2, 3, 4};
+  champsim::small_vector<uint64_t, 4> uut;
+  std::set_union(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs), std::back_inserter(uut));
+
+  REQUIRE(uut == champsim::small_vector<uint64_t, 4>{1, 2, 3, 4, 5});
+}
@@ -1,4 +1,8 @@
 #include <catch.hpp>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "event_counter.h"
 
@@ -69,3 +73,42 @@ TEST_CASE("Two event counters can be subtracted")
   rhs.set(key, rhs_value);
   REQUIRE((lhs - rhs).at(key) == lhs_value - rhs_value);
 }
+
+TEMPLATE_TEST_CASE_SIG("An event counter by access type and cpu counts each key separately", "", ((uint32_t CPU), CPU), 0, 3, 300,
+                       std::numeric_limits<uint32_t>::max())
+{
+  champsim::stats::event_counter<std::pair<access_type, uint32_t>> uut{};
+  uut.increment(std::pair{access_type::LOAD, CPU});
+  uut.increment(std::pair{access_type::LOAD, CPU});
+  uut.increment(std::pair{access_type::PREFETCH, CPU});
+
+  REQUIRE(uut.at(std::pair{access_type::LOAD, CPU}) == 2);
+  REQUIRE(uut.at(std::pair{access_type::PREFETCH, CPU}) == 1);
+  REQUIRE(uut.value_or(std::pair{access_type::RFO, CPU}, 3) == 3);
+  REQUIRE(uut.total() == 3);
+  REQUIRE(uut.get_keys() == std::vector{std::pair{access_type::LOAD, CPU}, std::pair{access_type::PREFETCH, CPU}});
+}
+
+TEST_CASE("An event counter by access type and cpu has no count for a key it never saw")
+{
+  champsim::stats::event_counter<std::pair<access_type, uint32_t>> uut{};
+  uut.increment(std::pair{access_type::LOAD, uint32_t{0}});
+
+  REQUIRE_THROWS_AS(uut.at(std::pair{access_type::RFO, uint32_t{0}}), std::out_of_range);
+  REQUIRE_THROWS_AS(uut.at(std::pair{access_type::LOAD, uint32_t{3}}), std::out_of_range);
+}
+
+TEST_CASE("Two event counters by access type and cpu can be subtracted")
+{
+  champsim::stats::event_counter<std::pair<access_type, uint32_t>> lhs{};
+  champsim::stats::event_counter<std::pair<access_type, uint32_t>> rhs{};
+  const std::pair key{access_type::WRITE, uint32_t{1}};
+  const std::pair other_key{access_type::LOAD, uint32_t{0}};
+  lhs.set(key, 100);
+  lhs.set(other_key, 10);
+  rhs.set(key, 20);
+
+  auto difference = lhs - rhs;
+  REQUIRE(difference.at(key) == 80);
+  REQUIRE(difference.at(other_key) == 10);
+}
@@ -0,0 +1,145 @@
+#include <catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+#include "tracereader.h"
+#include "xz_stream.h"
+
+namespace
+{
+std::vector<input_instr> make_skip_trace(std::size_t length)
+{
+  std::vector<input_instr> instrs(length);
+  for (std::size_t i = 0; i < length; ++i) {
+    instrs.at(i).ip = 0x400000 + 4 * i;
+  }
+  return instrs;
+}
+
+std::string as_bytes(const std::vector<input_instr>& instrs)
+{
+  std::string bytes(std::size(instrs) * sizeof(input_instr), '\0');
+  std::memcpy(std::data(bytes), std::data(instrs), std::size(bytes));
+  return bytes;
+}
+
+// Compress with a full flush every block_instrs records, so that the file holds many blocks
+void write_multiblock_xz(const std::filesystem::path& path, const std::vector<input_instr>& instrs, std::size_t block_instrs)
+{
+  auto strm = champsim::decomp_tags::lzma_tag_t<>::new_deflate_state();
+  std::ofstream out{path, std::ios::binary};
+  std::array<uint8_t, 1 << 16> out_buf;
+
+  auto drain = [&](lzma_action action) {
+    lzma_ret ret;
+    do {
+      strm->next_out = std::data(out_buf);
+      strm->avail_out = std::size(out_buf);
+      ret = ::lzma_code(strm.get(), action);
+      out.write(reinterpret_cast<const char*>(std::data(out_buf)), static_cast<std::streamsize>(std::size(out_buf) - strm->avail_out));
+    } while (strm->avail_in > 0 || (action != LZMA_RUN && ret == LZMA_OK));
+  };
+
+  for (std::size_t begin = 0; begin < std::size(instrs); begin += block_instrs) {
+    auto count = std::min(block_instrs, std::size(instrs) - begin);
+    strm->next_in = reinterpret_cast<const uint8_t*>(std::data(instrs) + begin);
+    strm->avail_in = count * sizeof(input_instr);
+    drain(LZMA_RUN);
+    drain(LZMA_FULL_FLUSH);
+  }
+  drain(LZMA_FINISH);
+}
+} // namespace
+
+TEST_CASE("A bulk tracereader can skip instructions")
+{
+  auto instrs = make_skip_trace(1000);
+  champsim::bulk_tracereader<input_instr, std::istringstream> uut{0, std::istringstream{as_bytes(instrs)}};
+
+  SECTION("Skipping from the start")
+  {
+    REQUIRE(uut.skip(300) == 300);
+    REQUIRE(uut().ip == champsim::address{instrs.at(300).ip});
+  }
+
+  SECTION("Skipping after reading, within the buffered instructions")
+  {
+    static_cast<void>(uut());
+    REQUIRE(uut.skip(10) == 10);
+    REQUIRE(uut().ip == champsim::address{instrs.at(11).ip});
+  }
+
+  SECTION("Skipping after reading, past the buffered instructions")
+  {
+    static_cast<void>(uut());
+    REQUIRE(uut.skip(500) == 500);
+    REQUIRE(uut().ip == champsim::address{instrs.at(501).ip});
+  }
+
+  SECTION("Skipping past the end of the trace")
+  {
+    REQUIRE(uut.skip(2000) == 1000);
+    REQUIRE(uut.eof());
+  }
+}
+
+TEST_CASE("A tracereader skip advances the instruction ids")
+{
+  auto instrs = make_skip_trace(1000);
+  champsim::tracereader uut{champsim::bulk_tracereader<input_instr, std::istringstream>{0, std::istringstream{as_bytes(instrs)}}};
+  auto first = uut();
+  REQUIRE(uut.skip(10) == 10);
+  auto second = uut();
+  REQUIRE(second.instr_id - first.instr_id == 11);
+  REQUIRE(second.ip == champsim::address{instrs.at(11).ip});
+}
+
+TEST_CASE("A tracereader can skip a type without a skip() member function")
+{
+  long calls = 0;
+  champsim::tracereader uut{[&calls]() {
+    ++calls;
+    return ooo_model_instr{0, input_instr{}};
+  }};
+  REQUIRE(uut.skip(5) == 5);
+  REQUIRE(calls == 5);
+}
+
+TEST_CASE("A multi-block xz trace can be skipped by block")
+{
+  auto instrs = make_skip_trace(1000);
+  const auto path = std::filesystem::temp_directory_path() / "086-tracereader-skip.xz";
+  write_multiblock_xz(path, instrs, 100);
+
+  SECTION("The index holds one restart point per block")
+  {
+    auto index = champsim::read_xz_index(path.string());
+    REQUIRE(index.has_value());
+    REQUIRE(std::size(index.value()) == 10);
+    REQUIRE(index->at(3).uncompressed_offset == 300 * sizeof(input_instr));
+  }
+
+  SECTION("Skipping lands on the right instruction")
+  {
+    auto skip_count = GENERATE(as<uint64_t>{}, 1, 99, 100, 450, 999);
+    champsim::bulk_tracereader<input_instr, champsim::seekable_xz_istream> uut{0, path.string()};
+    REQUIRE(uut.skip(skip_count) == skip_count);
+    REQUIRE(uut().ip == champsim::address{instrs.at(skip_count).ip});
+  }
+
+  SECTION("Reading continues across blocks after a skip")
+  {
+    champsim::bulk_tracereader<input_instr, champsim::seekable_xz_istream> uut{0, path.string()};
+    REQUIRE(uut.skip(250) == 250);
+    std::vector<uint64_t> ips;
+    for (int i = 0; i < 700; ++i) {
+      ips.push_back(uut().ip.to<uint64_t>());
+    }
+    std::vector<uint64_t> expected;
+    std::transform(std::next(std::begin(instrs), 250), std::next(std::begin(instrs), 950), std::back_inserter(expected), [](auto x) { return x.ip; });
+    REQUIRE(ips == expected);
+  }
+
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,95 @@
+#include <catch.hpp>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include "background_reader.h"
+#include "tracereader.h"
+
+namespace
+{
+using bulk_reader_type = champsim::bulk_tracereader<input_instr, std::istringstream>;
+
+// Every third instruction is a taken branch, so that branch targets cross the batch boundaries
+std::string make_branchy_trace(std::size_t length)
+{
+  std::vector<input_instr> instrs(length);
+  for (std::size_t i = 0; i < length; ++i) {
+    instrs.at(i).ip = 0x400000 + 0x40 * i;
+    instrs.at(i).is_branch = (i % 3 == 0);
+    instrs.at(i).branch_taken = (i % 3 == 0);
+  }
+
+  std::string bytes(std::size(instrs) * sizeof(input_instr), '\0');
+  std::memcpy(std::data(bytes), std::data(instrs), std::size(bytes));
+  return bytes;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> read_all(champsim::tracereader& reader)
+{
+  std::vector<std::pair<uint64_t, uint64_t>> retval;
+  while (!reader.eof()) {
+    auto instr = reader();
+    retval.emplace_back(instr.ip.to<uint64_t>(), instr.branch_target.to<uint64_t>());
+  }
+  return retval;
+}
+} // namespace
+
+TEST_CASE("A background reader produces the same instructions as the reader it wraps")
+{
+  const auto bytes = make_branchy_trace(1000);
+  auto depth = GENERATE(as<std::size_t>{}, 1, 2, 16);
+  auto batch_size = GENERATE(as<std::size_t>{}, 1, 7, 1024);
+
+  champsim::tracereader direct{bulk_reader_type{0, std::istringstream{bytes}}};
+  champsim::tracereader uut{champsim::background_reader<bulk_reader_type>{bulk_reader_type{0, std::istringstream{bytes}}, depth, batch_size}};
+
+  auto expected = read_all(direct);
+  REQUIRE(read_all(uut) == expected);
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("A background reader leaves the instruction ids to the tracereader")
+{
+  const auto bytes = make_branchy_trace(100);
+  champsim::tracereader uut{champsim::background_reader<bulk_reader_type>{bulk_reader_type{0, std::istringstream{bytes}}, 2, 8}};
+
+  auto first = uut();
+  auto second = uut();
+  REQUIRE(second.instr_id == first.instr_id + 1);
+}
+
+TEST_CASE("A background reader can skip instructions")
+{
+  const auto bytes = make_branchy_trace(1000);
+  champsim::background_reader<bulk_reader_type> uut{bulk_reader_type{0, std::istringstream{bytes}}, 2, 8};
+
+  SECTION("Skipping before the thread has started")
+  {
+    REQUIRE(uut.skip(300) == 300);
+    REQUIRE(uut().ip == champsim::address{0x400000 + 0x40 * 300});
+  }
+
+  SECTION("Skipping within the instructions that were read ahead")
+  {
+    static_cast<void>(uut());
+    REQUIRE(uut.skip(3) == 3);
+    REQUIRE(uut().ip == champsim::address{0x400000 + 0x40 * 4});
+  }
+
+  SECTION("Skipping past the instructions that were read ahead")
+  {
+    static_cast<void>(uut());
+    REQUIRE(uut.skip(500) == 500);
+    REQUIRE(uut().ip == champsim::address{0x400000 + 0x40 * 501});
+    REQUIRE(uut().ip == champsim::address{0x400000 + 0x40 * 502});
+  }
+
+  SECTION("Skipping past the end of the trace")
+  {
+    static_cast<void>(uut());
+    REQUIRE(uut.skip(2000) == 999);
+    REQUIRE(uut.eof());
+  }
+}
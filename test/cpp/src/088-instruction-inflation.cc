@@ -0,0 +1,56 @@
+#include <catch.hpp>
+#include <vector>
+
+#include "instruction.h"
+
+TEST_CASE("Instruction inflation benchmarks")
+{
+  constexpr std::size_t count = 4096;
+
+  // Instructions with a mix of register and memory operands, as a trace would hold
+  std::vector<input_instr> trace(count);
+  uint64_t state = 1;
+  for (std::size_t i = 0; i < count; ++i) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    auto& instr = trace[i];
+    instr = input_instr{};
+    instr.ip = 0x400000 + 4 * i;
+    instr.destination_registers[0] = static_cast<unsigned char>(1 + (state >> 58));
+    instr.source_registers[0] = static_cast<unsigned char>(1 + ((state >> 52) & 0x3f));
+    instr.source_registers[1] = static_cast<unsigned char>(1 + ((state >> 46) & 0x3f));
+    if ((state >> 40) % 3 == 0) {
+      instr.source_memory[0] = 0x10000000 + ((state >> 8) & 0xffffc0);
+    }
+    if ((state >> 40) % 5 == 0) {
+      instr.destination_memory[0] = 0x20000000 + ((state >> 16) & 0xffffc0);
+    }
+  }
+
+  BENCHMARK_ADVANCED("Inflating 4096 instructions")(Catch::Benchmark::Chronometer meter)
+  {
+    std::vector<ooo_model_instr> inflated{};
+    inflated.reserve(count);
+    meter.measure([&] {
+      inflated.clear();
+      for (const auto& instr : trace) {
+        inflated.emplace_back(0, instr);
+      }
+      return std::size(inflated);
+    });
+  };
+
+  BENCHMARK_ADVANCED("Moving 4096 instructions between buffers")(Catch::Benchmark::Chronometer meter)
+  {
+    std::vector<ooo_model_instr> from{};
+    std::vector<ooo_model_instr> to{};
+    for (const auto& instr : trace) {
+      from.emplace_back(0, instr);
+    }
+    to.reserve(count);
+    meter.measure([&] {
+      to.clear();
+      std::copy(std::begin(from), std::end(from), std::back_inserter(to));
+      return std::size(to);
+    });
+  };
+}
@@ -0,0 +1,141 @@
+#include <array>
+#include <catch.hpp>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "shared_trace.h"
+#include "tracereader.h"
+
+namespace
+{
+using bulk_reader_type = champsim::bulk_tracereader<input_instr, std::istringstream>;
+
+// Every third instruction is a taken branch, so that branch targets cross the batch boundaries
+std::string make_branchy_trace(std::size_t length)
+{
+  std::vector<input_instr> instrs(length);
+  for (std::size_t i = 0; i < length; ++i) {
+    instrs.at(i).ip = 0x400000 + 0x40 * i;
+    instrs.at(i).is_branch = (i % 3 == 0);
+    instrs.at(i).branch_taken = (i % 3 == 0);
+  }
+
+  std::string bytes(std::size(instrs) * sizeof(input_instr), '\0');
+  std::memcpy(std::data(bytes), std::data(instrs), std::size(bytes));
+  return bytes;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> read_all(champsim::tracereader& reader, int pause_every = 0)
+{
+  std::vector<std::pair<uint64_t, uint64_t>> retval;
+  while (!reader.eof()) {
+    auto instr = reader();
+    retval.emplace_back(instr.ip.to<uint64_t>(), instr.branch_target.to<uint64_t>());
+    if (pause_every > 0 && std::size(retval) % static_cast<std::size_t>(pause_every) == 0) {
+      std::this_thread::yield();
+    }
+  }
+  return retval;
+}
+} // namespace
+
+TEST_CASE("Every consumer of a shared trace reads the whole trace, each at its own pace")
+{
+  const auto bytes = make_branchy_trace(5000);
+  auto depth = GENERATE(as<std::size_t>{}, 1, 2, 16);
+  auto batch_size = GENERATE(as<std::size_t>{}, 1, 7, 1024);
+
+  champsim::tracereader direct{bulk_reader_type{0, std::istringstream{bytes}}};
+  const auto expected = read_all(direct);
+
+  constexpr std::size_t consumers = 3;
+  champsim::shared_trace uut{champsim::tracereader{bulk_reader_type{0, std::istringstream{bytes}}}, consumers, depth, batch_size};
+
+  std::vector<std::vector<std::pair<uint64_t, uint64_t>>> results(consumers);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < consumers; ++i) {
+    threads.emplace_back([&results, reader = uut.reader(i), i]() mutable { results.at(i) = read_all(reader, static_cast<int>(i * 10)); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& result : results) {
+    REQUIRE(result == expected);
+  }
+}
+
+TEST_CASE("The readers of a shared trace draw instruction IDs from their own counters")
+{
+  const auto bytes = make_branchy_trace(100);
+  champsim::shared_trace uut{champsim::tracereader{bulk_reader_type{0, std::istringstream{bytes}}}, 2, 2, 8};
+
+  uint64_t first_ids = 0;
+  uint64_t second_ids = 0;
+  auto first = uut.reader(0);
+  first.use_instr_ids(first_ids);
+  auto second = uut.reader(1);
+  second.use_instr_ids(second_ids);
+
+  REQUIRE(first().instr_id == 0);
+  REQUIRE(first().instr_id == 1);
+  REQUIRE(second().instr_id == 0);
+  REQUIRE(first_ids == 2);
+  REQUIRE(second_ids == 1);
+}
+
+TEST_CASE("A consumer that leaves a shared trace does not hold back the others")
+{
+  const auto bytes = make_branchy_trace(1000);
+  champsim::tracereader direct{bulk_reader_type{0, std::istringstream{bytes}}};
+  const auto expected = read_all(direct);
+
+  champsim::shared_trace uut{champsim::tracereader{bulk_reader_type{0, std::istringstream{bytes}}}, 2, 1, 16};
+
+  auto stays = uut.reader(0);
+  {
+    auto leaves = uut.reader(1);
+    static_cast<void>(leaves());
+  }
+
+  REQUIRE(read_all(stays) == expected);
+}
+
+TEST_CASE("Consumers that read several shared traces in opposite orders do not wait on each other")
+{
+  const auto bytes = make_branchy_trace(2000);
+  champsim::tracereader direct{bulk_reader_type{0, std::istringstream{bytes}}};
+  const auto expected = read_all(direct);
+
+  // Each trace may run only one small batch ahead of its slowest consumer
+  champsim::shared_trace first{champsim::tracereader{bulk_reader_type{0, std::istringstream{bytes}}}, 2, 1, 16};
+  champsim::shared_trace second{champsim::tracereader{bulk_reader_type{1, std::istringstream{bytes}}}, 2, 1, 16};
+
+  std::array<std::vector<std::pair<uint64_t, uint64_t>>, 4> results;
+  std::thread forward{[&results, a = first.reader(0), b = second.reader(0)]() mutable {
+    results.at(0) = read_all(a);
+    results.at(1) = read_all(b);
+  }};
+  std::thread backward{[&results, a = first.reader(1), b = second.reader(1)]() mutable {
+    results.at(3) = read_all(b);
+    results.at(2) = read_all(a);
+  }};
+  forward.join();
+  backward.join();
+
+  for (const auto& result : results) {
+    REQUIRE(result == expected);
+  }
+}
+
+TEST_CASE("Each consumer of a shared trace takes one reader")
+{
+  const auto bytes = make_branchy_trace(10);
+  champsim::shared_trace uut{champsim::tracereader{bulk_reader_type{0, std::istringstream{bytes}}}, 1, 1};
+
+  auto reader = uut.reader(0);
+  REQUIRE_THROWS_AS(uut.reader(0), std::invalid_argument);
+  REQUIRE_THROWS_AS(uut.reader(1), std::invalid_argument);
+}
@@ -0,0 +1,248 @@
+#include <catch.hpp>
+#include <filesystem>
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "dram_controller.h"
+#include "environment.h"
+#include "instr.h"
+#include "mocks.hpp"
+#include "ooo_cpu.h"
+#include "sim_server.h"
+
+namespace
+{
+struct server_test_environment final : champsim::environment {
+  do_nothing_MRC mock_L1I, mock_L1D, mock_ll;
+  O3_CPU cpu{champsim::core_builder{}.fetch_queues(&mock_L1I.queues).data_queues(&mock_L1D.queues)};
+  CACHE cache{champsim::cache_builder{champsim::defaults::default_l2c}.name("095-uut").sets(4).ways(2).upper_levels({}).lower_level(&mock_ll.queues)};
+  MEMORY_CONTROLLER dram{champsim::chrono::picoseconds{3200},
+                         champsim::chrono::picoseconds{6400},
+                         std::size_t{18},
+                         std::size_t{18},
+                         std::size_t{18},
+                         std::size_t{38},
+                         champsim::chrono::microseconds{64000},
+                         {},
+                         64,
+                         64,
+                         1,
+                         champsim::data::bytes{8},
+                         1024,
+                         1024,
+                         4,
+                         4,
+                         4,
+                         8192};
+
+  std::vector<std::reference_wrapper<O3_CPU>> cpu_view() final { return {std::ref(cpu)}; }
+  std::vector<std::reference_wrapper<CACHE>> cache_view() final { return {std::ref(cache)}; }
+  std::vector<std::reference_wrapper<PageTableWalker>> ptw_view() final { return {}; }
+  MEMORY_CONTROLLER& dram_view() final { return dram; }
+  std::vector<std::reference_wrapper<champsim::operable>> operable_view() final { return {cpu, mock_L1I, mock_L1D, cache, mock_ll}; }
+};
+
+champsim::tracereader make_counting_reader()
+{
+  return champsim::tracereader{[ip = uint64_t{0x400000}]() mutable {
+    ip += 4;
+    return champsim::test::instruction_with_ip(ip);
+  }};
+}
+
+std::vector<champsim::tracereader> make_counting_trace()
+{
+  std::vector<champsim::tracereader> traces;
+  traces.push_back(make_counting_reader());
+  return traces;
+}
+/**
+ * Send commands to a server on a Unix socket, one per line, and collect one response per command.
+ */
+std::vector<nlohmann::json> converse(const std::string& socket_path, const std::vector<std::string>& commands)
+{
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::copy(std::begin(socket_path), std::end(socket_path), std::begin(address.sun_path));
+
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  for (int attempt = 0; ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 && attempt < 500; ++attempt) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  }
+
+  std::vector<nlohmann::json> responses;
+  std::string pending;
+  for (const auto& command : commands) {
+    auto line = command + "\n";
+    static_cast<void>(::write(fd, std::data(line), std::size(line)));
+    while (pending.find('\n') == std::string::npos) {
+      std::array<char, 4096> buffer;
+      auto received = ::read(fd, std::data(buffer), std::size(buffer));
+      if (received <= 0) {
+        ::close(fd);
+        return responses;
+      }
+      pending.append(std::data(buffer), static_cast<std::size_t>(received));
+    }
+    responses.push_back(nlohmann::json::parse(pending.substr(0, pending.find('\n'))));
+    pending.erase(0, pending.find('\n') + 1);
+  }
+  ::close(fd);
+  return responses;
+}
+} // namespace
+
+SCENARIO("A simulation server can branch into a child process")
+{
+  GIVEN("A server that can reopen its trace")
+  {
+    server_test_environment env;
+    auto traces = make_counting_trace();
+    champsim::simulation_server uut{env, traces, {"095-trace"}, [](std::size_t) { return make_counting_reader(); }};
+    REQUIRE(nlohmann::json::parse(uut.execute("run 200")).at("status") == "ok");
+
+    WHEN("The simulation is branched")
+    {
+      const auto socket_path = (std::filesystem::temp_directory_path() / fmt::format("095-branch-{}.sock", ::getpid())).string();
+      auto branch_response = nlohmann::json::parse(uut.execute(fmt::format("branch {}", socket_path)));
+      REQUIRE(branch_response.at("status") == "ok");
+
+      auto child_responses = converse(socket_path, {"run 100", "quit"});
+      int child_status = -1;
+      ::waitpid(branch_response.at("pid").get<int>(), &child_status, 0);
+
+      auto parent_response = nlohmann::json::parse(uut.execute("run 100"));
+
+      THEN("The child runs from the same state, and the parent is unaffected")
+      {
+        REQUIRE(std::size(child_responses) == 2);
+        CHECK(child_responses.at(0).at("status") == "ok");
+        CHECK(child_responses.at(1).at("status") == "ok");
+        CHECK(WIFEXITED(child_status));
+        CHECK(WEXITSTATUS(child_status) == 0);
+
+        REQUIRE(parent_response.at("status") == "ok");
+        CHECK(child_responses.at(0).at("stats").at("sim").at("cores").at(0).at("instructions")
+              == parent_response.at("stats").at("sim").at("cores").at(0).at("instructions"));
+        CHECK(child_responses.at(0).at("stats").at("sim").at("cores").at(0).at("cycles")
+              == parent_response.at("stats").at("sim").at("cores").at(0).at("cycles"));
+      }
+    }
+  }
+}
+
+SCENARIO("A simulation server runs consecutive windows on the same state")
+{
+  GIVEN("A server over a small environment")
+  {
+    server_test_environment env;
+    auto traces = make_counting_trace();
+    champsim::simulation_server uut{env, traces, {"095-trace"}};
+
+    WHEN("Two windows are run")
+    {
+      auto first = nlohmann::json::parse(uut.execute("run 200"));
+      auto second = nlohmann::json::parse(uut.execute("run 300"));
+
+      THEN("Each response holds the statistics of its own window")
+      {
+        REQUIRE(first.at("status") == "ok");
+        REQUIRE(second.at("status") == "ok");
+        CHECK(first.at("stats").at("sim").at("cores").at(0).at("instructions").get<long long>() >= 200);
+        CHECK(second.at("stats").at("sim").at("cores").at(0).at("instructions").get<long long>() >= 300);
+        CHECK(second.at("stats").at("sim").at("cores").at(0).at("instructions").get<long long>() < 500);
+        CHECK(first.at("stats").at("traces").at(0) == "095-trace");
+      }
+    }
+
+    WHEN("The replacement policy is switched between windows")
+    {
+      auto response = nlohmann::json::parse(uut.execute("replacement 095-uut lru"));
+
+      THEN("The switch succeeds, and the next window runs")
+      {
+        REQUIRE(response.at("status") == "ok");
+        REQUIRE(nlohmann::json::parse(uut.execute("run 100")).at("status") == "ok");
+      }
+    }
+
+    WHEN("The cache state is saved and restored")
+    {
+      const auto path = std::filesystem::temp_directory_path() / "095-simulation-server.bin";
+      env.cache.block.at(3).valid = true;
+      env.cache.block.at(3).address = champsim::address{0xdead00};
+
+      auto save_response = nlohmann::json::parse(uut.execute(fmt::format("save {}", path.string())));
+      env.cache.restore_checkpoint(std::vector<CACHE::checkpoint_entry>{});
+      auto load_response = nlohmann::json::parse(uut.execute(fmt::format("load {}", path.string())));
+      std::filesystem::remove(path);
+
+      THEN("The cache contents come back")
+      {
+        REQUIRE(save_response.at("status") == "ok");
+        REQUIRE(load_response.at("status") == "ok");
+        CHECK(env.cache.block.at(3).valid);
+        CHECK(env.cache.block.at(3).address == champsim::address{0xdead00});
+      }
+    }
+
+    WHEN("A full snapshot is taken and restored")
+    {
+      const auto path = std::filesystem::temp_directory_path() / "095-simulation-server-snapshot.bin";
+      env.cache.block.at(2).valid = true;
+      env.cache.block.at(2).address = champsim::address{0xbeef00};
+
+      auto snapshot_response = nlohmann::json::parse(uut.execute(fmt::format("snapshot {}", path.string())));
+      env.cache.block.at(2).valid = false;
+      auto restore_response = nlohmann::json::parse(uut.execute(fmt::format("restore {}", path.string())));
+      std::filesystem::remove(path);
+
+      THEN("The cache contents come back")
+      {
+        REQUIRE(snapshot_response.at("status") == "ok");
+        REQUIRE(restore_response.at("status") == "ok");
+        CHECK(env.cache.block.at(2).valid);
+        CHECK(env.cache.block.at(2).address == champsim::address{0xbeef00});
+      }
+    }
+
+    WHEN("Malformed or unknown commands are given")
+    {
+      auto command = GENERATE(as<std::string>{}, "", "run", "run -5", "run ten", "fly 10", "prefetcher NOT_A_CACHE no", "replacement 095-uut not_a_policy",
+                              "restore /nonexistent/095-snapshot.bin", "branch /tmp/095-branch.sock");
+
+      THEN("An error is reported and the server keeps going")
+      {
+        CHECK(nlohmann::json::parse(uut.execute(command)).at("status") == "error");
+        CHECK_FALSE(uut.finished());
+      }
+    }
+
+    WHEN("Commands are streamed")
+    {
+      std::istringstream input{"skip 10\nquit\nrun 10\n"};
+      std::ostringstream output;
+      uut.serve(input, output);
+
+      THEN("One response is written per command, up to the quit")
+      {
+        std::istringstream responses{output.str()};
+        std::vector<nlohmann::json> lines;
+        for (std::string line; std::getline(responses, line);) {
+          lines.push_back(nlohmann::json::parse(line));
+        }
+        REQUIRE(std::size(lines) == 2);
+        CHECK(lines.at(0).at("skipped").at(0) == 10);
+        CHECK(uut.finished());
+      }
+    }
+  }
+}
@@ -0,0 +1,217 @@
+#include <catch.hpp>
+#include <sstream>
+
+#include "../../../replacement/lru/lru.h"
+#include "cache.h"
+#include "defaults.hpp"
+#include "dram_controller.h"
+#include "environment.h"
+#include "instr.h"
+#include "mocks.hpp"
+#include "ooo_cpu.h"
+#include "ptw.h"
+#include "sim_snapshot.h"
+#include "vmem.h"
+
+namespace
+{
+struct snapshot_test_environment final : champsim::environment {
+  MEMORY_CONTROLLER dram{champsim::chrono::picoseconds{3200},
+                         champsim::chrono::picoseconds{6400},
+                         std::size_t{18},
+                         std::size_t{18},
+                         std::size_t{18},
+                         std::size_t{38},
+                         champsim::chrono::microseconds{64000},
+                         {},
+                         64,
+                         64,
+                         1,
+                         champsim::data::bytes{8},
+                         1024,
+                         1024,
+                         4,
+                         4,
+                         4,
+                         8192};
+  VirtualMemory vmem{champsim::data::bytes{1 << 12}, 5, champsim::chrono::nanoseconds{640}, dram, 0x096};
+  do_nothing_MRC mock_ll;
+  CACHE cache{
+      champsim::cache_builder{champsim::defaults::default_l2c}.name("096-uut").sets(1).ways(4).upper_levels({}).lower_level(&mock_ll.queues).replacement<lru>()};
+  PageTableWalker ptw{
+      champsim::ptw_builder{champsim::defaults::default_ptw}.name("096-ptw").upper_levels({}).lower_level(&mock_ll.queues).virtual_memory(&vmem)};
+
+  std::vector<std::reference_wrapper<O3_CPU>> cpu_view() final { return {}; }
+  std::vector<std::reference_wrapper<CACHE>> cache_view() final { return {std::ref(cache)}; }
+  std::vector<std::reference_wrapper<PageTableWalker>> ptw_view() final { return {std::ref(ptw)}; }
+  MEMORY_CONTROLLER& dram_view() final { return dram; }
+  std::vector<std::reference_wrapper<champsim::operable>> operable_view() final { return {cache, ptw, dram}; }
+};
+
+long victim_of(CACHE& cache) { return cache.impl_find_victim(0, 0, 0, std::data(cache.block), champsim::address{}, champsim::address{}, access_type::LOAD); }
+
+void touch(CACHE& cache, long way)
+{
+  cache.impl_update_replacement_state(0, 0, way, champsim::address{}, champsim::address{}, champsim::address{}, access_type::LOAD, true);
+}
+
+// A core whose caches answer in the cycle they are asked, so that every request in flight is in the core or its channels
+struct snapshot_test_core {
+  do_nothing_MRC mock_L1I, mock_L1D;
+  O3_CPU cpu{champsim::core_builder{}.fetch_queues(&mock_L1I.queues).data_queues(&mock_L1D.queues)};
+  std::array<champsim::operable*, 3> elements{{&cpu, &mock_L1I, &mock_L1D}};
+  uint64_t next_instr = 0;
+
+  snapshot_test_core()
+  {
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+  }
+
+  // Each instruction loads from one of a few blocks, and is identified by its position in the trace
+  void operate(int cycles)
+  {
+    for (int i = 0; i < cycles; ++i) {
+      while (std::size(cpu.input_queue) < static_cast<std::size_t>(cpu.IN_QUEUE_SIZE)) {
+        auto instr = champsim::test::instruction_with_ip_and_source_memory(champsim::address{0x400000 + 4 * next_instr},
+                                                                           champsim::address{0x10000000 + 64 * (next_instr % 13)});
+        instr.instr_id = next_instr++;
+        cpu.input_queue.push_back(instr);
+      }
+      for (auto elem : elements) {
+        elem->_operate();
+      }
+    }
+  }
+
+  std::vector<long long> retired_per_cycle(int cycles)
+  {
+    std::vector<long long> retval;
+    for (int i = 0; i < cycles; ++i) {
+      const auto before = cpu.num_retired;
+      operate(1);
+      retval.push_back(cpu.num_retired - before);
+    }
+    return retval;
+  }
+};
+} // namespace
+
+SCENARIO("A snapshot restores the warm state of the simulator")
+{
+  GIVEN("An environment with warm caches, paging structures, and page mappings")
+  {
+    snapshot_test_environment env;
+    for (long way = 0; way < 4; ++way) {
+      env.cache.block.at(static_cast<std::size_t>(way)).valid = true;
+      env.cache.block.at(static_cast<std::size_t>(way)).address = champsim::address{static_cast<uint64_t>(0x1000 * (way + 1))};
+      env.cache.impl_replacement_cache_fill(0, 0, way, champsim::address{}, champsim::address{}, champsim::address{}, access_type::LOAD);
+    }
+    touch(env.cache, 0);
+    REQUIRE(victim_of(env.cache) == 1);
+
+    env.ptw.pscl.front().fill({champsim::address{0xdeadbeef}, champsim::address{0xcafe000}, 5});
+    auto [mapped_page, first_penalty] = env.vmem.va_to_pa(0, champsim::page_number{0xdead});
+    REQUIRE(first_penalty > champsim::chrono::clock::duration::zero());
+
+    std::stringstream snapshot_data;
+    champsim::save_snapshot(env, snapshot_data);
+
+    WHEN("The state changes and the snapshot is restored")
+    {
+      touch(env.cache, 1);
+      env.cache.block.at(3).valid = false;
+      env.ptw.pscl.front().invalidate({champsim::address{0xdeadbeef}, champsim::address{}, 5});
+      auto [later_page, later_penalty] = env.vmem.va_to_pa(0, champsim::page_number{0xbeef});
+      REQUIRE(victim_of(env.cache) == 2);
+
+      champsim::load_snapshot(env, snapshot_data);
+
+      THEN("The replacement state, blocks, and paging structure caches are as they were")
+      {
+        CHECK(victim_of(env.cache) == 1);
+        CHECK(env.cache.block.at(3).valid);
+        CHECK(env.cache.block.at(3).address == champsim::address{0x4000});
+        CHECK(env.ptw.pscl.front().check_hit({champsim::address{0xdeadbeef}, champsim::address{}, 5}).has_value());
+      }
+
+      THEN("Existing page mappings are kept, and new pages are allocated as they would have been")
+      {
+        auto [restored_page, restored_penalty] = env.vmem.va_to_pa(0, champsim::page_number{0xdead});
+        CHECK(restored_page == mapped_page);
+        CHECK(restored_penalty == champsim::chrono::clock::duration::zero());
+
+        auto [replayed_page, replayed_penalty] = env.vmem.va_to_pa(0, champsim::page_number{0xbeef});
+        CHECK(replayed_page == later_page);
+        CHECK(replayed_penalty == later_penalty);
+      }
+    }
+
+    WHEN("The snapshot is truncated")
+    {
+      auto truncated = snapshot_data.str();
+      truncated.resize(std::size(truncated) / 2);
+      std::istringstream truncated_stream{truncated};
+
+      THEN("It is rejected") { REQUIRE_THROWS_AS(champsim::load_snapshot(env, truncated_stream), std::runtime_error); }
+    }
+
+    WHEN("The data is not a snapshot")
+    {
+      std::istringstream bad_stream{"this is not a snapshot of anything"};
+
+      THEN("It is rejected") { REQUIRE_THROWS_AS(champsim::load_snapshot(env, bad_stream), std::runtime_error); }
+    }
+  }
+}
+
+SCENARIO("A restored core continues as a run from the saved point")
+{
+  GIVEN("A core with instructions in flight, whose state is saved")
+  {
+    snapshot_test_core uut;
+    uut.operate(200);
+    const auto saved_position = uut.next_instr;
+
+    std::stringstream saved;
+    champsim::serialization::output_archive out_ar{saved};
+    uut.cpu.save_state(out_ar);
+
+    WHEN("The core runs on, and then restores the state and reads the trace from the saved point")
+    {
+      uut.operate(100);
+      REQUIRE_FALSE(std::empty(uut.cpu.ROB));
+
+      champsim::serialization::input_archive in_ar{saved};
+      uut.cpu.load_state(in_ar);
+      uut.next_instr = saved_position;
+
+      THEN("Its pipeline is empty")
+      {
+        CHECK(std::empty(uut.cpu.input_queue));
+        CHECK(std::empty(uut.cpu.IFETCH_BUFFER));
+        CHECK(std::empty(uut.cpu.DECODE_BUFFER));
+        CHECK(std::empty(uut.cpu.DISPATCH_BUFFER));
+        CHECK(std::empty(uut.cpu.ROB));
+        CHECK(std::empty(uut.cpu.SQ));
+        CHECK(std::all_of(std::begin(uut.cpu.LQ), std::end(uut.cpu.LQ), [](const auto& x) { return !x.has_value(); }));
+        CHECK(std::empty(uut.mock_L1D.queues.RQ));
+        CHECK(std::empty(uut.mock_L1D.queues.returned));
+      }
+
+      AND_WHEN("A fresh core restores the same state and reads the trace from the same point")
+      {
+        snapshot_test_core fresh;
+        std::istringstream fresh_saved{saved.str()};
+        champsim::serialization::input_archive fresh_ar{fresh_saved};
+        fresh.cpu.load_state(fresh_ar);
+        fresh.next_instr = saved_position;
+
+        THEN("Both retire the same instructions on the same cycles") { REQUIRE(uut.retired_per_cycle(300) == fresh.retired_per_cycle(300)); }
+      }
+    }
+  }
+}
@@ -287,3 +287,38 @@ SCENARIO("The register allocator correctly recycles physical registers when no l
     }
   }
 }
+
+SCENARIO("Completing a physical register wakes the instructions that wait for it.")
+{
+  GIVEN("A register that is being produced and two instructions that wait for it")
+  {
+    constexpr int PHYSICALREGS = 128;
+    RegisterAllocator ra{PHYSICALREGS};
+
+    auto write = champsim::test::instruction_with_ip(0);
+    write.destination_registers.push_back(5);
+    write.destination_registers[0] = ra.rename_dest_register(write.destination_registers[0], write.instr_id);
+    auto physreg = write.destination_registers[0];
+
+    ra.wait_for_register(physreg, 3);
+    ra.wait_for_register(physreg, 1);
+
+    WHEN("The register is completed")
+    {
+      std::vector<champsim::program_ordered<ooo_model_instr>::id_type> woken{};
+      ra.complete_dest_register(physreg, [&](auto id) { woken.push_back(id); });
+
+      THEN("The register is valid") { REQUIRE(ra.isValid(physreg)); }
+
+      THEN("The waiters are woken in the order in which they began to wait") { REQUIRE(woken == std::vector<champsim::program_ordered<ooo_model_instr>::id_type>{3, 1}); }
+
+      AND_WHEN("The register is completed again")
+      {
+        woken.clear();
+        ra.complete_dest_register(physreg, [&](auto id) { woken.push_back(id); });
+
+        THEN("No instructions are woken") { REQUIRE(std::empty(woken)); }
+      }
+    }
+  }
+}
@@ -66,3 +66,56 @@ SCENARIO("The core issues loads only after its registers are finished")
     }
   }
 }
+
+SCENARIO("The core forwards stores to later loads from the same address")
+{
+  GIVEN("A DISPATCH_BUFFER with a store and a later load from the same address")
+  {
+    do_nothing_MRC mock_L1I, mock_L1D;
+    O3_CPU uut{champsim::core_builder{}
+                   .fetch_queues(&mock_L1I.queues)
+                   .data_queues(&mock_L1D.queues)
+                   .dispatch_width(champsim::bandwidth::maximum_type{2})
+                   .rob_size(2)
+                   .lq_size(4)};
+
+    auto store = champsim::test::instruction_with_ip(champsim::address{2000});
+    store.destination_memory.push_back(champsim::address{0xcafe0000});
+    store.instr_id = 1;
+    auto load = champsim::test::instruction_with_ip_and_source_memory(champsim::address{2004}, champsim::address{0xcafe0000});
+    load.instr_id = 2;
+
+    uut.DISPATCH_BUFFER.push_back(store);
+    uut.DISPATCH_BUFFER.push_back(load);
+    for (auto& instr : uut.DISPATCH_BUFFER)
+      instr.ready_time = champsim::chrono::clock::time_point{};
+
+    WHEN("The instructions are promoted to the ROB")
+    {
+      for (auto op : std::array<champsim::operable*, 3>{{&uut, &mock_L1I, &mock_L1D}})
+        op->_operate();
+
+      THEN("The load waits on the store")
+      {
+        REQUIRE(std::size(uut.SQ) == 1);
+        REQUIRE(std::size(uut.SQ.front().lq_depend_on_me) == 1);
+        REQUIRE(uut.LQ.at(0).has_value());
+        REQUIRE(uut.LQ.at(0)->producer_id == store.instr_id);
+      }
+
+      AND_WHEN("The store is executed")
+      {
+        for (int i = 0; i < 10000 && uut.LQ.at(0).has_value(); ++i) {
+          for (auto op : std::array<champsim::operable*, 3>{{&uut, &mock_L1I, &mock_L1D}})
+            op->_operate();
+        }
+
+        THEN("The load is forwarded without being issued")
+        {
+          REQUIRE(std::none_of(std::begin(uut.LQ), std::end(uut.LQ), [](const auto& x) { return x.has_value(); }));
+          REQUIRE(mock_L1D.packet_count() == 0);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,243 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "commit_trace.h"
+#include "inf_stream.h"
+#include "instr.h"
+#include "mocks.hpp"
+#include "ooo_cpu.h"
+
+namespace
+{
+std::vector<champsim::commit_record> make_records(std::size_t count)
+{
+  std::vector<champsim::commit_record> records;
+  for (uint64_t i = 0; i < count; ++i) {
+    records.push_back({0x400000 + 4 * i, 0xffff0000ULL << 16 | i, i % 7, i % 5, i % 3, i % 11, 1000 + 2 * i, (i == 0) ? uint64_t{0} : uint64_t{2}});
+  }
+  return records;
+}
+
+std::string read_file(const std::filesystem::path& path)
+{
+  std::ifstream file{path, std::ios::binary};
+  return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+std::string expected_csv(const std::vector<champsim::commit_record>& records)
+{
+  std::stringstream ss;
+  ss << champsim::commit_trace_header << '\n';
+  for (const auto& rec : records) {
+    ss << rec.pc << ',' << rec.memory_address << ',' << rec.opcode << ',' << rec.source_register1 << ',' << rec.source_register2 << ','
+       << rec.destination_register1 << ',' << rec.commit_cycle << ',' << rec.delta_cycles << '\n';
+  }
+  return ss.str();
+}
+
+std::string as_bytes(const std::vector<champsim::commit_record>& records)
+{
+  return std::string{reinterpret_cast<const char*>(std::data(records)), std::size(records) * sizeof(champsim::commit_record)};
+}
+} // namespace
+
+SCENARIO("A commit trace writer writes every record in order, in each format")
+{
+  auto batch_size = GENERATE(as<std::size_t>{}, 1, 3, 64);
+  const auto records = make_records(50);
+
+  GIVEN("A CSV trace")
+  {
+    const auto path = std::filesystem::temp_directory_path() / "311-commit-trace.csv";
+    champsim::commit_trace_writer uut{path.string(), champsim::commit_trace_format::csv, champsim::commit_trace_compression::none, batch_size, 2};
+    for (const auto& rec : records) {
+      uut.push(rec);
+    }
+    uut.close();
+
+    THEN("The file holds a header and a line of decimal integers per record")
+    {
+      REQUIRE(uut.size() == std::size(records));
+      REQUIRE(read_file(path) == expected_csv(records));
+    }
+    std::filesystem::remove(path);
+  }
+
+  GIVEN("A binary trace")
+  {
+    const auto path = std::filesystem::temp_directory_path() / "311-commit-trace.bin";
+    champsim::commit_trace_writer uut{path.string(), champsim::commit_trace_format::bin, champsim::commit_trace_compression::none, batch_size, 2};
+    for (const auto& rec : records) {
+      uut.push(rec);
+    }
+    uut.close();
+
+    THEN("The file holds the records as packed 64-bit columns")
+    {
+      REQUIRE(read_file(path) == as_bytes(records));
+    }
+    std::filesystem::remove(path);
+  }
+
+  GIVEN("A NumPy trace")
+  {
+    const auto path = std::filesystem::temp_directory_path() / "311-commit-trace.npy";
+    champsim::commit_trace_writer uut{path.string(), champsim::commit_trace_format::npy, champsim::commit_trace_compression::none, batch_size, 2};
+    for (const auto& rec : records) {
+      uut.push(rec);
+    }
+    uut.close();
+
+    THEN("The file holds an aligned header with the shape of the array, followed by the records")
+    {
+      const auto contents = read_file(path);
+      const auto header_size = 10 + (static_cast<unsigned char>(contents.at(8)) | (static_cast<unsigned char>(contents.at(9)) << 8));
+      const auto header = contents.substr(0, header_size);
+
+      REQUIRE(header_size % 64 == 0);
+      REQUIRE(header.substr(0, 8) == std::string{"\x93NUMPY\x01\x00", 8});
+      REQUIRE(header.find("'descr': '<u8'") != std::string::npos);
+      REQUIRE(header.find("'shape': (50, 8)") != std::string::npos);
+      REQUIRE(header.back() == '\n');
+      REQUIRE(contents.substr(header_size) == as_bytes(records));
+    }
+    std::filesystem::remove(path);
+  }
+
+  GIVEN("An xz-compressed binary trace")
+  {
+    const auto path = std::filesystem::temp_directory_path() / "311-commit-trace.bin.xz";
+    champsim::commit_trace_writer uut{path.string(), champsim::commit_trace_format::bin, champsim::commit_trace_compression::xz, batch_size, 2};
+    for (const auto& rec : records) {
+      uut.push(rec);
+    }
+    uut.close();
+
+    THEN("The file inflates to the records as packed 64-bit columns")
+    {
+      champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>> inflated{path.string()};
+      std::string contents(std::size(records) * sizeof(champsim::commit_record), '\0');
+      inflated.read(std::data(contents), static_cast<std::streamsize>(std::size(contents)));
+      REQUIRE(inflated.gcount() == static_cast<std::streamsize>(std::size(contents)));
+      REQUIRE(contents == as_bytes(records));
+
+      char past_end = '\0';
+      inflated.read(&past_end, 1);
+      REQUIRE(inflated.gcount() == 0);
+    }
+    std::filesystem::remove(path);
+  }
+}
+
+TEST_CASE("A NumPy commit trace cannot be compressed")
+{
+  const auto path = std::filesystem::temp_directory_path() / "311-commit-trace.npy.xz";
+  REQUIRE_THROWS_AS(champsim::commit_trace_writer(path.string(), champsim::commit_trace_format::npy, champsim::commit_trace_compression::xz),
+                    std::invalid_argument);
+}
+
+TEST_CASE("A forked child does not write to the commit trace of its parent")
+{
+  const auto path = std::filesystem::temp_directory_path() / "311-commit-trace-fork.bin";
+  const auto records = make_records(8);
+
+  // Each record fills a batch, so the writer thread is running when the process forks
+  champsim::commit_trace_writer uut{path.string(), champsim::commit_trace_format::bin, champsim::commit_trace_compression::none, 1, 1};
+  for (std::size_t i = 0; i < 4; ++i) {
+    uut.push(records.at(i));
+  }
+
+  std::fflush(nullptr);
+  auto pid = ::fork();
+  REQUIRE(pid >= 0);
+  if (pid == 0) {
+    int status = 0;
+    try {
+      uut.push(records.at(4));
+      status = 1;
+    } catch (const std::logic_error&) {
+    }
+    uut.close();
+    std::_Exit(status);
+  }
+
+  int child_status = -1;
+  REQUIRE(::waitpid(pid, &child_status, 0) == pid);
+  CHECK(WIFEXITED(child_status));
+  CHECK(WEXITSTATUS(child_status) == 0);
+
+  for (std::size_t i = 4; i < std::size(records); ++i) {
+    uut.push(records.at(i));
+  }
+  uut.close();
+  REQUIRE(read_file(path) == as_bytes(records));
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("A commit trace record holds the columns of the NeuroScalar dump")
+{
+  input_instr i{};
+  i.ip = 0x1234;
+  i.destination_registers[0] = 10;
+  i.source_registers[0] = 1;
+  i.source_registers[1] = 2;
+  i.source_memory[0] = 0xdeadbeef;
+  ooo_model_instr instr{0, i};
+
+  const auto records = std::vector<champsim::commit_record>{instr.commit_trace_record(42, 1)};
+  std::stringstream ss;
+  instr.dump_neuroscalar_csv(ss, 42, 1);
+
+  REQUIRE(expected_csv(records) == std::string{champsim::commit_trace_header} + "\n" + ss.str());
+}
+
+SCENARIO("A core writes a record for each retired instruction")
+{
+  GIVEN("A core with a binary commit trace and completed instructions in its ROB")
+  {
+    const auto path = std::filesystem::temp_directory_path() / "311-core-commit-trace.bin";
+    do_nothing_MRC mock_L1I, mock_L1D;
+    O3_CPU uut{champsim::core_builder{}
+                   .retire_width(champsim::bandwidth::maximum_type{4})
+                   .fetch_queues(&mock_L1I.queues)
+                   .data_queues(&mock_L1D.queues)};
+    uut.open_commit_trace(path.string(), true, champsim::commit_trace_format::bin);
+
+    for (uint64_t ip = 1; ip <= 3; ++ip) {
+      uut.ROB.push_back(champsim::test::instruction_with_ip(ip));
+      uut.ROB.back().completed = true;
+    }
+
+    WHEN("The instructions retire and the trace is closed")
+    {
+      for (auto op : std::array<champsim::operable*, 3>{{&uut, &mock_L1I, &mock_L1D}}) {
+        op->_operate();
+      }
+      uut.close_commit_trace();
+
+      THEN("The trace holds the instructions in program order")
+      {
+        const auto contents = read_file(path);
+        REQUIRE(std::size(contents) == 3 * sizeof(champsim::commit_record));
+
+        std::vector<champsim::commit_record> written(3);
+        std::memcpy(std::data(written), std::data(contents), std::size(contents));
+        REQUIRE(written.at(0).pc == 1);
+        REQUIRE(written.at(1).pc == 2);
+        REQUIRE(written.at(2).pc == 3);
+      }
+    }
+    std::filesystem::remove(path);
+  }
+}
@@ -0,0 +1,117 @@
+#include <catch.hpp>
+#include <filesystem>
+#include <fstream>
+
+#include "cache.h"
+#include "cache_checkpoint.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+
+namespace
+{
+CACHE make_checkpoint_cache(std::string name, uint32_t sets, uint32_t ways, champsim::channel* ll)
+{
+  return CACHE{champsim::cache_builder{champsim::defaults::default_l2c}.name(name).sets(sets).ways(ways).upper_levels({}).lower_level(ll)};
+}
+
+void populate(CACHE& cache)
+{
+  for (std::size_t i = 0; i < std::size(cache.block); i += 3) {
+    auto& blk = cache.block.at(i);
+    blk.valid = true;
+    blk.dirty = (i % 2) == 0;
+    blk.prefetch = (i % 5) == 0;
+    blk.address = champsim::address{0x1000 + 0x40 * i};
+    blk.v_address = champsim::address{0xffff0000 + 0x40 * i};
+    blk.data = champsim::address{0xbeef0000 + i};
+    blk.pf_metadata = static_cast<uint32_t>(i * 7);
+  }
+}
+} // namespace
+
+SCENARIO("A binary cache checkpoint restores every block field")
+{
+  GIVEN("Two populated caches")
+  {
+    do_nothing_MRC mock_ll;
+    auto uut_a = make_checkpoint_cache("409-uut-a", 8, 4, &mock_ll.queues);
+    auto uut_b = make_checkpoint_cache("409-uut-b", 4, 2, &mock_ll.queues);
+    uut_a.initialize();
+    uut_b.initialize();
+    populate(uut_a);
+    populate(uut_b);
+
+    const auto expected_a = uut_a.block;
+    const auto expected_b = uut_b.block;
+    const auto path = std::filesystem::temp_directory_path() / "409-cache-checkpoint.bin";
+
+    WHEN("The caches are saved, emptied, and loaded")
+    {
+      champsim::save_cache_checkpoint({std::ref(uut_a), std::ref(uut_b)}, path);
+      uut_a.restore_checkpoint(std::vector<CACHE::checkpoint_entry>{});
+      uut_b.restore_checkpoint(std::vector<CACHE::checkpoint_entry>{});
+      champsim::load_cache_checkpoint({std::ref(uut_a), std::ref(uut_b)}, path);
+
+      THEN("The contents match the originals")
+      {
+        auto block_eq = [](const CACHE::BLOCK& x, const CACHE::BLOCK& y) {
+          return x.valid == y.valid && x.dirty == y.dirty && x.prefetch == y.prefetch && x.address == y.address && x.v_address == y.v_address
+                 && x.data == y.data && x.pf_metadata == y.pf_metadata;
+        };
+        CHECK(std::equal(std::begin(uut_a.block), std::end(uut_a.block), std::begin(expected_a), std::end(expected_a), block_eq));
+        CHECK(std::equal(std::begin(uut_b.block), std::end(uut_b.block), std::begin(expected_b), std::end(expected_b), block_eq));
+      }
+    }
+
+    WHEN("The checkpoint is loaded into a cache with a different geometry")
+    {
+      champsim::save_cache_checkpoint({std::ref(uut_a)}, path);
+      auto other = make_checkpoint_cache("409-uut-a", 4, 4, &mock_ll.queues);
+      other.initialize();
+
+      THEN("The load is rejected") { CHECK_THROWS_AS(champsim::load_cache_checkpoint({std::ref(other)}, path), std::runtime_error); }
+    }
+
+    WHEN("The checkpoint does not mention a cache")
+    {
+      champsim::save_cache_checkpoint({std::ref(uut_a)}, path);
+      champsim::load_cache_checkpoint({std::ref(uut_a), std::ref(uut_b)}, path);
+
+      THEN("That cache is emptied")
+      {
+        CHECK(std::none_of(std::begin(uut_b.block), std::end(uut_b.block), [](const auto& blk) { return blk.valid; }));
+      }
+    }
+
+    std::filesystem::remove(path);
+  }
+}
+
+SCENARIO("A text cache checkpoint is read back by the same loader")
+{
+  GIVEN("A populated cache")
+  {
+    do_nothing_MRC mock_ll;
+    auto uut = make_checkpoint_cache("409-uut-text", 8, 4, &mock_ll.queues);
+    uut.initialize();
+    populate(uut);
+
+    const auto expected = uut.block;
+    const auto path = std::filesystem::temp_directory_path() / "409-cache-checkpoint.txt";
+
+    WHEN("The cache is exported as text and loaded")
+    {
+      champsim::save_cache_checkpoint({std::ref(uut)}, path, champsim::checkpoint_format::text);
+      uut.restore_checkpoint(std::vector<CACHE::checkpoint_entry>{});
+      champsim::load_cache_checkpoint({std::ref(uut)}, path);
+
+      THEN("The valid blocks and their addresses are restored")
+      {
+        auto address_eq = [](const CACHE::BLOCK& x, const CACHE::BLOCK& y) { return x.valid == y.valid && (!x.valid || x.address == y.address); };
+        CHECK(std::equal(std::begin(uut.block), std::end(uut.block), std::begin(expected), std::end(expected), address_eq));
+      }
+    }
+
+    std::filesystem::remove(path);
+  }
+}
@@ -321,3 +321,33 @@ SCENARIO("Translating cache queues forward RQ virtual to physical RQ")
     }
   }
 }
+
+SCENARIO("Cache queues merge with the packets that remain after the front of the queue is consumed")
+{
+  GIVEN("A read queue with two checked packets")
+  {
+    champsim::address address_a{0xdeadbeef};
+    champsim::address address_b{0xcafebabe};
+    champsim::channel uut{32, 32, 32, champsim::data::bits{LOG2_BLOCK_SIZE}, false};
+
+    issue(uut, address_a, issue_rq<champsim::channel>);
+    issue(uut, address_b, issue_rq<champsim::channel>);
+    uut.check_collision();
+
+    WHEN("The first packet is consumed and packets with both addresses are sent to the read queue")
+    {
+      uut.RQ.pop_front();
+      issue(uut, address_a, issue_rq<champsim::channel>);
+      issue(uut, address_b, issue_rq<champsim::channel>);
+      uut.check_collision();
+
+      THEN("Only the packet with the remaining address is merged")
+      {
+        REQUIRE(uut.sim_stats.RQ_MERGED == 1);
+        REQUIRE(uut.rq_occupancy() == 2);
+        REQUIRE(uut.RQ.at(0).address == address_b);
+        REQUIRE(uut.RQ.at(1).address == address_a);
+      }
+    }
+  }
+}
@@ -0,0 +1,57 @@
+#include <catch.hpp>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+
+SCENARIO("A cache reports when its next tag check is ready")
+{
+  GIVEN("An empty cache")
+  {
+    constexpr auto hit_latency = 7;
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                  .name("416-uut")
+                  .upper_levels({&mock_ul.queues})
+                  .lower_level(&mock_ll.queues)
+                  .hit_latency(hit_latency)
+                  .prefetch_activate(access_type::LOAD)};
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+
+    // Initialize the prefetching and replacement
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    THEN("It has no event to wait for") { REQUIRE(uut.next_event_time() == champsim::chrono::clock::time_point::max()); }
+
+    WHEN("A packet is issued")
+    {
+      decltype(mock_ul)::request_type test;
+      test.address = champsim::address{0xdeadbeef};
+      test.is_translated = true;
+      test.cpu = 0;
+      test.type = access_type::LOAD;
+
+      auto test_result = mock_ul.issue(test);
+      THEN("This issue is received") { REQUIRE(test_result); }
+
+      THEN("The cache has work on its next cycle") { REQUIRE(uut.next_event_time() == uut.current_time + uut.clock_period); }
+
+      AND_WHEN("The cache begins the tag check")
+      {
+        for (auto elem : elements)
+          elem->_operate();
+
+        THEN("The next event is the completion of the tag check")
+        {
+          REQUIRE(uut.next_event_time() == uut.current_time + hit_latency * uut.clock_period);
+        }
+      }
+    }
+  }
+}
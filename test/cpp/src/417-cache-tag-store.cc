@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <vector>
+
+#include "cache.h"
+#include "cache_tag_store.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+
+TEST_CASE("A tag store finds the first valid way that holds a tag")
+{
+  auto ways = GENERATE(as<std::size_t>{}, 1, 3, 16, 64, 100);
+  champsim::cache_tag_store uut{4, ways};
+
+  REQUIRE(uut.find_valid(2, 0) == ways);
+  REQUIRE(uut.find_any(2, 0) == 0);
+  REQUIRE(uut.first_invalid(2) == 0);
+
+  const auto last = ways - 1;
+  uut.assign(2, last, 0xabc, true);
+  REQUIRE(uut.find_valid(2, 0xabc) == last);
+  REQUIRE(uut.find_valid(1, 0xabc) == ways);
+  REQUIRE(uut.find_valid(2, 0xabd) == ways);
+
+  uut.set_valid(2, last, false);
+  REQUIRE(uut.find_valid(2, 0xabc) == ways);
+  REQUIRE(uut.find_any(2, 0xabc) == last);
+}
+
+TEST_CASE("A tag store finds the first invalid way")
+{
+  auto ways = GENERATE(as<std::size_t>{}, 1, 3, 16, 64, 100);
+  champsim::cache_tag_store uut{2, ways};
+
+  for (std::size_t way = 0; way < ways; ++way) {
+    REQUIRE(uut.first_invalid(1) == way);
+    uut.assign(1, way, way, true);
+  }
+  REQUIRE(uut.first_invalid(1) == ways);
+  REQUIRE(uut.first_invalid(0) == 0);
+
+  uut.set_valid(1, ways / 2, false);
+  REQUIRE(uut.first_invalid(1) == ways / 2);
+}
+
+SCENARIO("A cache finds blocks that were placed directly, once its tag store is rebuilt")
+{
+  GIVEN("A cache with a block placed in its tag array")
+  {
+    do_nothing_MRC mock_ll;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}.name("417-uut").sets(4).ways(8).upper_levels({}).lower_level(&mock_ll.queues)};
+    uut.initialize();
+
+    const champsim::address addr{0x1080}; // set 2
+    uut.block.at(2 * 8 + 5).valid = true;
+    uut.block.at(2 * 8 + 5).address = addr;
+    uut.rebuild_tag_store();
+
+    WHEN("The block is invalidated")
+    {
+      auto way = uut.invalidate_entry(addr);
+
+      THEN("The way that held it is found")
+      {
+        REQUIRE(way == 5);
+        REQUIRE_FALSE(uut.block.at(2 * 8 + 5).valid);
+      }
+    }
+  }
+}
+
+TEST_CASE("Tag lookup benchmarks")
+{
+  constexpr std::size_t sets = 2048;
+  constexpr std::size_t ways = 16;
+  constexpr uint64_t offset_bits = 6;
+
+  std::vector<champsim::cache_block> blocks(sets * ways);
+  champsim::cache_tag_store store{sets, ways};
+  for (std::size_t i = 0; i < std::size(blocks); ++i) {
+    const auto block_number = (i * 2654435761ULL) & 0xffffff;
+    blocks[i].valid = true;
+    blocks[i].address = champsim::address{(block_number * sets + i / ways) << offset_bits};
+    store.assign(i / ways, i % ways, blocks[i].address.slice_upper(champsim::data::bits{offset_bits}).to<uint64_t>(), true);
+  }
+
+  std::vector<champsim::address> lookups;
+  for (std::size_t i = 0; i < 4096; ++i) {
+    lookups.push_back(blocks[(i * 40503) % std::size(blocks)].address); // hits in every way
+  }
+
+  BENCHMARK("Searching the blocks of 16-way sets")
+  {
+    std::size_t found = 0;
+    for (const auto& addr : lookups) {
+      const auto set = addr.slice(champsim::dynamic_extent{champsim::data::bits{offset_bits}, champsim::lg2(sets)}).to<std::size_t>();
+      const auto begin = std::next(std::cbegin(blocks), static_cast<long>(set * ways));
+      const auto match = addr.slice_upper(champsim::data::bits{offset_bits});
+      found += static_cast<std::size_t>(std::distance(begin, std::find_if(begin, std::next(begin, ways), [&](const auto& x) {
+                                          return x.valid && x.address.slice_upper(champsim::data::bits{offset_bits}) == match;
+                                        })));
+    }
+    return found;
+  };
+
+  BENCHMARK("Searching the tag store of 16-way sets")
+  {
+    std::size_t found = 0;
+    for (const auto& addr : lookups) {
+      const auto set = addr.slice(champsim::dynamic_extent{champsim::data::bits{offset_bits}, champsim::lg2(sets)}).to<std::size_t>();
+      found += store.find_valid(set, addr.slice_upper(champsim::data::bits{offset_bits}).to<uint64_t>());
+    }
+    return found;
+  };
+}
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "mshr_file.h"
+
+namespace
+{
+struct entry_type {
+  uint64_t block;
+  bool returned = false;
+};
+
+// The MSHR as a deque, returned in the way that CACHE::finish_packet has always done it
+struct reference_mshr {
+  std::deque<entry_type> entries;
+
+  void mark_returned(uint64_t block)
+  {
+    auto entry = std::find_if(std::begin(entries), std::end(entries), [block](const auto& x) { return x.block == block; });
+    auto first_unreturned = std::find_if(std::begin(entries), std::end(entries), [](const auto& x) { return !x.returned; });
+    entry->returned = true;
+    if (first_unreturned != std::end(entries)) {
+      std::iter_swap(entry, first_unreturned);
+    }
+  }
+};
+
+std::vector<uint64_t> blocks_of(const champsim::mshr_file<entry_type>& file)
+{
+  std::vector<uint64_t> retval;
+  std::transform(std::begin(file), std::end(file), std::back_inserter(retval), [](const auto& x) { return x.block; });
+  return retval;
+}
+
+std::vector<uint64_t> blocks_of(const reference_mshr& ref)
+{
+  std::vector<uint64_t> retval;
+  std::transform(std::begin(ref.entries), std::end(ref.entries), std::back_inserter(retval), [](const auto& x) { return x.block; });
+  return retval;
+}
+} // namespace
+
+SCENARIO("An MSHR file finds its entries by block")
+{
+  GIVEN("An MSHR file with two entries")
+  {
+    champsim::mshr_file<entry_type> uut;
+    auto first = uut.push_back(0x10, {0x10});
+    auto second = uut.push_back(0x20, {0x20});
+
+    THEN("Each entry is found in its slot")
+    {
+      REQUIRE(std::size(uut) == 2);
+      REQUIRE(uut.find(0x10) == first);
+      REQUIRE(uut.find(0x20) == second);
+      REQUIRE_FALSE(uut.find(0x30).has_value());
+      REQUIRE(uut[second].block == 0x20);
+    }
+
+    WHEN("The second entry returns")
+    {
+      uut.mark_returned(second);
+
+      THEN("It is moved to the front")
+      {
+        REQUIRE(uut.front().block == 0x20);
+        REQUIRE(blocks_of(uut) == std::vector<uint64_t>{0x20, 0x10});
+      }
+
+      AND_WHEN("It is removed")
+      {
+        uut.pop_front();
+
+        THEN("It is no longer found, and the other keeps its slot")
+        {
+          REQUIRE(std::size(uut) == 1);
+          REQUIRE_FALSE(uut.find(0x20).has_value());
+          REQUIRE(uut.find(0x10) == first);
+        }
+      }
+    }
+
+    WHEN("The file is cleared")
+    {
+      uut.clear();
+
+      THEN("Nothing is found")
+      {
+        REQUIRE(std::empty(uut));
+        REQUIRE_FALSE(uut.find(0x10).has_value());
+      }
+    }
+  }
+}
+
+TEST_CASE("An MSHR file orders its entries as a deque that swaps returned entries forward")
+{
+  auto seed = GENERATE(as<unsigned>{}, 1, 2, 3, 4);
+  std::mt19937_64 rng{seed};
+  champsim::mshr_file<entry_type> uut;
+  reference_mshr ref;
+  uint64_t next_block = 0;
+
+  for (int step = 0; step < 20000; ++step) {
+    const auto action = rng() % 8;
+    if (action < 3 && std::size(ref.entries) < 64) {
+      uut.push_back(next_block, {next_block});
+      ref.entries.push_back({next_block});
+      ++next_block;
+    } else if (action < 6 && !std::empty(ref.entries)) {
+      // Mostly return entries that have not yet returned, but sometimes repeat a return
+      const auto& chosen = ref.entries.at(rng() % std::size(ref.entries));
+      const auto block = chosen.block;
+      auto slot = uut.find(block);
+      REQUIRE(slot.has_value());
+      if (!chosen.returned || action == 5) {
+        uut.mark_returned(*slot);
+        ref.mark_returned(block);
+      }
+    } else if (!std::empty(ref.entries) && ref.entries.front().returned) {
+      REQUIRE(uut.front().block == ref.entries.front().block);
+      uut.pop_front();
+      ref.entries.pop_front();
+    }
+    REQUIRE(blocks_of(uut) == blocks_of(ref));
+  }
+}
+
+TEST_CASE("MSHR lookup benchmarks")
+{
+  constexpr std::size_t entries = 256;
+  std::deque<entry_type> deque_mshr;
+  champsim::mshr_file<entry_type> file_mshr;
+  for (uint64_t i = 0; i < entries; ++i) {
+    const auto block = i * 2654435761ULL;
+    deque_mshr.push_back({block});
+    file_mshr.push_back(block, {block});
+  }
+
+  std::vector<uint64_t> lookups;
+  for (uint64_t i = 0; i < 4096; ++i) {
+    lookups.push_back(((i * 40503) % (2 * entries)) * 2654435761ULL); // half of these hit
+  }
+
+  BENCHMARK("Searching a deque of 256 MSHRs")
+  {
+    std::size_t found = 0;
+    for (auto block : lookups) {
+      found += (std::find_if(std::begin(deque_mshr), std::end(deque_mshr), [block](const auto& x) { return x.block == block; }) != std::end(deque_mshr));
+    }
+    return found;
+  };
+
+  BENCHMARK("Searching an MSHR file of 256 MSHRs")
+  {
+    std::size_t found = 0;
+    for (auto block : lookups) {
+      found += file_mshr.find(block).has_value();
+    }
+    return found;
+  };
+}
@@ -0,0 +1,148 @@
+#include <catch.hpp>
+#include <map>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+#include "module_registry.h"
+#include "modules.h"
+
+namespace
+{
+std::map<CACHE*, int> configured_victim_calls;
+std::map<CACHE*, int> selected_update_calls;
+
+struct configured_policy : champsim::modules::replacement {
+  using replacement::replacement;
+
+  long find_victim(uint32_t, uint64_t, long, const CACHE::BLOCK*, champsim::address, champsim::address, access_type)
+  {
+    ++::configured_victim_calls[intern_];
+    return 0;
+  }
+};
+
+template <long WAY>
+struct fixed_way_policy : champsim::modules::replacement {
+  using replacement::replacement;
+
+  long find_victim(uint32_t, uint64_t, long, const CACHE::BLOCK*, champsim::address, champsim::address, access_type) { return WAY; }
+
+  void update_replacement_state(uint32_t, long, long, champsim::address, champsim::address, champsim::address, access_type, bool)
+  {
+    ++::selected_update_calls[intern_];
+  }
+};
+
+template <uint32_t METADATA>
+struct fixed_metadata_prefetcher : champsim::modules::prefetcher {
+  using prefetcher::prefetcher;
+
+  uint32_t prefetcher_cache_operate(champsim::address, champsim::address, bool, bool, access_type, uint32_t) { return METADATA; }
+};
+
+champsim::modules::registry make_test_registry()
+{
+  champsim::modules::registry reg;
+  reg.add_replacement<::fixed_way_policy<1>>("way_one");
+  reg.add_replacement<::fixed_way_policy<2>>("way_two");
+  reg.add_prefetcher<::fixed_metadata_prefetcher<0x1>>("meta_one");
+  reg.add_prefetcher<::fixed_metadata_prefetcher<0x6>>("meta_six");
+  return reg;
+}
+
+long victim_of(CACHE& cache)
+{
+  return cache.impl_find_victim(0, 0, 0, nullptr, champsim::address{}, champsim::address{}, access_type::LOAD);
+}
+} // namespace
+
+SCENARIO("A replacement policy can be selected by name at runtime")
+{
+  GIVEN("A cache with a statically configured replacement policy")
+  {
+    do_nothing_MRC mock_ll;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                  .name("445a-uut")
+                  .sets(1)
+                  .ways(4)
+                  .upper_levels({})
+                  .lower_level(&mock_ll.queues)
+                  .replacement<::configured_policy>()};
+    const auto reg = make_test_registry();
+
+    WHEN("A registered policy is selected")
+    {
+      reg.select_replacement(uut, {"way_two"});
+      uut.initialize();
+
+      THEN("The selected policy chooses the victim")
+      {
+        REQUIRE(victim_of(uut) == 2);
+        REQUIRE(::configured_victim_calls[&uut] == 0);
+      }
+    }
+
+    WHEN("Two registered policies are selected")
+    {
+      reg.select_replacement(uut, {"way_two", "way_one"});
+      uut.initialize();
+      uut.impl_update_replacement_state(0, 0, 0, champsim::address{}, champsim::address{}, champsim::address{}, access_type::LOAD, true);
+
+      THEN("The last policy chooses the victim, and both are updated")
+      {
+        REQUIRE(victim_of(uut) == 1);
+        REQUIRE(::selected_update_calls[&uut] == 2);
+      }
+    }
+
+    WHEN("The cache is moved after a policy is selected")
+    {
+      reg.select_replacement(uut, {"way_one", "way_two"});
+      CACHE moved{std::move(uut)};
+      moved.impl_update_replacement_state(0, 0, 0, champsim::address{}, champsim::address{}, champsim::address{}, access_type::LOAD, true);
+
+      THEN("The policies are bound to the new cache") { REQUIRE(::selected_update_calls[&moved] == 2); }
+    }
+
+    WHEN("An unknown policy is selected")
+    {
+      THEN("The selection is rejected") { REQUIRE_THROWS_AS(reg.select_replacement(uut, {"no_such_policy"}), std::runtime_error); }
+    }
+
+    WHEN("No policy is named")
+    {
+      THEN("The selection is rejected") { REQUIRE_THROWS_AS(reg.select_replacement(uut, {}), std::invalid_argument); }
+    }
+  }
+}
+
+SCENARIO("Prefetchers can be selected by name at runtime")
+{
+  GIVEN("A cache with the default prefetcher")
+  {
+    do_nothing_MRC mock_ll;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}.name("445b-uut").upper_levels({}).lower_level(&mock_ll.queues)};
+    const auto reg = make_test_registry();
+
+    WHEN("Two registered prefetchers are selected")
+    {
+      reg.select_prefetcher(uut, {"meta_one", "meta_six"});
+      uut.initialize();
+
+      THEN("Their metadata is combined as for statically configured prefetchers")
+      {
+        REQUIRE(uut.impl_prefetcher_cache_operate(champsim::address{}, champsim::address{}, false, false, access_type::LOAD, 0) == (0x1 ^ 0x6));
+      }
+    }
+  }
+}
+
+TEST_CASE("The compiled registry holds the modules built into the binary")
+{
+  const auto& reg = champsim::modules::registry::compiled();
+  auto prefetchers = reg.prefetcher_names();
+  auto replacements = reg.replacement_names();
+  REQUIRE_THAT(prefetchers, Catch::Matchers::VectorContains(std::string{"no"}));
+  REQUIRE_THAT(replacements, Catch::Matchers::VectorContains(std::string{"lru"}));
+}
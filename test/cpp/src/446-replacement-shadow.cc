@@ -0,0 +1,176 @@
+#include <catch.hpp>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+#include "../replacement/lru/lru.h"
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+#include "module_registry.h"
+#include "modules.h"
+#include "stats_printer.h"
+
+namespace
+{
+struct evict_way_zero : champsim::modules::replacement {
+  using replacement::replacement;
+
+  long find_victim(uint32_t, uint64_t, long, const CACHE::BLOCK*, champsim::address, champsim::address, access_type) { return 0; }
+};
+
+champsim::modules::registry make_test_registry()
+{
+  champsim::modules::registry reg;
+  reg.add_replacement<::lru>("lru");
+  reg.add_replacement<::evict_way_zero>("way_zero");
+  return reg;
+}
+
+template <typename Elements>
+void load_each(to_rq_MRP& issuer, Elements& elements, std::initializer_list<uint64_t> addresses)
+{
+  for (auto addr : addresses) {
+    to_rq_MRP::request_type pkt;
+    pkt.address = champsim::address{addr};
+    pkt.cpu = 0;
+    pkt.type = access_type::LOAD;
+    REQUIRE(issuer.issue(pkt));
+
+    for (int i = 0; i < 20; ++i) {
+      for (auto elem : elements) {
+        elem->_operate();
+      }
+    }
+  }
+}
+
+// The replacement shadows of a cache, as printed to JSON with a single core that retired the given number of instructions
+nlohmann::json shadow_json(const CACHE& cache, long long instrs)
+{
+  champsim::phase_stats stats;
+  stats.sim_cache_stats.push_back(cache.sim_stats);
+  stats.sim_cpu_stats.emplace_back();
+  stats.sim_cpu_stats.back().end_instrs = instrs;
+
+  std::stringstream ss;
+  champsim::json_printer{ss}.print(stats);
+  return nlohmann::json::parse(ss.str()).at("sim").at(cache.NAME).at("replacement shadows");
+}
+} // namespace
+
+SCENARIO("Replacement policies can be evaluated on shadow tags")
+{
+  GIVEN("A cache with one set of two ways, shadowed by two policies")
+  {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+                  .name("446a-uut")
+                  .sets(1)
+                  .ways(2)
+                  .upper_levels({&mock_ul.queues})
+                  .lower_level(&mock_ll.queues)
+                  .replacement<::lru>()};
+    make_test_registry().add_replacement_shadows(uut, {"lru", "way_zero"});
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &uut, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("Three blocks are loaded in turn, three times over")
+    {
+      load_each(mock_ul, elements, {0x1000, 0x2000, 0x3000, 0x1000, 0x2000, 0x3000, 0x1000, 0x2000, 0x3000});
+
+      THEN("The shadow of the cache's own policy misses on every access, as the cache does")
+      {
+        REQUIRE(uut.sim_stats.replacement_shadows.at(0).name == "lru");
+        REQUIRE(uut.sim_stats.replacement_shadows.at(0).hits.total() == uut.sim_stats.hits.total());
+        REQUIRE(uut.sim_stats.replacement_shadows.at(0).misses.total() == uut.sim_stats.misses.total());
+        REQUIRE(uut.sim_stats.replacement_shadows.at(0).misses.total() == 9);
+      }
+
+      THEN("A policy that keeps one block in place hits on that block")
+      {
+        REQUIRE(uut.sim_stats.replacement_shadows.at(1).name == "way_zero");
+        REQUIRE(uut.sim_stats.replacement_shadows.at(1).hits.total() == 2);
+        REQUIRE(uut.sim_stats.replacement_shadows.at(1).misses.total() == 7);
+      }
+
+      THEN("The cache itself is not affected")
+      {
+        REQUIRE(uut.sim_stats.hits.total() == 0);
+      }
+
+      AND_WHEN("The statistics are printed as JSON")
+      {
+        auto shadows = shadow_json(uut, 1000);
+
+        THEN("Each policy reports its misses and MPKI")
+        {
+          REQUIRE(shadows.at("sampled sets") == 1);
+          REQUIRE(shadows.at("policies").at("way_zero").at("miss") == 7);
+          REQUIRE(shadows.at("policies").at("way_zero").at("MPKI").get<double>() == Approx(7.0));
+          REQUIRE(shadows.at("policies").at("lru").at("MPKI").get<double>() == Approx(9.0));
+        }
+      }
+    }
+
+    WHEN("A stream that hits under LRU is loaded")
+    {
+      load_each(mock_ul, elements, {0x1000, 0x2000, 0x1000, 0x3000, 0x1000, 0x2000, 0x1000, 0x3000});
+
+      THEN("The shadow of the cache's own policy matches the cache")
+      {
+        REQUIRE(uut.sim_stats.hits.total() == 3);
+        REQUIRE(uut.sim_stats.misses.total() == 5);
+        REQUIRE(uut.sim_stats.replacement_shadows.at(0).name == "lru");
+        REQUIRE(uut.sim_stats.replacement_shadows.at(0).hits.total() == uut.sim_stats.hits.total());
+        REQUIRE(uut.sim_stats.replacement_shadows.at(0).misses.total() == uut.sim_stats.misses.total());
+      }
+    }
+  }
+}
+
+SCENARIO("Replacement shadows only see the sampled sets")
+{
+  GIVEN("A cache with eight sets, of which two are sampled")
+  {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+                  .name("446b-uut")
+                  .sets(8)
+                  .ways(2)
+                  .offset_bits(champsim::data::bits{6})
+                  .upper_levels({&mock_ul.queues})
+                  .lower_level(&mock_ll.queues)
+                  .replacement<::lru>()};
+    uut.set_replacement_shadow_sets(2);
+    make_test_registry().add_replacement_shadows(uut, {"lru"});
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &uut, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("Blocks are loaded into a sampled and an unsampled set")
+    {
+      load_each(mock_ul, elements, {0x0000, 0x0040, 0x0100, 0x0000});
+
+      THEN("Only the accesses to the sampled sets are counted, and the misses are scaled to the whole cache")
+      {
+        REQUIRE(uut.sim_stats.replacement_shadow_sets == 2);
+        REQUIRE(uut.sim_stats.replacement_shadows.at(0).misses.total() == 2);
+        REQUIRE(uut.sim_stats.replacement_shadows.at(0).hits.total() == 1);
+
+        auto shadows = shadow_json(uut, 1000);
+        REQUIRE(shadows.at("policies").at("lru").at("estimated miss").get<double>() == Approx(8.0));
+      }
+    }
+  }
+}
@@ -0,0 +1,175 @@
+#include <catch.hpp>
+#include <filesystem>
+#include <sstream>
+
+#include "../../../prefetcher/berti/berti.h"
+#include "cache.h"
+#include "cache_checkpoint.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+#include "serialization.h"
+
+namespace
+{
+// An L1D with a Berti prefetcher, over a memory that answers after a fixed latency
+struct berti_cache {
+  do_nothing_MRC mock_ll{50};
+  to_rq_MRP mock_ul;
+  CACHE uut;
+  std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+  uint64_t next_id = 1;
+
+  explicit berti_cache(std::string name)
+      : uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                .name(std::move(name))
+                .upper_levels({&mock_ul.queues})
+                .lower_level(&mock_ll.queues)
+                .prefetcher<::berti>()}
+  {
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+  }
+
+  void operate(int cycles)
+  {
+    for (int i = 0; i < cycles; ++i) {
+      for (auto elem : elements) {
+        elem->_operate();
+      }
+    }
+  }
+
+  // Load each block of a strided stream in turn, from one IP
+  void load_stream(uint64_t first_block, int count)
+  {
+    for (int i = 0; i < count; ++i) {
+      decltype(mock_ul)::request_type pkt;
+      pkt.address = champsim::address{(first_block + 2 * static_cast<uint64_t>(i)) << LOG2_BLOCK_SIZE};
+      pkt.v_address = pkt.address;
+      pkt.ip = champsim::address{0xcafecafe};
+      pkt.instr_id = next_id++;
+      pkt.cpu = 0;
+      REQUIRE(mock_ul.issue(pkt));
+      operate(20);
+    }
+  }
+
+  std::string saved_state()
+  {
+    std::stringstream stream;
+    champsim::serialization::output_archive ar{stream};
+    uut.save_state(ar);
+    return stream.str();
+  }
+};
+} // namespace
+
+SCENARIO("Each Berti prefetcher learns on its own")
+{
+  GIVEN("Two caches with Berti prefetchers, one of which has learned a strided stream")
+  {
+    berti_cache trained{"455a-trained"};
+    berti_cache fresh{"455a-fresh"};
+    trained.load_stream(0x10000, 200);
+
+    THEN("The trained prefetcher issues prefetches") { REQUIRE(trained.uut.sim_stats.pf_issued > 0); }
+
+    WHEN("The other cache sees the start of the same stream")
+    {
+      fresh.load_stream(0x10000 + 400, 3);
+
+      THEN("It issues no prefetches") { REQUIRE(fresh.uut.sim_stats.pf_issued == 0); }
+    }
+  }
+}
+
+SCENARIO("The state of a Berti prefetcher can be saved and restored")
+{
+  GIVEN("A cache with a Berti prefetcher that has learned a strided stream")
+  {
+    berti_cache trained{"455b-trained"};
+    trained.load_stream(0x10000, 200);
+    trained.operate(200); // Requests in flight are not saved
+    const auto state = trained.saved_state();
+
+    WHEN("The state is restored into a fresh cache at the same time")
+    {
+      berti_cache restored{"455b-restored"};
+      restored.operate(200 * 20 + 200);
+      std::istringstream stream{state};
+      champsim::serialization::input_archive ar{stream};
+      restored.uut.load_state(ar);
+
+      THEN("It saves the same state") { REQUIRE(restored.saved_state() == state); }
+
+      AND_WHEN("Both caches see the rest of the stream")
+      {
+        const auto trained_before = trained.uut.sim_stats.pf_issued;
+        trained.load_stream(0x10000 + 400, 10);
+        restored.load_stream(0x10000 + 400, 10);
+
+        THEN("They issue the same prefetches")
+        {
+          REQUIRE(restored.uut.sim_stats.pf_issued > 0);
+          REQUIRE(restored.uut.sim_stats.pf_issued == trained.uut.sim_stats.pf_issued - trained_before);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("The state of a Berti prefetcher is kept in a binary cache checkpoint")
+{
+  GIVEN("A cache with a Berti prefetcher that has learned a strided stream, saved to a checkpoint")
+  {
+    berti_cache trained{"455c-uut"};
+    trained.load_stream(0x10000, 200);
+    trained.operate(200);
+    const auto path = std::filesystem::temp_directory_path() / "455-berti-checkpoint.bin";
+    champsim::save_cache_checkpoint({std::ref(trained.uut)}, path);
+
+    WHEN("A fresh cache of the same name loads the checkpoint")
+    {
+      berti_cache restored{"455c-uut"};
+      champsim::load_cache_checkpoint({std::ref(restored.uut)}, path);
+
+      AND_WHEN("Both caches see the rest of the stream")
+      {
+        const auto trained_before = trained.uut.sim_stats.pf_issued;
+        trained.load_stream(0x10000 + 400, 10);
+        restored.load_stream(0x10000 + 400, 10);
+
+        THEN("They issue the same prefetches")
+        {
+          REQUIRE(restored.uut.sim_stats.pf_issued > 0);
+          REQUIRE(restored.uut.sim_stats.pf_issued == trained.uut.sim_stats.pf_issued - trained_before);
+        }
+      }
+    }
+
+    WHEN("A cache of the same name with other modules loads the checkpoint")
+    {
+      do_nothing_MRC mock_ll;
+      CACHE other{champsim::cache_builder{champsim::defaults::default_l1d}
+                       .name("455c-uut")
+                       .sets(static_cast<uint32_t>(trained.uut.NUM_SET))
+                       .upper_levels({})
+                       .lower_level(&mock_ll.queues)};
+      other.initialize();
+      champsim::load_cache_checkpoint({std::ref(other)}, path);
+
+      THEN("The blocks are restored, and the state of the modules is ignored")
+      {
+        REQUIRE(std::size(other.block) == std::size(trained.uut.block));
+        for (std::size_t i = 0; i < std::size(other.block); ++i) {
+          CHECK(other.block.at(i).valid == trained.uut.block.at(i).valid);
+          CHECK(other.block.at(i).address == trained.uut.block.at(i).address);
+        }
+      }
+    }
+    std::filesystem::remove(path);
+  }
+}
@@ -0,0 +1,79 @@
+#include <catch.hpp>
+
+#include "dram_controller.h"
+
+namespace
+{
+// Replay a stream of reads through the controller until every one has returned, and give the number of cycles taken
+long replay_reads(std::size_t count, std::size_t queue_size)
+{
+  champsim::channel upper{queue_size, 0, queue_size, champsim::data::bits{6}, false};
+  MEMORY_CONTROLLER uut{champsim::chrono::picoseconds{312},
+                        champsim::chrono::picoseconds{624},
+                        std::size_t{24},
+                        std::size_t{24},
+                        std::size_t{24},
+                        std::size_t{52},
+                        champsim::chrono::microseconds{64000},
+                        {&upper},
+                        queue_size,
+                        queue_size,
+                        1,
+                        champsim::data::bytes{8},
+                        65536,
+                        1024,
+                        1,
+                        8,
+                        4,
+                        8192};
+  uut.warmup = false;
+  for (auto& chan : uut.channels) {
+    chan.warmup = false;
+  }
+
+  // A linear congruential stream, so the run is the same each time
+  uint64_t state = 1;
+  std::size_t issued = 0;
+  std::size_t returned = 0;
+  long cycles = 0;
+  while (returned < count) {
+    while (issued < count && upper.rq_occupancy() < upper.rq_size()) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      champsim::channel::request_type packet;
+      packet.address = champsim::address{(state >> 16) & 0xffffffc0};
+      packet.v_address = packet.address;
+      upper.add_rq(packet);
+      ++issued;
+    }
+
+    uut._operate();
+    ++cycles;
+
+    returned += std::size(upper.returned);
+    upper.returned.clear();
+  }
+
+  return cycles;
+}
+} // namespace
+
+TEST_CASE("The memory controller returns every read of a stream")
+{
+  constexpr std::size_t count = 512;
+  REQUIRE(replay_reads(count, 64) > 0);
+}
+
+TEST_CASE("Memory controller benchmarks")
+{
+  constexpr std::size_t count = 4096;
+
+  BENCHMARK_ADVANCED("Replaying 4096 reads through a 64-entry read queue")(Catch::Benchmark::Chronometer meter)
+  {
+    meter.measure([] { return replay_reads(count, 64); });
+  };
+
+  BENCHMARK_ADVANCED("Replaying 4096 reads through a 256-entry read queue")(Catch::Benchmark::Chronometer meter)
+  {
+    meter.measure([] { return replay_reads(count, 256); });
+  };
+}
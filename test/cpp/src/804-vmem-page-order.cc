@@ -0,0 +1,144 @@
+#include <catch.hpp>
+#include <set>
+#include <sstream>
+
+#include "dram_controller.h"
+#include "serialization.h"
+#include "vmem.h"
+
+namespace
+{
+MEMORY_CONTROLLER make_dram(std::size_t rows = 1024)
+{
+  return MEMORY_CONTROLLER{champsim::chrono::picoseconds{3200},
+                           champsim::chrono::picoseconds{6400},
+                           std::size_t{18},
+                           std::size_t{18},
+                           std::size_t{18},
+                           std::size_t{38},
+                           champsim::chrono::microseconds{64000},
+                           {},
+                           64,
+                           64,
+                           1,
+                           champsim::data::bytes{8},
+                           rows,
+                           1024,
+                           4,
+                           4,
+                           4,
+                           8192};
+}
+
+std::vector<champsim::page_number> translate_pages(VirtualMemory& uut, std::size_t count, std::size_t first_vpage = 0x1000)
+{
+  std::vector<champsim::page_number> retval{};
+  for (std::size_t i = 0; i < count; ++i) {
+    retval.push_back(uut.va_to_pa(0, champsim::page_number{first_vpage + i}).first);
+  }
+  return retval;
+}
+
+std::string saved_state(const VirtualMemory& uut)
+{
+  std::stringstream stream;
+  champsim::serialization::output_archive ar{stream};
+  uut.save_state(ar);
+  return stream.str();
+}
+} // namespace
+
+SCENARIO("A seeded virtual memory hands out physical pages in a reproducible order")
+{
+  GIVEN("Two virtual memories with the same seed")
+  {
+    auto dram = make_dram();
+    VirtualMemory uut_a{champsim::data::bytes{1 << 12}, 5, std::chrono::nanoseconds{6400}, dram, 0x804};
+    VirtualMemory uut_b{champsim::data::bytes{1 << 12}, 5, std::chrono::nanoseconds{6400}, dram, 0x804};
+    VirtualMemory unseeded{champsim::data::bytes{1 << 12}, 5, std::chrono::nanoseconds{6400}, dram};
+
+    WHEN("Each translates the same pages")
+    {
+      constexpr std::size_t count = 1000;
+      auto pages_a = translate_pages(uut_a, count);
+      auto pages_b = translate_pages(uut_b, count);
+      auto unseeded_pages = translate_pages(unseeded, count);
+
+      THEN("The pages are the same") { REQUIRE(pages_a == pages_b); }
+
+      THEN("The pages are all different")
+      {
+        std::set<champsim::page_number> unique_pages{std::begin(pages_a), std::end(pages_a)};
+        REQUIRE(std::size(unique_pages) == count);
+      }
+
+      THEN("The pages are not in order") { REQUIRE(pages_a != unseeded_pages); }
+
+      THEN("The unseeded pages are in order")
+      {
+        REQUIRE(std::adjacent_find(std::begin(unseeded_pages), std::end(unseeded_pages), [](auto x, auto y) { return y != x + 1; })
+                == std::end(unseeded_pages));
+      }
+    }
+  }
+}
+
+SCENARIO("A seeded virtual memory hands out every physical page once before it is refilled")
+{
+  GIVEN("A seeded virtual memory over a small physical memory")
+  {
+    auto dram = make_dram(64);
+    VirtualMemory uut{champsim::data::bytes{1 << 12}, 5, std::chrono::nanoseconds{6400}, dram, 0x804};
+    const auto count = uut.available_ppages();
+
+    WHEN("A page is translated for every physical page")
+    {
+      auto pages = translate_pages(uut, count);
+
+      THEN("The pages are all different")
+      {
+        std::set<champsim::page_number> unique_pages{std::begin(pages), std::end(pages)};
+        REQUIRE(std::size(unique_pages) == count);
+        REQUIRE(champsim::uoffset(*std::begin(unique_pages), *std::prev(std::end(unique_pages))) == count - 1);
+      }
+
+      THEN("The memory is refilled") { REQUIRE(uut.available_ppages() == count); }
+
+      AND_WHEN("More pages are translated")
+      {
+        auto refilled_pages = translate_pages(uut, 100, 0x1000 + count);
+
+        THEN("They are handed out in the same order as the first pages")
+        {
+          REQUIRE(refilled_pages == std::vector<champsim::page_number>{std::begin(pages), std::next(std::begin(pages), 100)});
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A restored virtual memory hands out the same pages as the one that was saved")
+{
+  GIVEN("A seeded virtual memory over a small physical memory")
+  {
+    auto dram = make_dram(64);
+    VirtualMemory uut{champsim::data::bytes{1 << 12}, 5, std::chrono::nanoseconds{6400}, dram, 0x804};
+    const auto count = uut.available_ppages();
+    auto translated = GENERATE_COPY(as<std::size_t>{}, 1, 1000, count - 1, count + 10);
+
+    WHEN("Some pages are translated, and the state is saved and restored into another virtual memory")
+    {
+      static_cast<void>(translate_pages(uut, translated));
+      VirtualMemory restored{champsim::data::bytes{1 << 12}, 5, std::chrono::nanoseconds{6400}, dram, 0x804};
+      std::istringstream stream{saved_state(uut)};
+      champsim::serialization::input_archive ar{stream};
+      restored.load_state(ar);
+
+      THEN("Both hand out the same pages next")
+      {
+        REQUIRE(restored.available_ppages() == uut.available_ppages());
+        REQUIRE(translate_pages(restored, 1000, 0x1000 + translated) == translate_pages(uut, 1000, 0x1000 + translated));
+      }
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#include <catch.hpp>
+
+#include "dram_controller.h"
+#include "vmem.h"
+
+TEST_CASE("Virtual memory translation benchmarks")
+{
+  constexpr std::size_t count = 1 << 14;
+
+  MEMORY_CONTROLLER dram{champsim::chrono::picoseconds{3200},
+                         champsim::chrono::picoseconds{6400},
+                         std::size_t{18},
+                         std::size_t{18},
+                         std::size_t{18},
+                         std::size_t{38},
+                         champsim::chrono::microseconds{64000},
+                         {},
+                         64,
+                         64,
+                         1,
+                         champsim::data::bytes{8},
+                         65536,
+                         1024,
+                         4,
+                         4,
+                         4,
+                         8192};
+
+  // Pages scattered over the virtual address space, as a large heap would be
+  std::vector<champsim::page_number> vpages{};
+  uint64_t state = 1;
+  for (std::size_t i = 0; i < count; ++i) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    vpages.push_back(champsim::page_number{state >> 28});
+  }
+
+  BENCHMARK_ADVANCED("Translating 16384 new pages")(Catch::Benchmark::Chronometer meter)
+  {
+    VirtualMemory uut{champsim::data::bytes{1 << 12}, 5, std::chrono::nanoseconds{6400}, dram, 0x805};
+
+    // Each run translates in its own address space, so that every page is new
+    meter.measure([&](int run) {
+      for (auto vpage : vpages) {
+        uut.va_to_pa(static_cast<uint32_t>(run), vpage);
+        for (std::size_t level = 1; level <= 5; ++level) {
+          uut.get_pte_pa(static_cast<uint32_t>(run), vpage, level);
+        }
+      }
+    });
+  };
+
+  BENCHMARK_ADVANCED("Translating 16384 mapped pages")(Catch::Benchmark::Chronometer meter)
+  {
+    VirtualMemory uut{champsim::data::bytes{1 << 12}, 5, std::chrono::nanoseconds{6400}, dram, 0x805};
+    for (auto vpage : vpages) {
+      uut.va_to_pa(0, vpage);
+      for (std::size_t level = 1; level <= 5; ++level) {
+        uut.get_pte_pa(0, vpage, level);
+      }
+    }
+    meter.measure([&] {
+      for (auto vpage : vpages) {
+        uut.va_to_pa(0, vpage);
+        for (std::size_t level = 1; level <= 5; ++level) {
+          uut.get_pte_pa(0, vpage, level);
+        }
+      }
+    });
+  };
+}
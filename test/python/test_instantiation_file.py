@@ -304,3 +304,20 @@ class GetQueueInfoTests(unittest.TestCase):
             { 'is_good_boy': False }
         ]
         self.assertEqual(expected, evaluated)
+
+class ModuleRegistryLinesTests(unittest.TestCase):
+    def test_prefetchers_and_replacements_are_registered_by_directory_name(self):
+        given_pref = { 'prefetcherDdog': { 'name': 'prefetcherDdog', 'path': '/path/to/prefetcher/dog', 'class': 'dog' } }
+        given_repl = { 'replacementDcat': { 'name': 'replacementDcat', 'path': '/path/to/replacement/cat/', 'class': 'cat' } }
+        evaluated = list(config.instantiation_file.get_module_registry_lines(given_pref, given_repl))
+        expected = [
+            'reg.add_prefetcher<class dog>("dog");',
+            'reg.add_replacement<class cat>("cat");'
+        ]
+        self.assertEqual(expected, evaluated)
+
+    def test_legacy_modules_use_the_generated_class(self):
+        given_pref = { 'prefetcherDdog': { 'name': 'prefetcherDdog', 'path': '/path/to/prefetcher/dog', 'class': 'champsim::modules::generated::prefetcherDdog', 'legacy': True } }
+        evaluated = list(config.instantiation_file.get_module_registry_lines(given_pref, {}))
+        expected = [ 'reg.add_prefetcher<class champsim::modules::generated::prefetcherDdog>("dog");' ]
+        self.assertEqual(expected, evaluated)